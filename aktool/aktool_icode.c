@@ -9,12 +9,98 @@
  #include <stdlib.h>
  #include <string.h>
  #include <aktool.h>
+#ifdef AK_HAVE_PTHREAD_H
+ #include <pthread.h>
+#endif
+#ifdef AK_HAVE_SYSSTAT_H
+ #include <sys/stat.h>
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/* количество заданий в очереди, приходящихся на один поток */
+ #define aktool_icode_jobs_per_thread (4)
+/* длина синхропосылки, используемой для выработки ключа имитовставки отдельного файла */
+ #define aktool_icode_iv_size (16)
+/* длина ключа имитовставки отдельного файла */
+ #define aktool_icode_key_size (32)
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Состояние задания на вычисление кода целостности одного файла. */
+ typedef enum { job_free, job_pending, job_running, job_done } icode_job_state_t;
+
+/*! \brief Задание на вычисление (проверку) кода целостности одного файла. */
+ typedef struct icode_job {
+  /*! \brief Имя файла */
+   char filename[FILENAME_MAX];
+  /*! \brief Вычисленный код целостности */
+   ak_uint8 out[64];
+  /*! \brief Длина кода целостности */
+   size_t tagsize;
+  /*! \brief Синхропосылка, используемая для выработки ключа имитовставки */
+   ak_uint8 iv[aktool_icode_iv_size];
+  /*! \brief Ключ имитовставки, выработанный из ключа пользователя и синхропосылки */
+   ak_uint8 key[aktool_icode_key_size];
+  /*! \brief Ожидаемое значение кода целостности (при проверке) */
+   ak_uint8 icode[64];
+  /*! \brief Длина ожидаемого значения кода целостности */
+   size_t icode_size;
+  /*! \brief Код ошибки вычислений */
+   int error;
+  /*! \brief Состояние задания */
+   icode_job_state_t state;
+  /*! \brief Размер файла на момент постановки задания */
+   ak_int64 size;
+  /*! \brief Время последней модификации файла */
+   ak_int64 mtime;
+  /*! \brief Номер индексного дескриптора файла */
+   ak_uint64 inode;
+  /*! \brief Индекс записи кэша, соответствующей файлу (или -1) */
+   ssize_t entry;
+  /*! \brief Флаг того, что код целостности взят из кэша */
+   bool_t cached;
+ } *ak_icode_job;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Запись кэша ранее вычисленных кодов целостности. */
+ typedef struct icode_cache_entry {
+  /*! \brief Полное имя файла */
+   char *filename;
+  /*! \brief Размер файла */
+   ak_int64 size;
+  /*! \brief Время последней модификации файла */
+   ak_int64 mtime;
+  /*! \brief Номер индексного дескриптора файла */
+   ak_uint64 inode;
+  /*! \brief Код целостности */
+   ak_uint8 icode[64];
+  /*! \brief Длина кода целостности */
+   size_t icode_size;
+  /*! \brief Синхропосылка, использованная для выработки ключа имитовставки */
+   ak_uint8 iv[aktool_icode_iv_size];
+ } *ak_icode_cache_entry;
 
 /* ----------------------------------------------------------------------------------------------- */
  int aktool_icode_help( void );
  int aktool_icode_function( const char * , ak_pointer );
- int aktool_icode_check_function( char * , ak_pointer );
+ int aktool_icode_check_function( const char * , ak_pointer );
  int aktool_create_handle( void );
+ void aktool_destroy_handle( void );
+ int aktool_icode_derive_ikey( void );
+ int aktool_icode_derive_key( ak_icode_job );
+ int aktool_icode_evaluate( ak_pointer , ak_icode_job );
+ void aktool_icode_report( ak_icode_job );
+ int aktool_icode_dispatch( ak_icode_job );
+ void aktool_icode_full_name( const char * , char * );
+ int aktool_icode_cache_load( void );
+ int aktool_icode_cache_save( void );
+ void aktool_icode_cache_destroy( void );
+ void aktool_icode_cache_lookup( ak_icode_job , char * );
+ void aktool_icode_cache_store( ak_icode_job );
+#ifdef AK_HAVE_PTHREAD_H
+ int aktool_icode_threads_start( void );
+ int aktool_icode_threads_enqueue( ak_icode_job );
+ void aktool_icode_threads_stop( void );
+#endif
 
 /* ----------------------------------------------------------------------------------------------- */
 #if defined(_WIN32) || defined(_WIN64)
@@ -40,11 +126,101 @@
 
   /*! \brief Имя файла для вывода результатов */
     char outfile[FILENAME_MAX];
+  /*! \brief Количество потоков, вычисляющих коды целостности */
+    size_t threads;
+  /*! \brief Флаг вывода результатов в порядке завершения вычислений */
+    bool_t unordered;
+
+  /*! \brief Имя файла с ключом пользователя */
+    char *keyfile;
+  /*! \brief Ключ пользователя, из которого вырабатывается промежуточный ключ */
+    ak_pointer key;
+  /*! \brief Промежуточный ключ, из которого вырабатываются ключи имитовставки файлов */
+    ak_uint8 ikey[aktool_icode_key_size];
+  /*! \brief Идентификатор генератора синхропосылок */
+    ak_oid generator_oid;
+  /*! \brief Генератор синхропосылок */
+    ak_random generator;
+  /*! \brief Флаг проверки ранее вычисленных кодов целостности */
+    bool_t check;
+  /*! \brief Количество проверенных файлов */
+    size_t checked;
+  /*! \brief Количество файлов, не прошедших проверку */
+    size_t failed;
  } ic;
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Кэш ранее вычисленных кодов целостности.
+    \details Кэш хранится в текстовом файле, первая строка которого содержит заголовок
+    с именем алгоритма и номером ключа пользователя; кэш, созданный для другого алгоритма
+    или ключа, не используется. Каждая следующая строка имеет вид
+    `размер время_модификации индексный_дескриптор код синхропосылка полное_имя_файла`.
+
+    Записи, загруженные из файла, упорядочены по именам файлов, новые записи добавляются
+    в конец массива и при поиске не используются. Код целостности берется из кэша, если размер,
+    время модификации и индексный дескриптор файла совпадают с сохраненными значениями. */
+ static struct {
+  /*! \brief Имя файла кэша */
+    char *filename;
+  /*! \brief Полное имя файла кэша */
+    char fullname[FILENAME_MAX];
+  /*! \brief Заголовок файла кэша */
+    char header[160];
+  /*! \brief Массив записей */
+    ak_icode_cache_entry entries;
+  /*! \brief Количество упорядоченных записей, загруженных из файла */
+    size_t count;
+  /*! \brief Общее количество записей */
+    size_t total;
+  /*! \brief Количество записей, под которые выделена память */
+    size_t allocated;
+  /*! \brief Флаг того, что заголовок файла совпадает с ожидаемым */
+    bool_t valid;
+  /*! \brief Флаг изменения кэша */
+    bool_t changed;
+  /*! \brief Флаг использования кэша при проверке кодов целостности */
+    bool_t trust;
+  /*! \brief Время запуска программы */
+    time_t start;
+ } icc;
+
+#ifdef AK_HAVE_PTHREAD_H
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Ограниченная очередь заданий между функцией обхода каталогов и потоками вычислений.
+    \details Задания размещаются в кольцевом буфере и выбираются потоками в порядке поступления.
+    При упорядоченном выводе результаты печатает поток, выполняющий обход каталогов,
+    в порядке поступления заданий; в противном случае результат печатается потоком,
+    завершившим вычисления. */
+ static struct {
+  /*! \brief Кольцевой буфер заданий */
+   ak_icode_job jobs;
+  /*! \brief Количество заданий в буфере */
+   size_t size;
+  /*! \brief Общее количество заданий, поставленных в очередь */
+   size_t added;
+  /*! \brief Количество заданий, выбранных потоками для выполнения */
+   size_t taken;
+  /*! \brief Количество заданий, результаты которых выведены */
+   size_t printed;
+  /*! \brief Флаг завершения работы потоков */
+   bool_t stop;
+  /*! \brief Мьютекс, защищающий очередь и вывод результатов */
+   pthread_mutex_t mutex;
+  /*! \brief Сигнал о появлении нового задания */
+   pthread_cond_t job_ready;
+  /*! \brief Сигнал о завершении выполнения задания */
+   pthread_cond_t job_done;
+  /*! \brief Идентификаторы потоков */
+   pthread_t *tid;
+  /*! \brief Количество запущенных потоков */
+   size_t count;
+ } icq;
+#endif
+
 /* ----------------------------------------------------------------------------------------------- */
  int aktool_icode( int argc, tchar *argv[] )
 {
+  char *checkfile = NULL;
   int next_option = 0, exit_status = EXIT_FAILURE;
   enum { do_nothing, do_hash, do_check } work = do_hash;
 
@@ -54,8 +230,14 @@
      { "template",            1, NULL,  't' },
      { "output",              1, NULL,  'o' },
      { "recursive",           0, NULL,  'r' },
+     { "key",                 1, NULL,  'k' },
+     { "check",               1, NULL,  'c' },
      { "reverse-order",       0, NULL,  254 },
      { "tag",                 0, NULL,  250 },
+     { "threads",             1, NULL,  249 },
+     { "unordered",           0, NULL,  248 },
+     { "cache",               1, NULL,  247 },
+     { "trust-cache",         0, NULL,  246 },
 
    /* это стандартые для всех программ опции */
      aktool_common_functions_definition,
@@ -76,10 +258,19 @@
   ic.reverse_order = ak_false;
   ic.tag = ak_false;
   ic.outfp = stdout;
+  ic.threads = 1;
+  ic.unordered = ak_false;
+  ic.keyfile = NULL;
+  ic.key = NULL;
+  ic.generator_oid = ak_oid_find_by_name( aktool_default_generator );
+  ic.generator = NULL;
+  ic.check = ak_false;
+  memset( &icc, 0, sizeof( icc ));
+  icc.start = time( NULL );
 
  /* разбираем опции командной строки */
   do {
-       next_option = getopt_long( argc, argv, "a:t:ro:", long_options, NULL );
+       next_option = getopt_long( argc, argv, "a:t:ro:k:c:", long_options, NULL );
        switch( next_option )
       {
         aktool_common_functions_run( aktool_icode_help );
@@ -122,6 +313,15 @@
                    ic.tree = ak_true;
                    break;
 
+        case 'k' : /* устанавливаем имя файла с ключом пользователя */
+                   ic.keyfile = optarg;
+                   break;
+
+        case 'c' : /* проверяем ранее вычисленные коды целостности */
+                   checkfile = optarg;
+                   work = do_check;
+                   break;
+
         case 254 : /* установить обратный порядок вывода байт */
                    ic.reverse_order = ak_true;
                    break;
@@ -130,6 +330,33 @@
                    ic.tag = ak_true;
                    break;
 
+        case 249 : /* количество потоков вычислений */
+                   if(( next_option = atoi( optarg )) > 1 ) ic.threads = ( size_t ) next_option;
+                    else ic.threads = 1;
+                 #ifndef AK_HAVE_PTHREAD_H
+                   if( ic.threads > 1 ) {
+                     aktool_error(_("multithreading is not supported, only one thread will be used"));
+                     ic.threads = 1;
+                   }
+                 #endif
+                   break;
+
+        case 248 : /* вывод результатов в порядке завершения вычислений */
+                   ic.unordered = ak_true;
+                   break;
+
+        case 247 : /* файл кэша вычисленных кодов целостности */
+                 #ifdef AK_HAVE_SYSSTAT_H
+                   icc.filename = optarg;
+                 #else
+                   aktool_error(_("the cache of integrity codes is not supported"));
+                 #endif
+                   break;
+
+        case 246 : /* использование кэша при проверке кодов целостности */
+                   icc.trust = ak_true;
+                   break;
+
         default:  /* обрабатываем ошибочные параметры */
                    if( next_option != -1 ) work = do_nothing;
                    break;
@@ -147,6 +374,13 @@
        ++optind; /* пропускаем команду - i или icode */
        if( optind < argc ) {
          if(( exit_status = aktool_create_handle()) != EXIT_SUCCESS ) break;
+         if(( exit_status = aktool_icode_cache_load()) != EXIT_SUCCESS ) break;
+        #ifdef AK_HAVE_PTHREAD_H
+         if(( ic.threads > 1 ) && ( aktool_icode_threads_start() != EXIT_SUCCESS )) {
+           aktool_error(_("incorrect creation of threads, only one thread will be used"));
+           ic.threads = 1;
+         }
+        #endif
          while( optind < argc ) {
             char *value = argv[optind++];
             switch( ak_file_or_directory( value )) {
@@ -158,16 +392,39 @@
                 break;
             }
          }
+        #ifdef AK_HAVE_PTHREAD_H
+         if( ic.threads > 1 ) aktool_icode_threads_stop();
+        #endif
+         exit_status = aktool_icode_cache_save();
        } else {
           exit_status = EXIT_FAILURE;
           aktool_error(_("file or directory are not specified as the last argument of the program"));
          }
-       if( ic.algorithm != NULL ) ak_oid_delete_object( ic.algorithm, ic.handle );
-       exit_status = EXIT_SUCCESS;
        break;
 
      case do_check:
-       exit_status = EXIT_FAILURE;
+       ic.check = ak_true;
+       if(( exit_status = aktool_create_handle()) != EXIT_SUCCESS ) break;
+       if(( exit_status = aktool_icode_cache_load()) != EXIT_SUCCESS ) break;
+      #ifdef AK_HAVE_PTHREAD_H
+       if(( ic.threads > 1 ) && ( aktool_icode_threads_start() != EXIT_SUCCESS )) {
+         aktool_error(_("incorrect creation of threads, only one thread will be used"));
+         ic.threads = 1;
+       }
+      #endif
+       if( ak_file_read_by_lines( checkfile, aktool_icode_check_function, NULL ) != ak_error_ok )
+         aktool_error(_("incorrect reading of checksum file \"%s\""), checkfile );
+      #ifdef AK_HAVE_PTHREAD_H
+       if( ic.threads > 1 ) aktool_icode_threads_stop();
+      #endif
+       aktool_icode_cache_save();
+       if( ic.failed || !ic.checked ) {
+         if( ic.failed ) aktool_error(_("%u of %u integrity codes did not match"),
+                                          (unsigned int) ic.failed, (unsigned int) ic.checked );
+           else aktool_error(_("checksum file \"%s\" contains no integrity codes"), checkfile );
+         exit_status = EXIT_FAILURE;
+       }
+        else exit_status = EXIT_SUCCESS;
        break;
 
      default:
@@ -175,74 +432,211 @@
    }
 
  /* завершаем работу и выходим */
+   aktool_icode_cache_destroy();
+   aktool_destroy_handle();
    if( ic.outfp != stdout ) fclose( ic.outfp );
    aktool_destroy_libakrypt();
  return exit_status;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Создание контекста алгоритма и, при необходимости, загрузка ключа пользователя.
+    \details Если задан ключ пользователя, а выбранный алгоритм является бесключевым,
+    то алгоритм выработки имитовставки определяется типом ключа: для ключа HMAC используется
+    тот же алгоритм HMAC, для ключа блочного шифра - алгоритм выработки имитовставки
+    ГОСТ Р 34.13-2015 (cmac). Ключ пользователя загружается один раз и применяется только
+    для выработки промежуточного ключа, см. aktool_icode_derive_ikey(). */
 /* ----------------------------------------------------------------------------------------------- */
  int aktool_create_handle( void )
 {
+  ak_oid keyoid = NULL;
+  char name[64];
+
   if( ic.algorithm == NULL ) {
     aktool_error(
           _("use -a (--algorithm) option and set the cryptographic algorithm name or identifier"));
     return EXIT_FAILURE;
   }
 
+ /* загружаем ключ пользователя */
+  if( ic.keyfile != NULL ) {
+    if(( ic.key = ak_skey_load_from_file( ic.keyfile )) == NULL ) {
+      aktool_error(_("incorrect loading a secret key from file %s"), ic.keyfile );
+      return EXIT_FAILURE;
+    }
+    keyoid = ((ak_skey)ic.key)->oid;
+    if(( keyoid->engine != hmac_function ) && ( keyoid->engine != block_cipher )) {
+      aktool_error(_("the key from file %s is not suitable for integrity codes"), ic.keyfile );
+      return EXIT_FAILURE;
+    }
+   /* алгоритм выработки имитовставки определяется типом ключа */
+    if( ic.algorithm->func.first.set_key == NULL ) {
+      if( keyoid->engine == hmac_function ) ic.algorithm = keyoid;
+       else {
+         ak_snprintf( name, sizeof( name ), "cmac-%s", keyoid->name[0] );
+         if(( ic.algorithm = ak_oid_find_by_name( name )) == NULL ) {
+           aktool_error(_("unsupported algorithm %s"), name );
+           return EXIT_FAILURE;
+         }
+       }
+    }
+  }
+
+ /* проверяем, что ключевой алгоритм поддерживается */
+  if( ic.algorithm->func.first.set_key != NULL ) {
+    if(( ic.algorithm->engine != hmac_function ) &&
+                      (( ic.algorithm->engine != block_cipher ) || ( ic.algorithm->mode != mac ))) {
+      aktool_error(_("the algorithm %s is not supported for integrity codes"),
+                                                                        ic.algorithm->name[0] );
+      return EXIT_FAILURE;
+    }
+    if( ic.key == NULL ) {
+      aktool_error(_("use -k (--key) option and set the file with secret key"));
+      return EXIT_FAILURE;
+    }
+    if( aktool_icode_derive_ikey() != ak_error_ok ) {
+      aktool_error(_("incorrect derivation of intermediate key from the key %s"), ic.keyfile );
+      return EXIT_FAILURE;
+    }
+    if(( ic.generator = ak_oid_new_object( ic.generator_oid )) == NULL ) {
+      aktool_error(_("incorrect creation of random generator"));
+      return EXIT_FAILURE;
+    }
+  }
+
   if(( ic.handle = ak_oid_new_object( ic.algorithm )) == NULL ) {
     aktool_error(_("incorrect creation a handle of crypto algorithm"));
     return EXIT_FAILURE;
   }
+  if( aktool_verbose ) printf(_("used algorithm: %s\n"), ic.algorithm->name[0] );
 
- /* проверяем, надо ли устанавливать ключ
-     если --key, то берем из заданного файла (в форме контейнера библиотеки)
-
-     если --hexkey, то из командной строки берется ключ
+ return EXIT_SUCCESS;
+}
 
-     если -p, то используется пароль
-     если --password, --hexpass (то пароль берется из командной строки)
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Удаление контекста алгоритма, ключа пользователя и генератора синхропосылок. */
+/* ----------------------------------------------------------------------------------------------- */
+ void aktool_destroy_handle( void )
+{
+  if( ic.handle != NULL ) ak_oid_delete_object( ic.algorithm, ic.handle );
+  if( ic.generator != NULL ) ak_oid_delete_object( ic.generator_oid, ic.generator );
+  if( ic.key != NULL ) ak_oid_delete_object( ((ak_skey)ic.key)->oid, ic.key );
+  memset( ic.ikey, 0, sizeof( ic.ikey ));
+  ic.handle = ic.key = NULL;
+  ic.generator = NULL;
+}
 
-     если hex-input, то ввод пароля проиводится в шестнадцатеричном виде
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Выработка промежуточного ключа из ключа пользователя.
+    \details Ключ вырабатывается один раз при создании контекста алгоритма в режиме счетчика:
+    K = MAC( 0x01 || "icode" || 0x00 || 0x0100 ) || MAC( 0x02 || ... ) || ...,
+    где MAC - алгоритм HMAC или cmac, определяемый типом ключа пользователя. Тем самым,
+    ресурс ключа пользователя расходуется один раз за запуск программы и не зависит
+    от количества обрабатываемых файлов. */
+/* ----------------------------------------------------------------------------------------------- */
+ int aktool_icode_derive_ikey( void )
+{
+  int error = ak_error_ok;
+  ak_uint8 label[16], out[64];
+  size_t len = 0, offset = 0, tagsize = 0;
 
- */
-  if( ic.algorithm->func.first.set_key != NULL ) {
+ /* формируем входные данные */
+  memset( label, 0, sizeof( label ));
+  memcpy( label+1, "icode", 5 );
+  label[7] = 0x01; /* длина ключа в битах (256) */
+  len = 9;
 
+  while( offset < aktool_icode_key_size ) {
+     label[0]++;
+     if( ((ak_skey)ic.key)->oid->engine == hmac_function ) {
+       tagsize = ak_hmac_get_tag_size( ic.key );
+       error = ak_hmac_ptr( ic.key, label, len, out, sizeof( out ));
+     } else {
+         tagsize = ((ak_bckey)ic.key)->bsize;
+         error = ak_bckey_cmac( ic.key, label, len, out, tagsize );
+       }
+     if( error != ak_error_ok ) break;
+     memcpy( ic.ikey+offset, out, ak_min( tagsize, aktool_icode_key_size - offset ));
+     offset += tagsize;
+  }
+  memset( out, 0, sizeof( out ));
 
+ return error;
+}
 
-  }
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Выработка ключа имитовставки отдельного файла.
+    \details Ключ вырабатывается из промежуточного ключа и синхропосылки задания
+    с помощью алгоритма KDF_GOSTR3411_2012_256 (Р 50.1.113-2016):
+    K = KDF256( ikey, "icode", iv ). Ключ пользователя при этом не используется.
 
- return EXIT_SUCCESS;
+    Функция вызывается только из основного потока. */
+/* ----------------------------------------------------------------------------------------------- */
+ int aktool_icode_derive_key( ak_icode_job job )
+{
+ return ak_hmac_kdf_tree_streebog256( ic.ikey, sizeof( ic.ikey ), "icode", 5,
+                              job->iv, aktool_icode_iv_size, 1, job->key, aktool_icode_key_size );
 }
 
 /* ----------------------------------------------------------------------------------------------- */
- int aktool_icode_function( const char *filename, ak_pointer ptr )
+/*! \brief Вычисление кода целостности заданного файла с помощью заданного контекста алгоритма. */
+/* ----------------------------------------------------------------------------------------------- */
+ int aktool_icode_evaluate( ak_pointer handle, ak_icode_job job )
 {
-  ak_uint8 out[64];
-  size_t tagsize = 0;
   int error = ak_error_ok;
-  char flongname[FILENAME_MAX];
 
- /* файл для вывода результатов не хешируем */
-  if( ic.outfp != stdout ) {
-    memset( flongname, 0, sizeof( flongname ));
-   #ifdef _WIN32
-    GetFullPathName( filename, FILENAME_MAX, flongname, NULL );
-   #else
-    realpath( filename, flongname );
-   #endif
-    if( !strncmp( flongname, ic.outfile, FILENAME_MAX -2 )) return ak_error_ok;
-    if( !strncmp( flongname, audit_filename, sizeof( audit_filename ) -2 )) return ak_error_ok;
-  }
+ /* код целостности уже взят из кэша */
+  if( job->cached ) return ak_error_ok;
 
  /* хешируем данные */
   if( ic.algorithm->func.first.set_key == NULL ) {
-    ak_hash_file( ic.handle, filename, out, sizeof( out ));
-    tagsize = ak_hash_get_tag_size( ic.handle );
+    error = ak_hash_file( handle, job->filename, job->out, sizeof( job->out ));
+    job->tagsize = ak_hash_get_tag_size( handle );
   }
    else { /* вычисляем имитовставку */
+     error = ic.algorithm->func.first.set_key( handle, job->key, sizeof( job->key ));
+     memset( job->key, 0, sizeof( job->key ));
+     if( error != ak_error_ok ) return error;
 
+     if( ic.algorithm->engine == hmac_function ) {
+       error = ak_hmac_file( handle, job->filename, job->out, sizeof( job->out ));
+       job->tagsize = ak_hmac_get_tag_size( handle );
+     } else {
+         job->tagsize = ((ak_bckey)handle)->bsize;
+         error = ak_bckey_cmac_file( handle, job->filename, job->out, job->tagsize );
+       }
    }
 
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Вывод кода целостности файла или результата его проверки. */
+/* ----------------------------------------------------------------------------------------------- */
+ void aktool_icode_report( ak_icode_job job )
+{
+  bool_t keyed = ( ic.algorithm->func.first.set_key != NULL );
+
+  if( job->error != ak_error_ok ) {
+    aktool_error(_("incorrect evaluation of integrity code for file %s"), job->filename );
+    if( ic.check ) { ic.checked++; ic.failed++; }
+    return;
+  }
+  aktool_icode_cache_store( job );
+
+ /* выводим результат проверки */
+  if( ic.check ) {
+    ic.checked++;
+    if(( job->icode_size == job->tagsize ) &&
+                                    ak_ptr_is_equal( job->icode, job->out, job->tagsize ))
+      fprintf( ic.outfp, "%s: Ok\n", job->filename );
+     else {
+       ic.failed++;
+       fprintf( ic.outfp, "%s: Wrong\n", job->filename );
+     }
+    return;
+  }
+
  /* вывод результатов в следующих форматах
     linux:
       контрольная_сумма имя_файла
@@ -252,17 +646,550 @@
       алгоритм (имя_файла) = контрольная_сумма
       алгоритм (имя_файла) = контрольная_сумма (синхропосылка) */
 
- /* теперь вывод результата */
   if( ic.tag ) { /* вывод bsd */
-    fprintf( ic.outfp, "%s (%s) = %s\n", ic.algorithm->name[0], filename,
-                                               ak_ptr_to_hexstr( out, tagsize, ic.reverse_order ));
+    fprintf( ic.outfp, "%s (%s) = %s", ic.algorithm->name[0], job->filename,
+                                     ak_ptr_to_hexstr( job->out, job->tagsize, ic.reverse_order ));
+    if( keyed ) fprintf( ic.outfp, " (%s)",
+                                   ak_ptr_to_hexstr( job->iv, aktool_icode_iv_size, ak_false ));
   } else { /* вывод линуксовый */
-      fprintf( ic.outfp, "%s %s\n", ak_ptr_to_hexstr( out, tagsize, ic.reverse_order ), filename );
+      fprintf( ic.outfp, "%s %s",
+                ak_ptr_to_hexstr( job->out, job->tagsize, ic.reverse_order ), job->filename );
+      if( keyed ) fprintf( ic.outfp, " %s",
+                                   ak_ptr_to_hexstr( job->iv, aktool_icode_iv_size, ak_false ));
     }
+  fprintf( ic.outfp, "\n" );
+}
 
- return error;
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Выработка ключа имитовставки и передача задания на выполнение.
+    \details В многопоточном режиме задание помещается в очередь, в противном случае
+    вычисления выполняются немедленно. */
+/* ----------------------------------------------------------------------------------------------- */
+ int aktool_icode_dispatch( ak_icode_job job )
+{
+  job->error = ak_error_ok;
+  if(( ic.algorithm->func.first.set_key != NULL ) && !job->cached ) {
+    if(( job->error = aktool_icode_derive_key( job )) != ak_error_ok ) {
+     #ifdef AK_HAVE_PTHREAD_H
+      if( ic.threads > 1 ) pthread_mutex_lock( &icq.mutex );
+     #endif
+      aktool_icode_report( job );
+     #ifdef AK_HAVE_PTHREAD_H
+      if( ic.threads > 1 ) pthread_mutex_unlock( &icq.mutex );
+     #endif
+      return ak_error_ok;
+    }
+  }
+
+ #ifdef AK_HAVE_PTHREAD_H
+ /* в многопоточном режиме файл передается в очередь заданий */
+  if( ic.threads > 1 ) return aktool_icode_threads_enqueue( job );
+ #endif
+
+  job->error = aktool_icode_evaluate( ic.handle, job );
+  aktool_icode_report( job );
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ int aktool_icode_function( const char *filename, ak_pointer ptr )
+{
+  struct icode_job job;
+  char flongname[FILENAME_MAX];
+
+ /* файл для вывода результатов и файл кэша не хешируем */
+  memset( flongname, 0, sizeof( flongname ));
+  if(( ic.outfp != stdout ) || ( icc.filename != NULL )) {
+    aktool_icode_full_name( filename, flongname );
+    if( !strncmp( flongname, ic.outfile, FILENAME_MAX -2 )) return ak_error_ok;
+    if( !strncmp( flongname, audit_filename, sizeof( audit_filename ) -2 )) return ak_error_ok;
+    if( !strncmp( flongname, icc.fullname, FILENAME_MAX -2 )) return ak_error_ok;
+  }
+
+  memset( &job, 0, sizeof( struct icode_job ));
+  strncpy( job.filename, filename, sizeof( job.filename ) -1 );
+  aktool_icode_cache_lookup( &job, flongname );
+  if( job.cached ) return aktool_icode_dispatch( &job );
+
+ /* для каждого файла вырабатывается собственная синхропосылка */
+  if(( ic.generator != NULL ) &&
+     ( ak_random_ptr( ic.generator, job.iv, aktool_icode_iv_size ) != ak_error_ok )) {
+    aktool_error(_("incorrect generation of initial vector for file %s"), filename );
+    return ak_error_ok;
+  }
+
+ return aktool_icode_dispatch( &job );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Разбор одной строки файла с кодами целостности и проверка указанного в ней файла.
+    \details Поддерживаются оба формата, в которых выводятся коды целостности:
+    linux (`код имя_файла [синхропосылка]`) и bsd (`алгоритм (имя_файла) = код [(синхропосылка)]`).
+    Строки, которые не удалось разобрать, считаются не прошедшими проверку. */
+/* ----------------------------------------------------------------------------------------------- */
+ int aktool_icode_check_function( const char *string, ak_pointer ptr )
+{
+  struct icode_job job;
+  char line[FILENAME_MAX + 160];
+  bool_t keyed = ( ic.algorithm->func.first.set_key != NULL );
+  char *filename = NULL, *icode = NULL, *iv = NULL, *end = NULL;
+
+  memset( line, 0, sizeof( line ));
+  strncpy( line, string, sizeof( line ) -1 );
+  end = line + strlen( line );
+  while(( end > line ) && (( end[-1] == ' ' ) || ( end[-1] == '\r' ))) *(--end) = 0;
+  if( end == line ) return ak_error_ok; /* пустые строки пропускаем */
+
+  if(( filename = strstr( line, " (" )) != NULL &&
+                                              ( icode = strstr( filename, ") = " )) != NULL ) {
+   /* формат bsd */
+    *filename = 0;
+    if( ak_oid_find_by_ni( line ) != ic.algorithm ) {
+      aktool_error(_("the algorithm %s differs from %s"), line, ic.algorithm->name[0] );
+      goto wrong;
+    }
+    filename += 2;
+    while(( end = strstr( icode + 4, ") = " )) != NULL ) icode = end;
+    *icode = 0;
+    icode += 4;
+    if( keyed ) {
+      if(( iv = strstr( icode, " (" )) == NULL ) goto wrong;
+      *iv = 0;
+      iv += 2;
+      if(( end = strchr( iv, ')' )) != NULL ) *end = 0;
+    }
+  } else {
+     /* формат linux */
+      if(( filename = strchr( icode = line, ' ' )) == NULL ) goto wrong;
+      *(filename++) = 0;
+      if( keyed ) {
+        if(( iv = strrchr( filename, ' ' )) == NULL ) goto wrong;
+        *(iv++) = 0;
+      }
+    }
+
+  memset( &job, 0, sizeof( struct icode_job ));
+  strncpy( job.filename, filename, sizeof( job.filename ) -1 );
+  if(( job.icode_size = ( size_t ) ak_hexstr_size( icode )) > sizeof( job.icode )) goto wrong;
+  if( ak_hexstr_to_ptr( icode, job.icode, job.icode_size, ic.reverse_order ) != ak_error_ok )
+    goto wrong;
+  if( keyed && ( ak_hexstr_to_ptr( iv, job.iv, sizeof( job.iv ), ak_false ) != ak_error_ok ))
+    goto wrong;
+  if( icc.filename != NULL ) {
+    char flongname[FILENAME_MAX];
+    aktool_icode_full_name( job.filename, flongname );
+    aktool_icode_cache_lookup( &job, flongname );
+  }
+
+ return aktool_icode_dispatch( &job );
+
+  wrong:
+   aktool_error(_("incorrect format of line: %s"), string );
+  #ifdef AK_HAVE_PTHREAD_H
+   if( ic.threads > 1 ) pthread_mutex_lock( &icq.mutex );
+  #endif
+   ic.checked++;
+   ic.failed++;
+  #ifdef AK_HAVE_PTHREAD_H
+   if( ic.threads > 1 ) pthread_mutex_unlock( &icq.mutex );
+  #endif
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Формирование полного имени файла. */
+/* ----------------------------------------------------------------------------------------------- */
+ void aktool_icode_full_name( const char *filename, char *fullname )
+{
+  memset( fullname, 0, FILENAME_MAX );
+ #ifdef _WIN32
+  GetFullPathName( filename, FILENAME_MAX, fullname, NULL );
+ #else
+  realpath( filename, fullname );
+ #endif
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Сравнение записей кэша по именам файлов. */
+/* ----------------------------------------------------------------------------------------------- */
+ static int aktool_icode_cache_compare( const void *left, const void *right )
+{
+ return strcmp( (( ak_icode_cache_entry )left )->filename,
+                                                       (( ak_icode_cache_entry )right )->filename );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Добавление в кэш новой записи для файла с заданным именем. */
+/* ----------------------------------------------------------------------------------------------- */
+ static ak_icode_cache_entry aktool_icode_cache_append( const char *filename )
+{
+  ak_icode_cache_entry entry = NULL;
+  size_t len = strlen( filename ) +1;
+
+  if( icc.total == icc.allocated ) {
+    size_t allocated = ak_max( 64, icc.allocated << 1 );
+    if(( entry = realloc( icc.entries,
+                         allocated*sizeof( struct icode_cache_entry ))) == NULL ) return NULL;
+    icc.entries = entry;
+    icc.allocated = allocated;
+  }
+  entry = icc.entries + icc.total;
+  memset( entry, 0, sizeof( struct icode_cache_entry ));
+  if(( entry->filename = malloc( len )) == NULL ) return NULL;
+  memcpy( entry->filename, filename, len );
+  icc.total++;
+
+ return entry;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Разбор одной строки файла кэша. */
+/* ----------------------------------------------------------------------------------------------- */
+ static int aktool_icode_cache_read_line( const char *line, ak_pointer ptr )
+{
+  int offset = 0;
+  long long int size = 0, mtime = 0;
+  unsigned long long int inode = 0;
+  char icode[130], iv[2*aktool_icode_iv_size +2];
+  ak_icode_cache_entry entry = NULL;
+
+ /* первая строка должна совпадать с ожидаемым заголовком */
+  if( !icc.valid ) {
+    if( strcmp( line, icc.header )) return ak_error_invalid_value;
+    icc.valid = ak_true;
+    return ak_error_ok;
+  }
+
+ /* некорректные строки пропускаем */
+  if(( sscanf( line, "%lld %lld %llu %129s %33s %n",
+                                         &size, &mtime, &inode, icode, iv, &offset ) != 5 ) ||
+     ( offset == 0 ) || ( line[offset] == 0 )) return ak_error_ok;
+  if(( entry = aktool_icode_cache_append( line + offset )) == NULL ) return ak_error_out_of_memory;
+  entry->size = ( ak_int64 )size;
+  entry->mtime = ( ak_int64 )mtime;
+  entry->inode = ( ak_uint64 )inode;
+  entry->icode_size = ( size_t ) ak_hexstr_size( icode );
+  if(( entry->icode_size > sizeof( entry->icode )) ||
+     ( ak_hexstr_to_ptr( icode, entry->icode, entry->icode_size, ak_false ) != ak_error_ok ) ||
+     ( strcmp( iv, "-" ) &&
+       ( ak_hexstr_to_ptr( iv, entry->iv, sizeof( entry->iv ), ak_false ) != ak_error_ok ))) {
+    free( entry->filename );
+    icc.total--;
+  }
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Загрузка кэша ранее вычисленных кодов целостности.
+    \details Отсутствие файла кэша, равно как и несовпадение его заголовка, ошибкой не является:
+    в этом случае кэш формируется заново. */
+/* ----------------------------------------------------------------------------------------------- */
+ int aktool_icode_cache_load( void )
+{
+  size_t idx = 0, jdx = 0;
+
+  if( icc.filename == NULL ) return EXIT_SUCCESS;
+  aktool_icode_full_name( icc.filename, icc.fullname );
+
+ /* заголовок связывает кэш с алгоритмом и ключом пользователя */
+  ak_snprintf( icc.header, sizeof( icc.header ), "# aktool icode cache: %s %s",
+           ic.algorithm->name[0], ic.key == NULL ? "-" :
+                                     ak_ptr_to_hexstr( ((ak_skey)ic.key)->number, 32, ak_false ));
+
+  if( ak_file_or_directory( icc.filename ) != DT_REG ) return EXIT_SUCCESS;
+  ak_file_read_by_lines( icc.filename, aktool_icode_cache_read_line, NULL );
+  if( !icc.valid ) {
+    if( aktool_verbose ) printf(_("the cache file %s is created for another algorithm or key\n"),
+                                                                                  icc.filename );
+    icc.changed = ak_true; /* кэш будет перезаписан */
+  }
+
+ /* упорядочиваем записи и удаляем повторы */
+  if( icc.total > 1 ) {
+    qsort( icc.entries, icc.total, sizeof( struct icode_cache_entry ), aktool_icode_cache_compare );
+    for( idx = 1, jdx = 0; idx < icc.total; idx++ ) {
+       if( strcmp( icc.entries[idx].filename, icc.entries[jdx].filename ) == 0 ) {
+         free( icc.entries[idx].filename );
+         continue;
+       }
+       if( ++jdx != idx ) icc.entries[jdx] = icc.entries[idx];
+    }
+    icc.total = jdx +1;
+  }
+  icc.count = icc.total;
+  if( aktool_verbose ) printf(_("loaded %u entries from the cache file %s\n"),
+                                                           (unsigned int) icc.count, icc.filename );
+ return EXIT_SUCCESS;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Поиск файла в кэше.
+    \details Функция сохраняет в задании атрибуты файла и, если файл не изменялся с момента
+    вычисления сохраненного кода целостности, переносит этот код в задание. При проверке
+    кодов целостности сохраненные значения используются только при указании опции
+    `--trust-cache`; для имитовставок дополнительно требуется совпадение синхропосылок. */
+/* ----------------------------------------------------------------------------------------------- */
+ void aktool_icode_cache_lookup( ak_icode_job job, char *fullname )
+{
+#ifdef AK_HAVE_SYSSTAT_H
+  struct stat st;
+  struct icode_cache_entry key;
+  ak_icode_cache_entry entry = NULL;
+#endif
+
+  job->entry = -1;
+  job->cached = ak_false;
+ /* время модификации, не меньшее времени запуска, запрещает сохранение результата в кэше */
+  job->mtime = icc.start;
+
+#ifdef AK_HAVE_SYSSTAT_H
+  if( icc.filename == NULL ) return;
+  if( stat( job->filename, &st ) != 0 ) return;
+  job->size = ( ak_int64 )st.st_size;
+  job->mtime = ( ak_int64 )st.st_mtime;
+  job->inode = ( ak_uint64 )st.st_ino;
+
+ #ifdef AK_HAVE_PTHREAD_H
+  if( ic.threads > 1 ) pthread_mutex_lock( &icq.mutex );
+ #endif
+  key.filename = fullname;
+  if(( entry = bsearch( &key, icc.entries, icc.count,
+                  sizeof( struct icode_cache_entry ), aktool_icode_cache_compare )) != NULL ) {
+    job->entry = entry - icc.entries;
+    if(( entry->size == job->size ) && ( entry->mtime == job->mtime ) &&
+       ( entry->inode == job->inode ) && ( !ic.check || icc.trust )) {
+      if( !ic.check ) memcpy( job->iv, entry->iv, sizeof( job->iv ));
+      if( memcmp( job->iv, entry->iv, sizeof( job->iv )) == 0 ) {
+        memcpy( job->out, entry->icode, entry->icode_size );
+        job->tagsize = entry->icode_size;
+        job->cached = ak_true;
+      }
+    }
+  }
+ #ifdef AK_HAVE_PTHREAD_H
+  if( ic.threads > 1 ) pthread_mutex_unlock( &icq.mutex );
+ #endif
+#else
+  (void)fullname;
+#endif
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Сохранение вычисленного кода целостности в кэше
+    (в многопоточном режиме вызывается при захваченном мьютексе). */
+/* ----------------------------------------------------------------------------------------------- */
+ void aktool_icode_cache_store( ak_icode_job job )
+{
+  char fullname[FILENAME_MAX];
+  ak_icode_cache_entry entry = NULL;
+
+  if(( icc.filename == NULL ) || job->cached ) return;
+ /* файл мог быть изменен в ту же секунду, что и вычислен код целостности */
+  if( job->mtime >= icc.start ) return;
+
+  if( job->entry >= 0 ) entry = icc.entries + job->entry;
+   else {
+     aktool_icode_full_name( job->filename, fullname );
+     if(( entry = aktool_icode_cache_append( fullname )) == NULL ) return;
+   }
+  entry->size = job->size;
+  entry->mtime = job->mtime;
+  entry->inode = job->inode;
+  memcpy( entry->icode, job->out, entry->icode_size = job->tagsize );
+  memcpy( entry->iv, job->iv, sizeof( entry->iv ));
+  icc.changed = ak_true;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Запись кэша в файл (через временный файл). */
+/* ----------------------------------------------------------------------------------------------- */
+ int aktool_icode_cache_save( void )
+{
+  size_t idx = 0;
+  FILE *fp = NULL;
+  char tmpname[FILENAME_MAX];
+  ak_icode_cache_entry entry = NULL;
+
+  if(( icc.filename == NULL ) || !icc.changed ) return EXIT_SUCCESS;
+  ak_snprintf( tmpname, sizeof( tmpname ), "%s.tmp", icc.filename );
+  if(( fp = fopen( tmpname, "w" )) == NULL ) {
+    aktool_error(_("cache file \"%s\" cannot be created"), tmpname );
+    return EXIT_FAILURE;
+  }
+  fprintf( fp, "%s\n", icc.header );
+  for( idx = 0; idx < icc.total; idx++ ) {
+     entry = icc.entries + idx;
+     fprintf( fp, "%lld %lld %llu ", ( long long int )entry->size,
+                            ( long long int )entry->mtime, ( unsigned long long int )entry->inode );
+     fprintf( fp, "%s ", ak_ptr_to_hexstr( entry->icode, entry->icode_size, ak_false ));
+     if( ic.key == NULL ) fprintf( fp, "- " );
+      else fprintf( fp, "%s ", ak_ptr_to_hexstr( entry->iv, sizeof( entry->iv ), ak_false ));
+     fprintf( fp, "%s\n", entry->filename );
+  }
+  fclose( fp );
+ #ifdef _WIN32
+  remove( icc.filename );
+ #endif
+  if( rename( tmpname, icc.filename ) != 0 ) {
+    aktool_error(_("cache file \"%s\" cannot be updated"), icc.filename );
+    return EXIT_FAILURE;
+  }
+
+ return EXIT_SUCCESS;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Освобождение памяти, занимаемой кэшем. */
+/* ----------------------------------------------------------------------------------------------- */
+ void aktool_icode_cache_destroy( void )
+{
+  size_t idx = 0;
+
+  for( idx = 0; idx < icc.total; idx++ ) free( icc.entries[idx].filename );
+  if( icc.entries != NULL ) free( icc.entries );
+  memset( &icc, 0, sizeof( icc ));
+}
+
+#ifdef AK_HAVE_PTHREAD_H
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Вывод результата выполненного задания (вызывается при захваченном мьютексе). */
+/* ----------------------------------------------------------------------------------------------- */
+ static void aktool_icode_threads_print_job( ak_icode_job job )
+{
+  aktool_icode_report( job );
+  job->state = job_free;
+  icq.printed++;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция потока, вычисляющего коды целостности файлов из очереди заданий. */
+/* ----------------------------------------------------------------------------------------------- */
+ static void *aktool_icode_threads_worker( void *ptr )
+{
+  ak_icode_job job = NULL;
+  ak_pointer handle = ptr;
+
+  pthread_mutex_lock( &icq.mutex );
+  for( ;; ) {
+     while(( icq.taken == icq.added ) && !icq.stop )
+       pthread_cond_wait( &icq.job_ready, &icq.mutex );
+     if( icq.taken == icq.added ) break; /* очередь пуста и получен сигнал завершения */
+
+     job = icq.jobs + ( icq.taken++ )%icq.size;
+     job->state = job_running;
+     pthread_mutex_unlock( &icq.mutex );
+
+     job->error = aktool_icode_evaluate( handle, job );
+
+     pthread_mutex_lock( &icq.mutex );
+     job->state = job_done;
+     if( ic.unordered ) aktool_icode_threads_print_job( job );
+     pthread_cond_broadcast( &icq.job_done );
+  }
+  pthread_mutex_unlock( &icq.mutex );
+
+  ak_oid_delete_object( ic.algorithm, handle );
+ return NULL;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Создание очереди заданий и запуск потоков вычислений. */
+/* ----------------------------------------------------------------------------------------------- */
+ int aktool_icode_threads_start( void )
+{
+  size_t idx = 0;
+  ak_pointer handle = NULL;
+
+  memset( &icq, 0, sizeof( icq ));
+  icq.size = aktool_icode_jobs_per_thread*ic.threads;
+  if(( icq.jobs = calloc( icq.size, sizeof( struct icode_job ))) == NULL ) return EXIT_FAILURE;
+  if(( icq.tid = calloc( ic.threads, sizeof( pthread_t ))) == NULL ) {
+    free( icq.jobs );
+    return EXIT_FAILURE;
+  }
+  pthread_mutex_init( &icq.mutex, NULL );
+  pthread_cond_init( &icq.job_ready, NULL );
+  pthread_cond_init( &icq.job_done, NULL );
+
+ /* каждый поток использует собственный контекст алгоритма */
+  for( idx = 0; idx < ic.threads; idx++ ) {
+     if(( handle = ak_oid_new_object( ic.algorithm )) == NULL ) break;
+     if( pthread_create( icq.tid+idx, NULL, aktool_icode_threads_worker, handle ) != 0 ) {
+       ak_oid_delete_object( ic.algorithm, handle );
+       break;
+     }
+  }
+  if(( icq.count = idx ) == 0 ) {
+    aktool_icode_threads_stop();
+    return EXIT_FAILURE;
+  }
+
+ return EXIT_SUCCESS;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Помещение задания в очередь.
+    \details Если очередь заполнена, функция ожидает освобождения самого старого задания
+    (при упорядоченном выводе результат этого задания выводится здесь же).                         */
+/* ----------------------------------------------------------------------------------------------- */
+ int aktool_icode_threads_enqueue( ak_icode_job source )
+{
+  ak_icode_job job = NULL;
+
+  pthread_mutex_lock( &icq.mutex );
+  job = icq.jobs + icq.added%icq.size;
+  while( job->state != job_free ) {
+    if( !ic.unordered && ( job->state == job_done )) aktool_icode_threads_print_job( job );
+     else pthread_cond_wait( &icq.job_done, &icq.mutex );
+  }
+  memcpy( job, source, sizeof( struct icode_job ));
+  memset( source->key, 0, sizeof( source->key ));
+  job->state = job_pending;
+  icq.added++;
+
+ /* при упорядоченном выводе сразу печатаем уже готовые результаты */
+  if( !ic.unordered ) {
+    while( icq.printed < icq.added ) {
+      ak_icode_job head = icq.jobs + icq.printed%icq.size;
+      if( head->state != job_done ) break;
+      aktool_icode_threads_print_job( head );
+    }
+  }
+  pthread_cond_signal( &icq.job_ready );
+  pthread_mutex_unlock( &icq.mutex );
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Ожидание выполнения всех заданий, вывод оставшихся результатов и остановка потоков. */
+/* ----------------------------------------------------------------------------------------------- */
+ void aktool_icode_threads_stop( void )
+{
+  size_t idx = 0;
+
+  pthread_mutex_lock( &icq.mutex );
+  icq.stop = ak_true;
+  pthread_cond_broadcast( &icq.job_ready );
+  while( icq.printed < icq.added ) {
+    ak_icode_job head = icq.jobs + icq.printed%icq.size;
+    if( !ic.unordered && ( head->state == job_done )) aktool_icode_threads_print_job( head );
+     else pthread_cond_wait( &icq.job_done, &icq.mutex );
+  }
+  pthread_mutex_unlock( &icq.mutex );
+
+  for( idx = 0; idx < icq.count; idx++ ) pthread_join( icq.tid[idx], NULL );
+  pthread_cond_destroy( &icq.job_done );
+  pthread_cond_destroy( &icq.job_ready );
+  pthread_mutex_destroy( &icq.mutex );
+  free( icq.tid );
+  free( icq.jobs );
+  memset( &icq, 0, sizeof( icq ));
+}
+#endif
+
 /* ----------------------------------------------------------------------------------------------- */
  int aktool_icode_help( void )
 {
@@ -271,11 +1198,18 @@
      "available options:\n"
      " -a, --algorithm <ni>    set the algorithm, where \"ni\" is name or identifier of mac or hash function\n"
      "                         default algorithm is \"streebog256\" defined by GOST R 34.10-2012\n"
+     " -c, --check <file>      check previously calculated integrity codes from the given file\n"
+     " -k, --key <file>        set the file with secret key used to calculate authentication codes\n"
+     "                         (the mac algorithm is determined by the type of the key)\n"
      " -o, --output <file>     set the output file for generated authentication or integrity code\n"
      " -r, --recursive         recursive search of files\n"
      "     --reverse-order     output of authentication or integrity code in reverse byte order\n"
      "     --tag               create a BSD-style checksum format\n"
-     " -t, --template <str>    set the pattern which is used to find files\n\n"));
+     " -t, --template <str>    set the pattern which is used to find files\n"
+     "     --threads <n>       set the number of threads used to calculate integrity codes\n"
+     "     --unordered         output results in order of their calculation (with several threads)\n"
+     "     --cache <file>      use the file to store integrity codes and recalculate them only for modified files\n"
+     "     --trust-cache       use cached integrity codes of unmodified files while checking\n\n"));
 
   printf(_("for usage examples try \"man aktool\"\n" ));
 
@@ -18,6 +18,8 @@
  int aktool_test_speed_block_cipher( ak_oid );
  int aktool_test_speed_hash_function( ak_oid );
  int aktool_test_speed_sign_function( ak_oid );
+ int aktool_test_speed_wcurve( ak_oid );
+ int aktool_test_speed_random_generator( ak_oid );
 
 /* ----------------------------------------------------------------------------------------------- */
   bool_t aktool_test_verbose = ak_false;
@@ -29,11 +31,12 @@
   char *value = NULL;
   int next_option = 0, exit_status = EXIT_SUCCESS;
 
-  enum { do_nothing, do_dynamic, do_speed_oid } work = do_nothing;
+  enum { do_nothing, do_dynamic, do_speed_oid, do_speed_random } work = do_nothing;
 
   const struct option long_options[] = {
      { "crypto",           0, NULL, 255 },
      { "speed",            1, NULL, 254 },
+     { "random",           0, NULL, 253 },
      { "verbose",          0, NULL, 'v' },
 
      aktool_common_functions_definition,
@@ -59,6 +62,10 @@
                      work = do_speed_oid; value = optarg;
                      break;
 
+        case 253 : /* тест скорости всех генераторов псевдо-случайных чисел */
+                     work = do_speed_random;
+                     break;
+
         default:   /* обрабатываем ошибочные параметры */
                      if( next_option != -1 ) work = do_nothing;
                      break;
@@ -97,7 +104,15 @@
         case sign_function:
            exit_status = aktool_test_speed_sign_function( oid );
            break;
-
+        case random_generator:
+           exit_status = aktool_test_speed_random_generator( oid );
+           break;
+        case identifier:
+           if( oid->mode == wcurve_params ) {
+             exit_status = aktool_test_speed_wcurve( oid );
+             break;
+           }
+           /* fall through */
 
          default:
            printf(_("algorithm engine \"%s\" is not supported yet for testing, sorry ... \n"),
@@ -106,6 +121,14 @@
        }
        break; /* конец do_speed_oid */
 
+     case do_speed_random:
+       oid = ak_oid_find_by_engine( random_generator );
+       while( oid != NULL ) {
+         if( aktool_test_speed_random_generator( oid ) != EXIT_SUCCESS ) exit_status = EXIT_FAILURE;
+         oid = ak_oid_findnext_by_engine( oid, random_generator );
+       }
+       break; /* конец do_speed_random */
+
      default:  break; /* конец switch( work ) */
    }
    if( exit_status == EXIT_FAILURE )
@@ -126,6 +149,9 @@
      "     --crypto            complete test of cryptographic algorithms\n"
      "                         run all available algorithms on test values taken from standards and recommendations\n"
      "     --speed <ni>        measuring the speed of the crypto algorithm with a given name or identifier\n"
+     "                         or the speed of point multiplication for a given elliptic curve\n"
+     "                         or the speed of a random generator\n"
+     "     --random            measuring the speed of all available random generators\n"
      " -v, --verbose           detailed information output\n"
      "\n"
      "for more information run tests with \"--audit 2 --audit-file stderr\" options or see /var/log/auth.log file\n"
@@ -483,6 +509,152 @@
  return exit_status;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+ typedef void ( aktool_wpoint_pow_function )( ak_wpoint, ak_wpoint, ak_uint64 *, size_t, ak_wcurve );
+
+/* ----------------------------------------------------------------------------------------------- */
+ static double aktool_test_wpoint_pow_for_one_function( ak_wcurve wc,
+                              aktool_wpoint_pow_function *pow, const char *name, ak_random generator )
+{
+  clock_t timea = 1;
+  struct wpoint wq;
+  size_t j, i = 0, cnt = 0;
+  double iter = 0, avg = 0, val = 0;
+  ak_uint64 k[8];
+
+  printf(" %s: ", name );
+  if( aktool_test_verbose ) printf("\n");
+  for( j = 1; j < 9; j++ ) {
+     i = cnt = j*( 64/wc->size );
+     ak_random_ptr( generator, k, wc->size*sizeof( ak_uint64 ));
+
+     timea = clock();
+     while( i ) {
+        pow( &wq, &wc->point, k, wc->size, wc );
+        i--;
+     }
+     timea = clock() - timea;
+     val = (cnt *(double) CLOCKS_PER_SEC )/(double) timea;
+     if( aktool_test_verbose ) {
+       printf(_("[count: %3lu, time = %fs, speed: %f sec., count: %f]\n"),
+       (long unsigned int)cnt,
+       (double) timea / (double) CLOCKS_PER_SEC,
+       (double) timea / (cnt *(double) CLOCKS_PER_SEC ),
+       val );
+     } else { printf("."); fflush( stdout ); }
+
+     if( j > 1 ) { iter += 1; avg += val; }
+  }
+  printf(_(" average speed: %10f mul/sec.\n"), avg/iter );
+ return avg/iter;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция измеряет скорость вычисления кратной точки для заданной эллиптической кривой
+    (функции ak_wpoint_pow() и ak_wpoint_pow_montgomery()) и сравнивает результаты вычислений. */
+/* ----------------------------------------------------------------------------------------------- */
+ int aktool_test_speed_wcurve( ak_oid oid )
+{
+  size_t i;
+  ak_uint64 k[8];
+  struct wpoint wp, wq;
+  double fast = 0, ladder = 0;
+  struct random generator;
+  int exit_status = EXIT_SUCCESS;
+  ak_wcurve wc = ( ak_wcurve )oid->data;
+
+  if( ak_random_create_lcg( &generator ) != ak_error_ok ) return EXIT_FAILURE;
+  printf(_("curve: %s (%s)\n"), oid->name[0], oid->id[0] );
+
+ /* сравниваем результаты вычислений */
+  for( i = 0; i < 16; i++ ) {
+     ak_random_ptr( &generator, k, wc->size*sizeof( ak_uint64 ));
+     ak_wpoint_pow( &wp, &wc->point, k, wc->size, wc );
+     ak_wpoint_pow_montgomery( &wq, &wc->point, k, wc->size, wc );
+     ak_wpoint_reduce( &wp, wc );
+     ak_wpoint_reduce( &wq, wc );
+     if(( ak_mpzn_cmp( wp.x, wq.x, wc->size ) != 0 ) ||
+        ( ak_mpzn_cmp( wp.y, wq.y, wc->size ) != 0 )) {
+       aktool_error(_("the results of point multiplication are different"));
+       exit_status = EXIT_FAILURE;
+       goto labex;
+     }
+  }
+
+  fast = aktool_test_wpoint_pow_for_one_function( wc, ak_wpoint_pow, "ak_wpoint_pow", &generator );
+  ladder = aktool_test_wpoint_pow_for_one_function( wc,
+                            ak_wpoint_pow_montgomery, "ak_wpoint_pow_montgomery", &generator );
+  printf(_(" speedup: %f\n"), fast/ladder );
+
+  labex:
+    ak_random_destroy( &generator );
+ return exit_status;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция измеряет скорость выработки данных генератором псевдо-случайных чисел для
+    запросов различной длины (от 4 байт до 1 мегабайта). Для каждой длины запроса выводятся
+    количество обращений к генератору, скорость выработки данных (в мегабайтах в секунду)
+    и среднее время одного обращения (в наносекундах).
+
+    Количество обращений ограничивается как сверху, так и общим объемом вырабатываемых данных,
+    что позволяет оценить и накладные расходы на один вызов, и пропускную способность генератора. */
+/* ----------------------------------------------------------------------------------------------- */
+ int aktool_test_speed_random_generator( ak_oid oid )
+{
+  clock_t timea = 1;
+  ak_random generator = NULL;
+  ak_uint8 *data = NULL;
+  double seconds = 0;
+  size_t i, j, count = 0;
+  int error = ak_error_ok, exit_status = EXIT_FAILURE;
+  const size_t sizes[] = { 4, 16, 32, 64, 256, 1024, 4096, 65536, 1048576 };
+  const size_t maxcalls = 131072, maxbytes = 16*1048576;
+
+  if( oid->mode != algorithm ) {
+    printf(_("random generator's mode \"%s\" is not supported yet for testing, sorry ... \n"),
+                                                           ak_libakrypt_get_mode_name( oid->mode ));
+    return EXIT_SUCCESS;
+  }
+  if(( generator = ak_oid_new_object( oid )) == NULL ) {
+    aktool_error( _("incorrect creation of random generator context (code: %d)" ),
+                                                                          ak_error_get_value( ));
+    return exit_status;
+  }
+  if(( data = malloc( sizes[ sizeof( sizes )/sizeof( size_t ) -1 ] )) == NULL ) {
+    aktool_error( _("incorrect memory allocation" ));
+    goto exit;
+  }
+
+  printf(_("random generator: %s (%s)\n"), oid->name[0], oid->id[0] );
+  printf(_("%12s %10s %12s %12s %12s\n"), _("size"), _("calls"), _("time"), _("MBs"), _("ns/call"));
+  for( i = 0; i < sizeof( sizes )/sizeof( size_t ); i++ ) {
+     count = ak_min( maxcalls, ak_max( 16, maxbytes/sizes[i] ));
+
+     timea = clock();
+     for( j = 0; j < count; j++ )
+        if(( error = ak_random_ptr( generator, data, (ssize_t)sizes[i] )) != ak_error_ok ) break;
+     timea = clock() - timea;
+
+     if( error != ak_error_ok ) {
+       aktool_error(_("computational error (%d)"), error );
+       goto exit;
+     }
+     if( timea == 0 ) timea = 1;
+     seconds = (double) timea / (double) CLOCKS_PER_SEC;
+     printf(" %11lu %10lu %11fs %12.3f %12.1f\n", (long unsigned int)sizes[i],
+             (long unsigned int)count, seconds,
+             (double)( count*sizes[i] )/( 1048576.*seconds ), 1.0e9*seconds/(double)count );
+  }
+  exit_status = EXIT_SUCCESS;
+
+  exit:
+   if( data != NULL ) free( data );
+   ak_oid_delete_object( oid, generator );
+
+ return exit_status;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*                                                                                  aktool_test.c  */
 /* ----------------------------------------------------------------------------------------------- */
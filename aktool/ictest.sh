@@ -0,0 +1,56 @@
+#! /bin/bash
+# скрипт для проверки выработки и проверки кодов целостности (имитовставок) утилитой aktool
+# для количества файлов, превышающего ресурс ключа пользователя
+#
+# указываем расположение утилиты aktool
+export AKTOOL=${1:-./aktool};
+#
+# количество файлов (ресурс ключа hmac по-умолчанию равен 65536)
+export FILES=70000;
+#
+export WORKDIR=$(mktemp -d);
+trap "rm -rf ${WORKDIR}" EXIT;
+cd ${WORKDIR};
+#
+# ------------------------------------------------------------------------------------------------- #
+echo "1. Создаем ключ пользователя и ${FILES} файлов";
+# ------------------------------------------------------------------------------------------------- #
+${AKTOOL} k -nt hmac-streebog256 -o user.key --outpass 1234 --random lcg > /dev/null
+if [[ $? -ne 0 ]]
+then echo "aktool не может создать ключ пользователя"; exit 1;
+fi
+mkdir files;
+seq 1 ${FILES} | xargs -n 1000 sh -c 'for i; do echo $i > files/f$i; done' _
+#
+# ------------------------------------------------------------------------------------------------- #
+echo "2. Вырабатываем имитовставки для всех файлов";
+# ------------------------------------------------------------------------------------------------- #
+echo 1234 | ${AKTOOL} i -k user.key -o icodes.txt files > /dev/null
+if [[ $? -ne 0 ]]
+then echo "aktool не может выработать имитовставки"; exit 1;
+fi
+if [[ $(wc -l < icodes.txt) -ne ${FILES} ]]
+then echo "количество имитовставок не совпадает с количеством файлов"; exit 1;
+fi
+#
+# ------------------------------------------------------------------------------------------------- #
+echo "3. Проверяем имитовставки первого и последнего файлов отдельными запусками";
+# ------------------------------------------------------------------------------------------------- #
+head -1 icodes.txt > first.txt;
+tail -1 icodes.txt > last.txt;
+for name in first.txt last.txt
+do
+  echo 1234 | ${AKTOOL} i -k user.key -c ${name} > /dev/null
+  if [[ $? -ne 0 ]]
+  then echo "имитовставка из файла ${name} не прошла проверку"; exit 1;
+  fi
+done
+#
+# ------------------------------------------------------------------------------------------------- #
+echo "4. Проверяем имитовставки всех файлов";
+# ------------------------------------------------------------------------------------------------- #
+echo 1234 | ${AKTOOL} i -k user.key -c icodes.txt > /dev/null
+if [[ $? -ne 0 ]]
+then echo "имитовставки не прошли проверку"; exit 1;
+fi
+echo "Ok";
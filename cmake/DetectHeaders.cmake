@@ -108,6 +108,14 @@ check_c_source_compiles("
      return 0;
   }" AK_HAVE_SYSMMAN_H )
 
+# -------------------------------------------------------------------------------------------------- #
+check_c_source_compiles("
+  #include <sys/random.h>
+  int main( void ) {
+     unsigned char buffer[16];
+     return ( int ) getrandom( buffer, sizeof( buffer ), 0 );
+  }" AK_HAVE_SYSRANDOM_H )
+
 # -------------------------------------------------------------------------------------------------- #
 check_c_source_compiles("
   #include <sys/stat.h>
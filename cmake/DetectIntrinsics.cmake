@@ -19,6 +19,21 @@ if( AK_HAVE_BUILTIN_MULQ_GCC )
     set( CMAKE_C_FLAGS "${CMAKE_C_FLAGS} -DAK_HAVE_BUILTIN_MULQ_GCC" )
 endif()
 
+# -------------------------------------------------------------------------------------------------- #
+# -------------------------------------------------------------------------------------------------- #
+check_c_source_compiles("
+  int main( void ) {
+    __extension__ typedef unsigned __int128 uint128;
+    unsigned long long int u = 1, v = 2;
+    uint128 w = ( uint128 )u * v;
+
+   return ( int )( w >> 64 );
+  }" AK_HAVE_BUILTIN_UINT128 )
+
+if( AK_HAVE_BUILTIN_UINT128 )
+    set( CMAKE_C_FLAGS "${CMAKE_C_FLAGS} -DAK_HAVE_BUILTIN_UINT128" )
+endif()
+
 # -------------------------------------------------------------------------------------------------- #
 # -------------------------------------------------------------------------------------------------- #
 check_c_source_compiles("
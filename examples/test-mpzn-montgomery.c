@@ -79,7 +79,8 @@
 /* тест для операции умножения вычетов в представлении монтгомери */
  bool_t mul_montgomery_test( size_t size, const char *prime, ak_uint64 n0, size_t count )
 {
-  size_t i = 0, errors_gmp = 0, val = 0;
+  size_t i = 0, errors_gmp = 0, val = 0, valsq = 0, valpm = 0;
+  bool_t special = ak_false;
   mpz_t xm, ym, zm, tm, pm, rm, gm, sm, um, nm;
   ak_mpznmax x, y, n, p, z;
   struct random generator;
@@ -105,6 +106,7 @@
 
   ak_mpz_to_mpzn( nm, n, size );
   ak_mpz_to_mpzn( pm, p, size );
+  special = ak_mpzn_is_pseudo_mersenne( p, size );
   if( n0 != n[0] ) {
     printf("%llu (old)\n%llu (new)\n", n0, n[0] );
     goto lab_exit;
@@ -133,8 +135,27 @@
      ak_mpzn_mul_montgomery( z, x, y, p, n0, size );
      ak_mpzn_to_mpz( z, size, zm );
      if( mpz_cmp( um, zm ) == 0 ) val++;
+
+     // возведение в квадрат: результат x*x*r^{-1}
+     mpz_mul( tm, xm, xm ); mpz_mul( tm, tm, sm ); mpz_mod( tm, tm, pm );
+     ak_mpzn_sqr_montgomery( z, x, p, n0, size );
+     ak_mpzn_to_mpz( z, size, zm );
+     if( mpz_cmp( tm, zm ) == 0 ) valsq++;
+
+     // арифметика для модулей вида 2^n - c
+     if( special ) {
+       ak_mpzn_mul_montgomery_pseudo_mersenne( z, x, y, p, n0, size );
+       ak_mpzn_to_mpz( z, size, zm );
+       if( mpz_cmp( um, zm ) == 0 ) valpm++;
+       ak_mpzn_sqr_montgomery_pseudo_mersenne( z, x, p, n0, size );
+       ak_mpzn_to_mpz( z, size, zm );
+       if( mpz_cmp( tm, zm ) == 0 ) valpm++;
+     }
   }
   printf(" correct montgomery multiplications %ld from %ld with %ld gmp errors\n", val, count, errors_gmp );
+  printf(" correct montgomery squarings %ld from %ld\n", valsq, count );
+  if( special ) printf(" correct pseudo-mersenne multiplications and squarings %ld from %ld\n",
+                                                                                  valpm, 2*count );
 
   val=0;
  // дополнительный цикл проверок
@@ -189,6 +210,38 @@
   tmr = clock() - tmr;
   printf(" gmp time:  %.3fs [only multiplication with modulo reduction]\n", ((double) tmr) / ((double) CLOCKS_PER_SEC));
 
+  // -----------------------
+  printf("\n squarings:\n");
+  tmr = clock();
+  for( i = 0; i < count; i++ ) {
+     ak_mpzn_mul_montgomery( x, x, x, p, n[0], size );
+  }
+  tmr = clock() - tmr;
+  printf(" mpzn time: %.3fs [multiplication]\n", ((double) tmr) / ((double) CLOCKS_PER_SEC));
+
+  tmr = clock();
+  for( i = 0; i < count; i++ ) {
+     ak_mpzn_sqr_montgomery( x, x, p, n[0], size );
+  }
+  tmr = clock() - tmr;
+  printf(" mpzn time: %.3fs [squaring]\n", ((double) tmr) / ((double) CLOCKS_PER_SEC));
+
+  if( special ) {
+    tmr = clock();
+    for( i = 0; i < count; i++ ) {
+       ak_mpzn_mul_montgomery_pseudo_mersenne( x, x, y, p, n[0], size );
+    }
+    tmr = clock() - tmr;
+    printf(" mpzn time: %.3fs [pseudo-mersenne multiplication]\n", ((double) tmr) / ((double) CLOCKS_PER_SEC));
+
+    tmr = clock();
+    for( i = 0; i < count; i++ ) {
+       ak_mpzn_sqr_montgomery_pseudo_mersenne( x, x, p, n[0], size );
+    }
+    tmr = clock() - tmr;
+    printf(" mpzn time: %.3fs [pseudo-mersenne squaring]\n", ((double) tmr) / ((double) CLOCKS_PER_SEC));
+  }
+
   // -----------------------
   printf("\n shiftings (multiplication by 2):\n");
   ak_mpzn_set_random_modulo( x, p, size, &generator );
@@ -221,7 +274,71 @@
   mpz_clear(ym);
   mpz_clear(xm);
 
- return ( val == count );
+ return ( val == count ) && ( valsq == count ) && ( !special || ( valpm == 2*count ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/* тест для операции обращения вычетов (в том числе в представлении монтгомери) */
+ bool_t inverse_test( size_t size, const char *prime, ak_uint64 n0, ak_uint64 *r2, size_t count )
+{
+  size_t i = 0, val = 0, valm = 0;
+  mpz_t xm, zm, pm;
+  ak_mpznmax x, z, t, p, u;
+  struct random generator;
+  clock_t tmr;
+
+  mpz_init(xm);
+  mpz_init(zm);
+  mpz_init(pm);
+  ak_random_create_lcg( &generator );
+
+  if( ak_mpzn_set_hexstr( p, size, prime ) != ak_error_ok ) goto lab_exit;
+  ak_mpzn_to_mpz( p, size, pm );
+  ak_mpzn_set_ui( u, size, 2 );
+  ak_mpzn_sub( u, p, u, size );
+
+  for( i = 0; i < count; i++ ) {
+     ak_mpzn_set_random_modulo( x, p, size, &generator );
+     if( i == 0 ) ak_mpzn_set_ui( x, size, 1 );
+     if( i == 1 ) { ak_mpzn_set( x, p, size ); x[0]--; }
+     ak_mpzn_to_mpz( x, size, xm );
+
+     ak_mpzn_inverse( z, x, p, size );
+     mpz_invert( zm, xm, pm );
+     ak_mpzn_to_mpz( z, size, xm );
+     if( mpz_cmp( xm, zm ) == 0 ) val++;
+
+    /* обращение в представлении Монтгомери должно совпадать с возведением в степень p-2 */
+     ak_mpzn_inverse_montgomery( z, x, p, n0, r2, size );
+     ak_mpzn_modpow_montgomery( t, x, u, p, n0, size );
+     if( ak_mpzn_cmp( z, t, size ) == 0 ) valm++;
+  }
+  printf(" correct inversions %ld from %ld (montgomery: %ld)\n", val, count, valm );
+
+  /* тест на скорость */
+  ak_mpzn_set_random_modulo( x, p, size, &generator );
+  tmr = clock();
+  for( i = 0; i < count; i++ ) ak_mpzn_inverse_montgomery( x, x, p, n0, r2, size );
+  tmr = clock() - tmr;
+  printf(" mpzn time: %.3fs (inversion)\n", ((double) tmr) / ((double) CLOCKS_PER_SEC));
+
+  tmr = clock();
+  for( i = 0; i < count; i++ ) ak_mpzn_modpow_montgomery( x, x, u, p, n0, size );
+  tmr = clock() - tmr;
+  printf(" mpzn time: %.3fs (exponentiation)\n", ((double) tmr) / ((double) CLOCKS_PER_SEC));
+
+  ak_mpzn_to_mpz( x, size, xm );
+  tmr = clock();
+  for( i = 0; i < count; i++ ) mpz_invert( xm, xm, pm );
+  tmr = clock() - tmr;
+  printf(" gmp time:  %.3fs\n\n", ((double) tmr) / ((double) CLOCKS_PER_SEC));
+
+  lab_exit: ak_random_destroy( &generator );
+  mpz_clear(pm);
+  mpz_clear(zm);
+  mpz_clear(xm);
+
+ return ( val == count ) && ( valm == count );
 }
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -248,10 +365,10 @@
         printf(" - ak_mpzn_mul_montgomery() function test for ak_mpzn256 started\n");
         totalmany++;
         if( mul_montgomery_test( wc->size, str, wc->n, count )) howmany++;
+        printf(" - ak_mpzn_inverse() function test for ak_mpzn256 started\n");
+        totalmany++;
+        if( inverse_test( wc->size, str, wc->n, wc->r2, count/100 )) howmany++;
         if( str ) free( (void *)str );
-
-  // добавить modpow!!
-
       }
       if( wc->size == ak_mpzn512_size ) {
         printf(" - p: %s\n", str = ak_mpzn_to_hexstr_alloc( wc->p, wc->size ));
@@ -261,6 +378,9 @@
         printf(" - ak_mpzn_mul_montgomery() function test for ak_mpzn512 started\n");
         totalmany++;
         if( mul_montgomery_test( wc->size, str, wc->n, count )) howmany++;
+        printf(" - ak_mpzn_inverse() function test for ak_mpzn512 started\n");
+        totalmany++;
+        if( inverse_test( wc->size, str, wc->n, wc->r2, count/100 )) howmany++;
         if( str ) free( (void *)str );
       }
     }
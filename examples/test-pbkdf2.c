@@ -0,0 +1,97 @@
+/* ----------------------------------------------------------------------------------------------- */
+/* Тестовый пример, иллюстрирующий пакетную выработку ключевых векторов из паролей
+   по алгоритму PBKDF2 (Р 50.1.111-2016). Результаты пакетной обработки сравниваются
+   с последовательным вызовом функции ak_hmac_pbkdf2_streebog512().
+
+   test-pbkdf2.c                                                                                   */
+/* ----------------------------------------------------------------------------------------------- */
+
+ #include <time.h>
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <libakrypt.h>
+
+/* количество задач в пакете (не кратно количеству одновременно обрабатываемых задач) */
+ #define tasks_count (11)
+
+ int main( void )
+{
+  clock_t time;
+  size_t idx = 0, threads = 0;
+  int result = EXIT_SUCCESS;
+  struct pbkdf2_task tasks[tasks_count];
+  char passwords[tasks_count][96];
+  ak_uint8 salts[tasks_count][24], out[tasks_count][64], check[tasks_count][64];
+
+ /* инициализируем библиотеку */
+  if( !ak_libakrypt_create( ak_function_log_stderr )) return ak_libakrypt_destroy();
+
+ /* формируем задачи с различными паролями, солью, числом итераций и длиной ключа */
+  for( idx = 0; idx < tasks_count; idx++ ) {
+     memset( passwords[idx], 'a' + (int)idx, sizeof( passwords[idx] ));
+     memset( salts[idx], (int)idx, sizeof( salts[idx] ));
+     tasks[idx].pass = passwords[idx];
+     tasks[idx].pass_size = 1 + 9*idx; /* последние пароли длиннее блока функции хеширования */
+     tasks[idx].salt = salts[idx];
+     tasks[idx].salt_size = 1 + 2*idx;
+     tasks[idx].count = 1 + 257*( idx%5 );
+     tasks[idx].dklen = 32 + 3*idx;
+     tasks[idx].error = ak_error_ok;
+
+     memset( check[idx], 0, 64 );
+     if( ak_hmac_pbkdf2_streebog512( tasks[idx].pass, tasks[idx].pass_size, tasks[idx].salt,
+                    tasks[idx].salt_size, tasks[idx].count, tasks[idx].dklen,
+                                                               check[idx] ) != ak_error_ok ) {
+       printf("incorrect evaluation of pbkdf2 for task %u\n", (unsigned int) idx );
+       result = EXIT_FAILURE;
+       goto exlab;
+     }
+  }
+
+ /* выполняем пакетную обработку в одном и нескольких потоках */
+  for( threads = 1; threads < 5; threads += 3 ) {
+     for( idx = 0; idx < tasks_count; idx++ ) {
+        memset( out[idx], 0, 64 );
+        tasks[idx].out = out[idx];
+     }
+     time = clock();
+     if( ak_hmac_pbkdf2_streebog512_batch( tasks, tasks_count, threads ) != ak_error_ok ) {
+       printf("incorrect batch evaluation of pbkdf2\n");
+       result = EXIT_FAILURE;
+       goto exlab;
+     }
+     time = clock() - time;
+     printf("batch of %u tasks, threads: %u (%f sec): ", tasks_count,
+                              (unsigned int) threads, (double) time / (double) CLOCKS_PER_SEC );
+     if( memcmp( out, check, sizeof( out )) != 0 ) {
+       printf("Wrong\n");
+       result = EXIT_FAILURE;
+     } else printf("Ok\n");
+  }
+
+ /* некорректная задача не должна влиять на остальные */
+  for( idx = 0; idx < tasks_count; idx++ ) {
+     memset( out[idx], 0, 64 );
+     tasks[idx].out = out[idx];
+  }
+  tasks[2].dklen = 16;
+  if( ak_hmac_pbkdf2_streebog512_batch( tasks, tasks_count, 1 ) == ak_error_ok ) {
+    printf("batch with wrong task is accepted\n");
+    result = EXIT_FAILURE;
+  }
+  for( idx = 0; idx < tasks_count; idx++ ) {
+     if( idx == 2 ) {
+       if( tasks[idx].error == ak_error_ok ) result = EXIT_FAILURE;
+       continue;
+     }
+     if(( tasks[idx].error != ak_error_ok ) || memcmp( out[idx], check[idx], 64 )) {
+       printf("wrong result for task %u\n", (unsigned int) idx );
+       result = EXIT_FAILURE;
+     }
+  }
+
+  exlab:
+  ak_libakrypt_destroy();
+ return result;
+}
@@ -10,6 +10,10 @@
  #include <string.h>
  #include <stdlib.h>
  #include <libakrypt.h>
+#if defined(__unix__) || defined(__APPLE__)
+ #include <unistd.h>
+ #include <sys/wait.h>
+#endif
 
 /* основная тестирующая функция */
  int test_function( ak_function_random create, const char *result )
@@ -47,6 +51,37 @@
  return retval;
 }
 
+ #if defined(__unix__) || defined(__APPLE__)
+/* проверка того, что дочерний процесс не повторяет данные, вырабатываемые родительским процессом */
+ int test_fork( ak_function_random create )
+{
+ pid_t pid;
+ int fd[2], retval = ak_true;
+ struct random generator;
+ ak_uint8 parent[16], child[16];
+
+  if( create( &generator ) != ak_error_ok ) return ak_false;
+  ak_random_ptr( &generator, parent, sizeof( parent )); /* заполняем буфер */
+  if( pipe( fd ) != 0 ) { ak_random_destroy( &generator ); return ak_false; }
+
+  printf("%s after fork: ", generator.oid->name[0] ); fflush( stdout );
+  if(( pid = fork()) == 0 ) {
+    ak_random_ptr( &generator, child, sizeof( child ));
+    if( write( fd[1], child, sizeof( child )) != sizeof( child )) _exit( EXIT_FAILURE );
+    _exit( EXIT_SUCCESS );
+  }
+  ak_random_ptr( &generator, parent, sizeof( parent ));
+  if(( pid < 0 ) || ( read( fd[0], child, sizeof( child )) != sizeof( child ))) retval = ak_false;
+  if( pid > 0 ) waitpid( pid, NULL, 0 );
+  if( memcmp( parent, child, sizeof( parent )) == 0 ) retval = ak_false;
+  printf("%s\n", retval ? "Ok" : "Wrong" );
+
+  close( fd[0] ); close( fd[1] );
+  ak_random_destroy( &generator );
+ return retval;
+}
+#endif
+
  int main( void )
 {
  int error = EXIT_SUCCESS;
@@ -58,6 +93,9 @@
    if( test_function( ak_random_create_lcg,
       "47b7ef2b729133a3e9853e0f4ffe040154a7622b7827e71bc6e48dff98c27f61" ) != ak_true )
      error = EXIT_FAILURE;
+   if( test_function( ak_random_create_xorshift128,
+      "98db5eb91947a78d5e1ff3dd08ee386da6fa94afe77b36701d9ca4119a4e6cff" ) != ak_true )
+     error = EXIT_FAILURE;
 
 #ifdef _WIN32
  if( test_function( ak_random_create_winrtl, NULL ) != ak_true ) error = EXIT_FAILURE;
@@ -67,6 +105,14 @@
  if( test_function( ak_random_create_random, NULL ) != ak_true ) error = EXIT_FAILURE;
  if( test_function( ak_random_create_urandom, NULL ) != ak_true ) error = EXIT_FAILURE;
 #endif
+#ifdef AK_HAVE_SYSRANDOM_H
+ if( test_function( ak_random_create_getrandom, NULL ) != ak_true ) error = EXIT_FAILURE;
+ if( test_fork( ak_random_create_getrandom ) != ak_true ) error = EXIT_FAILURE;
+#endif
+ if( test_function( ak_random_create_ctr_drbg, NULL ) != ak_true ) error = EXIT_FAILURE;
+#if defined(__unix__) || defined(__APPLE__)
+ if( test_fork( ak_random_create_ctr_drbg ) != ak_true ) error = EXIT_FAILURE;
+#endif
 
  ak_libakrypt_destroy();
  return error;
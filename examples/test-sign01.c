@@ -7,9 +7,60 @@
  #include <stdlib.h>
  #include <string.h>
  #include <libakrypt.h>
+#ifdef AK_HAVE_PTHREAD_H
+ #include <pthread.h>
+#endif
+
+/* количество потоков, одновременно вырабатывающих подписи */
+ #define threads_count (4)
+
+/* задача для потока: подпись с генератором текущего потока (передается NULL) и ее проверка */
+ struct sign_task {
+  ak_uint8 *key;
+  ak_random generator;
+  bool_t result;
+ };
+
+ static void *sign_with_thread_generator( void *ptr )
+{
+  int i = 0;
+  struct signkey sk;
+  struct verifykey pk;
+  ak_uint8 sign[128];
+  struct sign_task *task = ptr;
+
+ /* контексты секретного и открытого ключей не могут использоваться
+    несколькими потоками одновременно, поэтому каждый поток создает свои */
+  task->result = ak_false;
+  if( ak_signkey_create_str( &sk, "cspa") != ak_error_ok ) return NULL;
+  ak_signkey_set_key( &sk, task->key, 32 );
+  if( ak_verifykey_create_from_signkey( &pk, &sk ) != ak_error_ok ) {
+    ak_signkey_destroy( &sk );
+    return NULL;
+  }
+
+  task->result = ak_true;
+  task->generator = ak_random_get_thread_generator();
+  for( i = 0; i < 8; i++ ) {
+     if( ak_random_get_thread_generator() != task->generator ) task->result = ak_false;
+     if( ak_signkey_sign_ptr( &sk, NULL, &i, sizeof( i ), sign, sizeof( sign )) != ak_error_ok )
+       task->result = ak_false;
+     if( ak_verifykey_verify_ptr( &pk, &i, sizeof( i ), sign ) != ak_true )
+       task->result = ak_false;
+  }
+  ak_verifykey_destroy( &pk );
+  ak_signkey_destroy( &sk );
+ return NULL;
+}
 
  int main( int argc, char *argv[] )
 {
+  size_t i = 0;
+  ak_random main_generator = NULL;
+  struct sign_task tasks[threads_count];
+#ifdef AK_HAVE_PTHREAD_H
+  pthread_t threads[threads_count];
+#endif
   struct signkey sk;
   struct verifykey pk;
   struct random generator;
@@ -54,6 +105,26 @@
     printf("verify: Ok\n");
    else { printf("verify: Wrong\n"); result = EXIT_FAILURE; }
 
+ /* подписываем с использованием генераторов, принадлежащих потокам */
+  main_generator = ak_random_get_thread_generator();
+  for( i = 0; i < threads_count; i++ ) tasks[i].key = testkey;
+#ifdef AK_HAVE_PTHREAD_H
+  for( i = 0; i < threads_count; i++ )
+     pthread_create( threads+i, NULL, sign_with_thread_generator, tasks+i );
+  for( i = 0; i < threads_count; i++ ) pthread_join( threads[i], NULL );
+#else
+  for( i = 0; i < threads_count; i++ ) sign_with_thread_generator( tasks+i );
+#endif
+  for( i = 0; i < threads_count; i++ ) {
+     if( !tasks[i].result ) result = EXIT_FAILURE;
+    #ifdef AK_HAVE_PTHREAD_H
+     if( tasks[i].generator == main_generator ) result = EXIT_FAILURE; /* у потока свой генератор */
+    #else
+     if( tasks[i].generator != main_generator ) result = EXIT_FAILURE;
+    #endif
+  }
+  printf("thread generators: %s\n", result == EXIT_SUCCESS ? "Ok" : "Wrong" );
+
   ak_signkey_destroy( &sk );
   ak_verifykey_destroy( &pk );
 
@@ -0,0 +1,247 @@
+/* ----------------------------------------------------------------------------------------------- */
+/* Тестовый пример, в котором большое количество ключей алгоритма Кузнечик размещается в арене
+   заблокированной памяти (опция use_locked_memory). Результаты зашифрования сравниваются
+   с результатами, полученными для ключей, память под которые выделяется функцией malloc().
+   Также проверяется повторное использование контекстов ключей, хранящихся в пуле,
+   периодическая проверка целостности ключа (опция icode_check_interval) и пакетная
+   выработка производных ключей с помощью ключевого дерева.
+
+   test-skey01.c                                                                                   */
+/* ----------------------------------------------------------------------------------------------- */
+
+ #include <time.h>
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <libakrypt.h>
+
+/* количество одновременно существующих ключей (занимает несколько блоков арены) */
+ #define keys_count (3000)
+
+/* ----------------------------------------------------------------------------------------------- */
+ static double test_create_keys( struct bckey *keys, ak_uint8 *out, memory_allocation_policy_t policy )
+{
+  size_t idx = 0;
+  clock_t time = clock();
+  ak_uint8 key[32], in[16];
+
+  for( idx = 0; idx < keys_count; idx++ ) {
+     memset( key, (int)idx, sizeof( key ));
+     memset( in, (int)( idx >> 8 ), sizeof( in ));
+     if( ak_bckey_create_kuznechik( keys+idx ) != ak_error_ok ) return -1;
+     if( keys[idx].key.policy != policy ) return -1;
+     ak_bckey_set_key( keys+idx, key, sizeof( key ));
+     ak_bckey_encrypt_ecb( keys+idx, in, out+16*idx, sizeof( in ));
+  }
+  time = clock() - time;
+ return (double) time / (double) CLOCKS_PER_SEC;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/* контекст, возвращенный в пул, не должен содержать ключевой информации:
+   ключ и раундовые ключи изменяются, состояние функции хеширования возвращается в начальное */
+ static bool_t test_key_pool_wiped( ak_oid oid, ak_pointer ctx, ak_uint8 *kbuf, ak_uint8 *dbuf )
+{
+  struct hash hctx;
+  bool_t result = ak_true;
+  ak_skey skey = ( ak_skey )ctx;
+
+  if( memcmp( skey->key, kbuf, 32 ) == 0 ) return ak_false;
+  if( oid->engine == block_cipher ) {
+    if(( skey->data == NULL ) || ( memcmp( skey->data, dbuf, 64 ) == 0 )) return ak_false;
+  } else {
+      ak_hmac hk = ( ak_hmac )ctx;
+      if( hk->mctx.length != 0 ) return ak_false;
+      if( ak_hash_create_streebog256( &hctx ) != ak_error_ok ) return ak_false;
+      if( memcmp( &hk->ctx.data.sctx, &hctx.data.sctx, sizeof( struct streebog )) != 0 )
+        result = ak_false;
+      ak_hash_destroy( &hctx );
+    }
+ return result;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/* многократно получаем контексты из пула, используем их и возвращаем обратно */
+ static bool_t test_key_pool( const char *name, ak_uint8 *out )
+{
+  size_t idx = 0;
+  struct key_pool pool;
+  ak_uint8 key[32], in[16], kbuf[32], dbuf[64];
+  ak_pointer ctx = NULL, first = NULL;
+  ak_oid oid = ak_oid_find_by_name( name );
+  bool_t result = ak_true;
+  clock_t time;
+
+  if( ak_key_pool_create( &pool, oid, 4 ) != ak_error_ok ) return ak_false;
+  time = clock();
+  for( idx = 0; idx < keys_count; idx++ ) {
+     memset( key, (int)idx, sizeof( key ));
+     memset( in, (int)( idx >> 8 ), sizeof( in ));
+     if(( ctx = ak_key_pool_get( &pool )) == NULL ) { result = ak_false; break; }
+     if( first == NULL ) first = ctx;
+      else if( ctx != first ) result = ak_false; /* контекст должен использоваться повторно */
+     if( oid->engine == block_cipher ) {
+       ak_bckey_set_key( ctx, key, sizeof( key ));
+       ak_bckey_encrypt_ecb( ctx, in, out+16*idx, sizeof( in ));
+       memcpy( dbuf, (( ak_bckey )ctx)->key.data, sizeof( dbuf ));
+     } else {
+         ak_hmac_set_key( ctx, key, sizeof( key ));
+         ak_hmac_ptr( ctx, in, sizeof( in ), out+16*idx, 16 );
+        /* оставляем в контексте незавершенное вычисление */
+         if( idx == 0 ) {
+           ak_hmac_clean( ctx );
+           ak_hmac_update( ctx, in, sizeof( in ));
+         }
+       }
+     memcpy( kbuf, (( ak_skey )ctx)->key, sizeof( kbuf ));
+     ak_key_pool_put( &pool, ctx );
+     if( !test_key_pool_wiped( oid, ctx, kbuf, dbuf )) {
+       printf("key material is left in pooled context of %s\n", name );
+       result = ak_false;
+     }
+  }
+  time = clock() - time;
+  printf("%u keys of %s from pool (%f sec)\n", keys_count, name,
+                                                        (double) time / (double) CLOCKS_PER_SEC );
+  ak_key_pool_destroy( &pool );
+ return result;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/* искажение ключа должно обнаруживаться не позднее, чем через icode_check_interval обращений */
+ static bool_t test_icode_interval( void )
+{
+  size_t idx = 0;
+  struct bckey key;
+  ak_uint8 value[32], in[16], out[16];
+  bool_t result = ak_true;
+
+  memset( value, 0x11, sizeof( value ));
+  memset( in, 0, sizeof( in ));
+  ak_libakrypt_set_option( "icode_check_interval", 4 );
+  if( ak_bckey_create_kuznechik( &key ) != ak_error_ok ) return ak_false;
+  ak_bckey_set_key( &key, value, sizeof( value ));
+
+ /* первое обращение проверяет контрольную сумму, следующие три ее не проверяют */
+  if( ak_bckey_encrypt_ecb( &key, in, out, sizeof( in )) != ak_error_ok ) result = ak_false;
+  key.key.key[0] ^= 0x01;
+  for( idx = 0; idx < 3; idx++ )
+     if( ak_bckey_encrypt_ecb( &key, in, out, sizeof( in )) != ak_error_ok ) result = ak_false;
+  if( ak_bckey_encrypt_ecb( &key, in, out, sizeof( in )) == ak_error_ok ) result = ak_false;
+  ak_error_set_value( ak_error_ok );
+
+  ak_bckey_destroy( &key );
+  ak_libakrypt_set_option( "icode_check_interval", 1 );
+  printf("key integrity check with interval 4: %s\n", result ? "Ok" : "Wrong" );
+ return result;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/* ключи, присвоенные контекстам пакетно, должны совпадать с ключами, вырабатываемыми по одному */
+ static bool_t test_kdf_tree( struct bckey *keys, ak_uint8 *out, ak_uint8 *out2 )
+{
+  size_t idx = 0;
+  struct kdf_tree tree;
+  ak_uint8 key[32], in[16];
+  ak_pointer *contexts = malloc( keys_count*sizeof( ak_pointer ));
+  ak_uint64 masks[3] = { 0xffffffff00000000LL, 0xfffffffffff80000LL, 0xffffffffffffffc0LL };
+  bool_t result = ak_true;
+  clock_t time;
+
+  if( contexts == NULL ) return ak_false;
+  memset( key, 0x5a, sizeof( key ));
+  memset( in, 0, sizeof( in ));
+  if( ak_kdf_tree_create( &tree, key, sizeof( key ), masks, 3 ) != ak_error_ok ) {
+    free( contexts );
+    return ak_false;
+  }
+  for( idx = 0; idx < keys_count; idx++ ) {
+     ak_bckey_create_kuznechik( keys+idx );
+     contexts[idx] = keys+idx;
+  }
+
+  time = clock();
+  if( ak_kdf_tree_set_keys( &tree, 0x7ffc0, contexts, keys_count ) != ak_error_ok ) result = ak_false;
+  time = clock() - time;
+  printf("%u derived keys of kuznechik (%f sec): ", keys_count,
+                                                         (double) time / (double) CLOCKS_PER_SEC );
+  for( idx = 0; idx < keys_count; idx++ ) {
+     ak_bckey_encrypt_ecb( keys+idx, in, out+16*idx, sizeof( in ));
+     ak_bckey_destroy( keys+idx );
+  }
+  for( idx = 0; idx < keys_count; idx++ ) {
+     ak_kdf_tree_get_key( &tree, 0x7ffc0+idx, key, sizeof( key ));
+     ak_bckey_create_kuznechik( keys+idx );
+     ak_bckey_set_key( keys+idx, key, sizeof( key ));
+     ak_bckey_encrypt_ecb( keys+idx, in, out2+16*idx, sizeof( in ));
+     ak_bckey_destroy( keys+idx );
+  }
+  if( memcmp( out, out2, 16*keys_count ) != 0 ) result = ak_false;
+  printf("%s\n", result ? "Ok" : "Wrong" );
+
+  ak_kdf_tree_destroy( &tree );
+  free( contexts );
+ return result;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ int main( void )
+{
+  size_t idx = 0;
+  double atime, mtime;
+  int result = EXIT_SUCCESS;
+  struct bckey *keys = malloc( keys_count*sizeof( struct bckey ));
+  ak_uint8 *arena = malloc( 16*keys_count ), *heap = malloc( 16*keys_count );
+
+  if(( keys == NULL ) || ( arena == NULL ) || ( heap == NULL )) return EXIT_FAILURE;
+  if( !ak_libakrypt_create( ak_function_log_stderr )) return ak_libakrypt_destroy();
+
+ /* ключи размещаются в арене */
+  ak_libakrypt_set_option( "use_locked_memory", 1 );
+  if(( atime = test_create_keys( keys, arena, arena_policy )) < 0 ) {
+    printf("incorrect key creation in memory arena\n");
+    result = EXIT_FAILURE;
+    goto exlab;
+  }
+ /* все ключи должны располагаться в различных фрагментах памяти */
+  for( idx = 1; idx < keys_count; idx++ )
+     if( keys[idx].key.key == keys[idx-1].key.key ) result = EXIT_FAILURE;
+  for( idx = 0; idx < keys_count; idx++ ) ak_bckey_destroy( keys+idx );
+
+ /* ключи размещаются в памяти, выделенной malloc() */
+  ak_libakrypt_set_option( "use_locked_memory", 0 );
+  if(( mtime = test_create_keys( keys, heap, malloc_policy )) < 0 ) {
+    printf("incorrect key creation with malloc\n");
+    result = EXIT_FAILURE;
+    goto exlab;
+  }
+  for( idx = 0; idx < keys_count; idx++ ) ak_bckey_destroy( keys+idx );
+  ak_libakrypt_set_option( "use_locked_memory", 1 );
+
+  printf("%u keys created in arena (%f sec) and with malloc (%f sec): ",
+                                                         keys_count, atime, mtime );
+  if(( result == EXIT_SUCCESS ) && ( memcmp( arena, heap, 16*keys_count ) == 0 )) printf("Ok\n");
+   else { printf("Wrong\n"); result = EXIT_FAILURE; }
+
+ /* повторно используемые контексты должны давать те же результаты */
+  if(( test_key_pool( "kuznechik", heap ) != ak_true ) ||
+                                               ( memcmp( arena, heap, 16*keys_count ) != 0 )) {
+    printf("Wrong results for key pool\n");
+    result = EXIT_FAILURE;
+  }
+  if( test_key_pool( "hmac-streebog256", heap ) != ak_true ) {
+    printf("Wrong results for key pool\n");
+    result = EXIT_FAILURE;
+  }
+  if( test_icode_interval() != ak_true ) result = EXIT_FAILURE;
+  if( test_kdf_tree( keys, arena, heap ) != ak_true ) result = EXIT_FAILURE;
+
+  exlab:
+  free( keys ); free( arena ); free( heap );
+  ak_libakrypt_destroy();
+ return result;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                                                                                  test-skey01.c  */
+/* ----------------------------------------------------------------------------------------------- */
@@ -0,0 +1,122 @@
+/* ----------------------------------------------------------------------------------------------- */
+/* Тестовый пример, иллюстрирующий пакетную проверку электронных подписей (ГОСТ Р 34.10-2012).
+   Результаты пакетной обработки сравниваются с последовательным вызовом функций
+   ak_verifykey_verify_hash() и ak_verifykey_verify_ptr().
+
+   test-verify-batch.c                                                                             */
+/* ----------------------------------------------------------------------------------------------- */
+
+ #include <time.h>
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <libakrypt.h>
+
+/* количество задач в пакете (не кратно количеству одновременно обрабатываемых задач) */
+ #define tasks_count (43)
+/* количество используемых ключей */
+ #define keys_count (3)
+
+ int main( void )
+{
+  clock_t time;
+  size_t idx = 0, threads = 0;
+  int result = EXIT_SUCCESS;
+  struct random generator;
+  struct signkey sk[keys_count];
+  struct verifykey pk[keys_count];
+  struct verify_task tasks[tasks_count];
+  bool_t check[tasks_count];
+  ak_uint8 messages[tasks_count][40], hashes[tasks_count][64], signs[tasks_count][128];
+  ak_wcurve curves[keys_count] = {
+    ( ak_wcurve ) &id_tc26_gost_3410_2012_256_paramSetA,
+    ( ak_wcurve ) &id_tc26_gost_3410_2012_512_paramSetA,
+    ( ak_wcurve ) &id_rfc4357_gost_3410_2001_paramSetA
+  };
+
+ /* инициализируем библиотеку */
+  if( !ak_libakrypt_create( ak_function_log_stderr )) return ak_libakrypt_destroy();
+  if( ak_random_create_lcg( &generator ) != ak_error_ok ) return ak_libakrypt_destroy();
+
+ /* создаем ключи; для одного из открытых ключей разрешаем использование таблицы */
+  for( idx = 0; idx < keys_count; idx++ ) {
+     ak_signkey_create( sk+idx, curves[idx] );
+     ak_signkey_set_key_random( sk+idx, &generator );
+     ak_verifykey_create_from_signkey( pk+idx, sk+idx );
+  }
+  ak_verifykey_set_precomputation( pk+2, ak_true );
+
+ /* формируем задачи: подписываем сообщения, часть подписей искажаем */
+  for( idx = 0; idx < tasks_count; idx++ ) {
+     size_t kdx = idx%keys_count, hsize = 8*curves[kdx]->size;
+
+     memset( messages[idx], (int)idx, sizeof( messages[idx] ));
+     tasks[idx].key = pk+kdx;
+     tasks[idx].sign = signs[idx];
+     if( idx&1 ) { /* подписываем хеш-код */
+       ak_random_ptr( &generator, hashes[idx], hsize );
+       ak_signkey_sign_hash( sk+kdx, &generator, hashes[idx], hsize, signs[idx], 2*hsize );
+       tasks[idx].hash = hashes[idx];
+       tasks[idx].data = NULL;
+       tasks[idx].size = hsize;
+     } else { /* подписываем сообщение */
+         ak_signkey_sign_ptr( sk+kdx, &generator, messages[idx], 1+idx%40, signs[idx], 2*hsize );
+         tasks[idx].hash = NULL;
+         tasks[idx].data = messages[idx];
+         tasks[idx].size = 1+idx%40;
+       }
+     if( idx%5 == 3 ) signs[idx][idx%( 2*hsize )] ^= 0x10;
+     if( idx%7 == 6 ) memset( signs[idx], 0, hsize ); /* s = 0 */
+
+     if( idx&1 ) check[idx] = ak_verifykey_verify_hash( pk+kdx, hashes[idx], hsize, signs[idx] );
+      else check[idx] = ak_verifykey_verify_ptr( pk+kdx, messages[idx], 1+idx%40, signs[idx] );
+  }
+  ak_error_set_value( ak_error_ok );
+
+ /* выполняем пакетную обработку в одном и нескольких потоках */
+  for( threads = 1; threads < 5; threads += 3 ) {
+     for( idx = 0; idx < tasks_count; idx++ ) tasks[idx].result = !check[idx];
+     time = clock();
+     if( ak_verifykey_verify_batch( tasks, tasks_count, threads ) != ak_error_ok ) {
+       printf("incorrect batch verification\n");
+       result = EXIT_FAILURE;
+       goto exlab;
+     }
+     time = clock() - time;
+     printf("batch of %u tasks, threads: %u (%f sec): ", tasks_count,
+                              (unsigned int) threads, (double) time / (double) CLOCKS_PER_SEC );
+     for( idx = 0; idx < tasks_count; idx++ )
+        if( tasks[idx].result != check[idx] ) break;
+     if( idx < tasks_count ) {
+       printf("Wrong (task %u)\n", (unsigned int) idx );
+       result = EXIT_FAILURE;
+     } else printf("Ok\n");
+  }
+
+ /* некорректная задача не должна влиять на остальные */
+  tasks[2].size = 7;
+  tasks[2].hash = hashes[2];
+  if( ak_verifykey_verify_batch( tasks, tasks_count, 1 ) == ak_error_ok ) {
+    printf("batch with wrong task is accepted\n");
+    result = EXIT_FAILURE;
+  }
+  for( idx = 0; idx < tasks_count; idx++ ) {
+     if( idx == 2 ) {
+       if(( tasks[idx].error == ak_error_ok ) || tasks[idx].result ) result = EXIT_FAILURE;
+       continue;
+     }
+     if(( tasks[idx].error != ak_error_ok ) || ( tasks[idx].result != check[idx] )) {
+       printf("wrong result for task %u\n", (unsigned int) idx );
+       result = EXIT_FAILURE;
+     }
+  }
+
+  exlab:
+  for( idx = 0; idx < keys_count; idx++ ) {
+     ak_signkey_destroy( sk+idx );
+     ak_verifykey_destroy( pk+idx );
+  }
+  ak_random_destroy( &generator );
+  ak_libakrypt_destroy();
+ return result;
+}
@@ -0,0 +1,102 @@
+/* ----------------------------------------------------------------------------------------------- */
+/* Тестовый пример, в котором для всех эллиптических кривых, доступных через механизм OID,
+   сравниваются результаты вычисления кратных точек различными способами:
+   методом фиксированного окна (функция ak_wpoint_pow()), с помощью лесенки Монтгомери
+   (функция ak_wpoint_pow_montgomery()) и с помощью предвычисленных таблиц кратных точек
+   (функция ak_wpoint_pow_base()).
+   Также проверяется одновременное вычисление суммы кратных точек (функции ak_wpoint_pow_sum()
+   и ak_wpoint_pow_sum_table()).
+
+   test-wpoint-pow.c                                                                               */
+/* ----------------------------------------------------------------------------------------------- */
+
+ #include <stdio.h>
+ #include <stdlib.h>
+ #include <string.h>
+ #include <libakrypt.h>
+
+/* количество случайных вычетов, проверяемых для каждой кривой */
+ #define tests_count (32)
+
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t test_wpoint_is_equal( ak_wpoint wp, ak_wpoint wq, ak_wcurve wc )
+{
+  ak_wpoint_reduce( wp, wc );
+  ak_wpoint_reduce( wq, wc );
+  if( ak_mpzn_cmp( wp->x, wq->x, wc->size ) != 0 ) return ak_false;
+  if( ak_mpzn_cmp( wp->y, wq->y, wc->size ) != 0 ) return ak_false;
+  if( ak_mpzn_cmp( wp->z, wq->z, wc->size ) != 0 ) return ak_false;
+ return ak_true;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ int main( void )
+{
+  size_t idx;
+  ak_oid oid = NULL;
+  ak_uint64 *qtable = NULL;
+  struct random generator;
+  struct wpoint wp, wq, wt;
+  ak_mpzn512 k, t;
+  int result = EXIT_SUCCESS;
+
+ /* инициализируем библиотеку */
+  if( !ak_libakrypt_create( ak_function_log_stderr )) return ak_libakrypt_destroy();
+  if( ak_random_create_lcg( &generator ) != ak_error_ok ) {
+    ak_libakrypt_destroy();
+    return EXIT_FAILURE;
+  }
+
+  oid = ak_oid_find_by_mode( wcurve_params );
+  while( oid != NULL ) {
+    size_t errors = 0;
+    ak_wcurve wc = ( ak_wcurve )oid->data;
+
+    for( idx = 0; idx < tests_count; idx++ ) {
+       switch( idx ) {
+         case 0: ak_mpzn_set_ui( k, wc->size, 0 ); break;
+         case 1: ak_mpzn_set_ui( k, wc->size, 1 ); break;
+         case 2: ak_mpzn_set( k, wc->q, wc->size ); break; /* [q]P = O */
+         case 3: ak_mpzn_set( k, wc->q, wc->size );        /* [q-1]P = -P */
+                 k[0]--;
+                 break;
+         case 4: memset( k, 0xff, sizeof( k )); break;     /* значение, превышающее q */
+         default: ak_random_ptr( &generator, k, wc->size*sizeof( ak_uint64 ));
+                  if( idx&1 ) k[wc->size-1] = 0; /* старшие разряды вычета равны нулю */
+       }
+       ak_wpoint_pow( &wp, &wc->point, k, wc->size, wc );
+       ak_wpoint_pow_montgomery( &wq, &wc->point, k, wc->size, wc );
+       if( !test_wpoint_is_equal( &wp, &wq, wc )) errors++;
+       ak_wpoint_pow_base( &wq, k, wc->size, wc );
+       if( !test_wpoint_is_equal( &wp, &wq, wc )) errors++;
+
+      /* точка Q = [t]P и сумма [k]P + [k]Q = [k]P + [t]([k]P) */
+       ak_random_ptr( &generator, t, wc->size*sizeof( ak_uint64 ));
+       ak_wpoint_pow( &wt, &wc->point, t, wc->size, wc );
+       ak_wpoint_reduce( &wt, wc );
+       ak_wpoint_pow( &wq, &wt, k, wc->size, wc );
+       ak_wpoint_add( &wq, &wp, wc );
+       ak_wpoint_pow_sum( &wp, k, &wt, k, wc->size, wc );
+       if( !test_wpoint_is_equal( &wp, &wq, wc )) errors++;
+       if( idx < 4 ) { /* таблица кратных точки Q */
+         if(( qtable = ak_wpoint_table_new( &wt, wc )) == NULL ) errors++;
+          else {
+            ak_wpoint_pow_sum_table( &wp, k, k, qtable, wc->size, wc );
+            if( !test_wpoint_is_equal( &wp, &wq, wc )) errors++;
+            free( qtable );
+          }
+       }
+    }
+    printf("%s: %s\n", oid->name[0], errors ? "Wrong" : "Ok" );
+    if( errors ) result = EXIT_FAILURE;
+    oid = ak_oid_findnext_by_mode( oid, wcurve_params );
+  }
+
+  ak_random_destroy( &generator );
+  ak_libakrypt_destroy();
+ return result;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                                                                              test-wpoint-pow.c  */
+/* ----------------------------------------------------------------------------------------------- */
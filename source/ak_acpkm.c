@@ -154,7 +154,7 @@
     return ak_error_message( ak_error_wrong_block_cipher_length,
                                __func__ , "the length of section is not divided by block length" );
  /* проверяем целостность ключа */
-  if( bkey->key.check_icode( &bkey->key ) != ak_true )
+  if( ak_skey_check_icode_periodic( &bkey->key ) != ak_true )
     return ak_error_message( ak_error_wrong_key_icode, __func__,
                                                   "incorrect integrity code of secret key value" );
  /* проверяем размер синхропосылки */
@@ -176,15 +176,16 @@
                                         ak_oid oid, const char *password, const size_t pass_size )
 {
   ak_uint8 salt[32]; /* случайное значение для генерации ключа шифрования контента */
-  struct random generator; /* генератор ПДСЧ */
+  ak_random generator = NULL; /* генератор ПДСЧ */
   int error = ak_error_ok;
   ak_asn1 asn1 = NULL, asn2 = NULL, asn3 = NULL;
 
-  if(( error = ak_random_create_lcg(  &generator )) != ak_error_ok )
-    return ak_error_message( error, __func__, "incorrect creation of random generator");
+  if(( generator = ak_random_get_thread_generator()) == NULL )
+    return ak_error_message( ak_error_get_value(), __func__, "incorrect creation of random generator");
 
   memset( salt, 0, sizeof( salt ));
-  ak_random_ptr( &generator, salt, sizeof( salt ));
+  if(( error = ak_random_ptr( generator, salt, sizeof( salt ))) != ak_error_ok )
+    return ak_error_message( error, __func__, "incorrect generation of random salt");
 
   if(( error = ak_bckey_create_key_pair_from_password( ekey, ikey, oid, password, pass_size,
       salt, sizeof( salt ), (size_t) ak_libakrypt_get_option_by_name( "pbkdf2_iteration_count" )))
@@ -447,7 +448,10 @@
 
    /* формируем iv */
     memset( ptr, 0, len );
-    ak_random_ptr( &ekey->key.generator, ptr, ivsize );
+    if(( error = ak_random_ptr( ak_random_get_thread_generator(), ptr, ivsize )) != ak_error_ok ) {
+      ak_asn1_delete( content );
+      return ak_error_message( error, __func__, "incorrect generation of initial vector" );
+    }
    /* меняем маску секретного ключа */
     skey->set_mask( skey );
    /* копируем данные:
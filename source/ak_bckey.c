@@ -15,6 +15,7 @@
     - bkey.decrypt -- алгоритм расшифрования одного блока
     - bkey.shedule_keys -- алгоритм развертки ключа и генерации раундовых ключей
     - bkey.delete_keys -- функция удаления раундовых ключей
+    - bkey.wipe_keys -- функция очистки раундовых ключей без освобождения памяти
 
     Следующие поля принимают значения по-умолчанию
     - bkey.key.data -- указатель на служебную область памяти
@@ -54,6 +55,7 @@
   bkey->decrypt =       NULL;
   bkey->schedule_keys = NULL;
   bkey->delete_keys =   NULL;
+  bkey->wipe_keys =     NULL;
 
  return ak_error_ok;
 }
@@ -88,6 +90,7 @@
   bkey->decrypt =       NULL;
   bkey->schedule_keys = NULL;
   bkey->delete_keys =   NULL;
+  bkey->wipe_keys =     NULL;
 
  return error;
 }
@@ -203,7 +206,8 @@
     После присвоения значения ключа производится его маскирование и выработка контрольной суммы.
 
     @param bkey Контекст ключа блочного алгоритма шифрования.
-    @param generator Контекст генератора случайных (псевдослучайных) чисел.
+    @param generator Контекст генератора случайных (псевдослучайных) чисел
+    (значение NULL означает использование генератора текущего потока).
 
     @return Функция возвращает код ошибки. В случае успеха возвращается \ref ak_error_ok.          */
 /* ----------------------------------------------------------------------------------------------- */
@@ -214,8 +218,6 @@
  /* проверяем входные данные */
   if( bkey == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
                                                         "using null pointer to secret key context" );
-  if( generator == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
-                                                          "using null pointer to random generator" );
  /* присваиваем ключевой буффер */
   if(( error = ak_skey_set_key_random( &bkey->key, generator )) != ak_error_ok )
     return ak_error_message( error, __func__ , "incorrect assigning of random key data" );
@@ -367,7 +369,7 @@
                             __func__ , "the length of input data is not divided by block length" );
 
  /* проверяем целостность ключа */
-  if( bkey->key.check_icode( &bkey->key ) != ak_true )
+  if( ak_skey_check_icode_periodic( &bkey->key ) != ak_true )
     return ak_error_message( ak_error_wrong_key_icode,
                                         __func__, "incorrect integrity code of secret key value" );
  /* уменьшаем значение ресурса ключа */
@@ -424,7 +426,7 @@
                             __func__ , "the length of input data is not divided by block length" );
 
  /* проверяем целостность ключа */
-  if( bkey->key.check_icode( &bkey->key ) != ak_true )
+  if( ak_skey_check_icode_periodic( &bkey->key ) != ak_true )
     return ak_error_message( ak_error_wrong_key_icode,
                                         __func__, "incorrect integrity code of secret key value" );
  /* уменьшаем значение ресурса ключа */
@@ -524,7 +526,7 @@
                                     __func__, "using secret key context with undefined key value" );
 
  /* проверяем целостность ключа */
-  if( bkey->key.check_icode( &bkey->key ) != ak_true )
+  if( ak_skey_check_icode_periodic( &bkey->key ) != ak_true )
     return ak_error_message( ak_error_wrong_key_icode, __func__,
                                                    "incorrect integrity code of secret key value" );
  /* уменьшаем значение ресурса ключа */
@@ -657,7 +659,7 @@
                              __func__ , "the length of input data is not divided by block length" );
 
   /* проверяем целостность ключа */
-   if( bkey->key.check_icode( &bkey->key ) != ak_true )
+   if( ak_skey_check_icode_periodic( &bkey->key ) != ak_true )
      return ak_error_message( ak_error_wrong_key_icode,
                                          __func__, "incorrect integrity code of secret key value" );
   /* уменьшаем значение ресурса ключа */
@@ -731,7 +733,7 @@
                             __func__ , "the length of input data is not divided by block length" );
 
  /* проверяем целостность ключа */
-  if( bkey->key.check_icode( &bkey->key ) != ak_true )
+  if( ak_skey_check_icode_periodic( &bkey->key ) != ak_true )
     return ak_error_message( ak_error_wrong_key_icode,
                                         __func__, "incorrect integrity code of secret key value" );
  /* уменьшаем значение ресурса ключа */
@@ -802,7 +804,7 @@
   if(( oc < 0 ) || ( oc > 1 )) return ak_error_message( ak_error_wrong_option, __func__,
                                                "wrong value for \"openssl_compability\" option" );
  /* проверяем целостность ключа */
-  if( bkey->key.check_icode( &bkey->key ) != ak_true )
+  if( ak_skey_check_icode_periodic( &bkey->key ) != ak_true )
     return ak_error_message( ak_error_wrong_key_icode, __func__,
                                                    "incorrect integrity code of secret key value" );
  /* уменьшаем значение ресурса ключа */
@@ -900,7 +902,7 @@
    if(( oc < 0 ) || ( oc > 1 )) return ak_error_message( ak_error_wrong_option, __func__,
                                                  "wrong value for \"openssl_compability\" option" );
   /* проверяем целостность ключа */
-   if( bkey->key.check_icode( &bkey->key ) != ak_true )
+   if( ak_skey_check_icode_periodic( &bkey->key ) != ak_true )
      return ak_error_message( ak_error_wrong_key_icode, __func__,
                                                     "incorrect integrity code of secret key value" );
   /* уменьшаем значение ресурса ключа */
@@ -994,7 +996,7 @@
    if(( oc < 0 ) || ( oc > 1 )) return ak_error_message( ak_error_wrong_option, __func__,
                                                  "wrong value for \"openssl_compability\" option" );
   /* проверяем целостность ключа */
-   if( bkey->key.check_icode( &bkey->key ) != ak_true )
+   if( ak_skey_check_icode_periodic( &bkey->key ) != ak_true )
      return ak_error_message( ak_error_wrong_key_icode, __func__,
                                                     "incorrect integrity code of secret key value" );
   /* уменьшаем значение ресурса ключа */
@@ -426,7 +426,6 @@
 {
   struct file fs;
   int error = ak_error_ok;
-  struct random generator;
   size_t memsize, iter = ak_libakrypt_get_option_by_name( "pbkdf2_iteration_count" );
   struct bckey ekey, ikey;
   size_t i, j, blocks, lblocks, ltail;
@@ -441,9 +440,8 @@
     - один октет - размер элемента поля (bkey->count)
     - четыре октета - размерность матрицы (bkey->size) */
 
-  if(( error = ak_random_create_lcg( &generator )) != ak_error_ok )
-    return ak_error_message( error, __func__, "incorrect creation of random number generator");
-  ak_random_ptr( &generator, iv, sizeof( iv ));
+  if(( error = ak_random_ptr( ak_random_get_thread_generator(), iv, 8 )) != ak_error_ok )
+    return ak_error_message( error, __func__, "incorrect generation of initial vector");
   iv[8]  = (iter >> 8)&0xFF;
   iv[9]  = iter&0xFF; /* помещаем число итераций в big-endian формате */
   iv[10] = (ak_uint8) bkey->type;    /* сохраняем тип ключа */
@@ -452,7 +450,6 @@
   iv[13] = ( bkey->size >> 16)&0xFF;
   iv[14] = ( bkey->size >>  8)&0xFF;
   iv[15] = bkey->size&0xFF;
-  ak_random_destroy( &generator );
 
  /* вычисляем размер ключевых данных */
   if( bkey->type == blom_matrix_key ) memsize = (bkey->size)*(bkey->size)*(bkey->count);
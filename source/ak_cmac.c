@@ -44,7 +44,7 @@
   if( !out_size ) return ak_error_message( ak_error_zero_length, __func__,
                                                             "using zero length of result buffer" );
  /* проверяем целостность ключа */
-  if( bkey->key.check_icode( &bkey->key ) != ak_true )
+  if( ak_skey_check_icode_periodic( &bkey->key ) != ak_true )
     return ak_error_message( ak_error_wrong_key_icode, __func__,
                                                   "incorrect integrity code of secret key value" );
 
@@ -199,7 +199,7 @@
   if(( size%bkey->bsize ) != 0 ) return ak_error_message( ak_error_wrong_length, __func__,
                                                                 "using a data with wrong length" );
  /* проверяем целостность ключа */
-  if( bkey->key.check_icode( &bkey->key ) != ak_true )
+  if( ak_skey_check_icode_periodic( &bkey->key ) != ak_true )
     return ak_error_message( ak_error_wrong_key_icode, __func__,
                                                   "incorrect integrity code of secret key value" );
 
@@ -353,6 +353,80 @@
 
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция считывает файл фрагментами, длина которых кратна длине блока алгоритма шифрования,
+    и последовательно вызывает функции ak_bckey_cmac_clean(), ak_bckey_cmac_update()
+    и ak_bckey_cmac_finalize(). При этом последний, возможно неполный, блок файла всегда
+    передается в функцию ak_bckey_cmac_finalize().
+
+    \note Имитовставка для файла нулевой длины не вычисляется, поскольку алгоритм
+    ГОСТ Р 34.13-2015 не определен для пустой последовательности.
+
+    \param bkey Контекст секретного ключа блочного алгоритма шифрования.
+    \param filename Имя файла, для которого вычисляется имитовставка.
+    \param out Область памяти, куда будет помещен результат. Память должна быть заранее выделена.
+    \param out_size Ожидаемый размер имитовставки.
+    \return В случае успеха функция возвращает ak_error_ok. В случае возникновения ошибки
+    возвращается ее код.                                                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_bckey_cmac_file( ak_bckey bkey, const char *filename, ak_pointer out,
+                                                                           const size_t out_size )
+{
+  struct file file;
+  int error = ak_error_ok;
+  ak_int64 total = 0;
+  size_t len = 0, qcnt = 0, block_size = 65536;
+  ak_uint8 *localbuffer = NULL; /* место для локального считывания информации */
+
+ /* выполняем необходимые проверки */
+  if( bkey == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                        "using null pointer to block cipher key" );
+  if( filename == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                                "use a null pointer to filename" );
+  if(( error = ak_bckey_cmac_clean( bkey )) != ak_error_ok )
+    return ak_error_message( error, __func__, "incorrect cleaning of internal state" );
+
+  if(( error = ak_file_open_to_read( &file, filename )) != ak_error_ok )
+    return ak_error_message_fmt( error, __func__, "incorrect access to file %s", filename );
+  if( !file.size ) {
+    ak_file_close( &file );
+    return ak_error_message_fmt( ak_error_zero_length, __func__,
+                                                         "using a file %s with zero length", filename );
+  }
+
+ /* длина фрагмента кратна длине блока и не меньше рекомендуемой для файловой системы */
+  block_size = ak_max( block_size, ( size_t )file.blksize );
+  block_size -= block_size%bkey->bsize;
+  if(( localbuffer = ( ak_uint8 * ) ak_aligned_malloc( block_size )) == NULL ) {
+    ak_file_close( &file );
+    return ak_error_message( ak_error_out_of_memory, __func__ ,
+                                                      "memory allocation error for local buffer" );
+  }
+
+ /* обрабатываем все фрагменты, кроме последнего */
+  while(( len = ( size_t ) ak_file_read( &file, localbuffer, block_size )) == block_size ) {
+    if(( total += ( ak_int64 )len ) >= file.size ) break;
+    if(( error = ak_bckey_cmac_update( bkey, localbuffer, len )) != ak_error_ok ) goto labex;
+  }
+  if(( len == 0 ) || ( len > block_size )) {
+    ak_error_message_fmt( error = ak_error_read_data, __func__,
+                                                         "incorrect reading of file %s", filename );
+    goto labex;
+  }
+
+ /* последний фрагмент содержит не менее одного октета, передаваемого в функцию завершения */
+  qcnt = ( len - 1 )/bkey->bsize;
+  if( qcnt && (( error = ak_bckey_cmac_update( bkey, localbuffer,
+                                                  qcnt*bkey->bsize )) != ak_error_ok )) goto labex;
+  error = ak_bckey_cmac_finalize( bkey, localbuffer + qcnt*bkey->bsize,
+                                                           len - qcnt*bkey->bsize, out, out_size );
+  labex:
+   ak_bckey_cmac_clean( bkey );
+   ak_file_close( &file );
+   free( localbuffer );
+ return error;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Функция реализует последовательную комбинацию режимов из ГОСТ Р 34.12-2015. В начале
     вычисляется имитовставка от объединения ассоциированных данных и
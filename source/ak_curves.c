@@ -4,7 +4,7 @@
 /*  Файл ak_curves.с                                                                               */
 /*  - содержит реализацию функций для работы с эллиптическими кривыми.                             */
 /* ----------------------------------------------------------------------------------------------- */
- #include <libakrypt.h>
+ #include <libakrypt-internal.h>
 
 /* ----------------------------------------------------------------------------------------------- */
 #ifdef AK_HAVE_STRING_H
@@ -15,6 +15,12 @@
 #ifdef AK_HAVE_STRINGS_H
  #include <strings.h>
 #endif
+#ifdef AK_HAVE_STDLIB_H
+ #include <stdlib.h>
+#endif
+#ifdef AK_HAVE_PTHREAD_H
+ #include <pthread.h>
+#endif
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! Функция вычисляет величину \f$\Delta \equiv -16(4a^3 + 27b^2) \pmod{p} \f$, зависящую
@@ -30,27 +36,27 @@
  /* определяем константы 4 и 27 в представлении Монтгомери */
   ak_mpzn_set_ui( d, ec->size, 4 );
   ak_mpzn_set_ui( s, ak_mpznmax_size, 27 );
-  ak_mpzn_mul_montgomery( d, d, ec->r2, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( s, s, ec->r2, ec->p, ec->n, ec->size );
+  ec->mul( d, d, ec->r2, ec->p, ec->n, ec->size );
+  ec->mul( s, s, ec->r2, ec->p, ec->n, ec->size );
 
  /* вычисляем 4a^3 (mod p) значение в представлении Монтгомери */
-  ak_mpzn_mul_montgomery( d, d, ec->a, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( d, d, ec->a, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( d, d, ec->a, ec->p, ec->n, ec->size );
+  ec->mul( d, d, ec->a, ec->p, ec->n, ec->size );
+  ec->mul( d, d, ec->a, ec->p, ec->n, ec->size );
+  ec->mul( d, d, ec->a, ec->p, ec->n, ec->size );
 
  /* вычисляем значение 4a^3 + 27b^2 (mod p) в представлении Монтгомери */
-  ak_mpzn_mul_montgomery( s, s, ec->b, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( s, s, ec->b, ec->p, ec->n, ec->size );
+  ec->mul( s, s, ec->b, ec->p, ec->n, ec->size );
+  ec->mul( s, s, ec->b, ec->p, ec->n, ec->size );
   ak_mpzn_add_montgomery( d, d, s, ec->p, ec->size );
 
  /* определяем константу -16 в представлении Монтгомери и вычисляем D = -16(4a^3+27b^2) (mod p) */
   ak_mpzn_set_ui( s, ec->size, 16 );
   ak_mpzn_sub( s, ec->p, s, ec->size );
-  ak_mpzn_mul_montgomery( s, s, ec->r2, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( d, d, s, ec->p, ec->n, ec->size );
+  ec->mul( s, s, ec->r2, ec->p, ec->n, ec->size );
+  ec->mul( d, d, s, ec->p, ec->n, ec->size );
 
  /* возвращаем результат (в обычном представлении) */
-  ak_mpzn_mul_montgomery( d, d, one, ec->p, ec->n, ec->size );
+  ec->mul( d, d, one, ec->p, ec->n, ec->size );
 }
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -102,6 +108,115 @@
    else return ak_error_curve_order_parameters;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет единицу в представлении Монтгомери, т.е. вычет \f$ r \pmod{p} \f$, где
+    \f$ r = 2^{64\cdot size} \f$, как произведение Монтгомери числа 1 и константы
+    \f$ r^2 \pmod{p} \f$. В отличие от разности \f$ r - p \f$, результат является приведенным
+    вычетом для любого модуля \f$ p \f$, а не только для модуля с установленным старшим битом.
+
+    @param one Вычет, в который помещается вычисленное значение.
+    @param ec Эллиптическая кривая в форме Вейерштрасса.                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_wcurve_set_montgomery_one( ak_uint64 *one, ak_wcurve ec )
+{
+  ak_mpzn_set_ui( one, ec->size, 1 );
+  ec->mul( one, one, ec->r2, ec->p, ec->n, ec->size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                         эквивалентные скрученные кривые Эдвардса                                */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Параметры скрученной кривой Эдвардса, бирационально эквивалентной кривой в форме Вейерштрасса.
+
+    Кривая Эдвардса задается уравнением \f$ eu^2 + v^2 = 1 + du^2v^2 \f$, для всех
+    поддерживаемых кривых (рекомендации Р 50.1.114-2016) выполнено равенство \f$ e = 1 \f$.
+    Точка \f$ (u,v) \f$ кривой Эдвардса соответствует точке \f$ (x,y) \f$ кривой
+    \f$ y^2 = x^3 + ax + b \f$, где \f$ x = s(1+v)/(1-v) + t,\ y = s(1+v)/((1-v)u) \f$,
+    а константы \f$ s = (e-d)/4,\ t = (e+d)/6 \f$ удовлетворяют равенствам
+    \f$ a = s^2 - 3t^2,\ b = 2t^3 - ts^2 \f$. Все значения хранятся в представлении Монтгомери. */
+/* ----------------------------------------------------------------------------------------------- */
+ static const struct edwards_params {
+  /*! \brief Эквивалентная эллиптическая кривая в форме Вейерштрасса. */
+   const struct wcurve *wc;
+  /*! \brief Параметр \f$ d \f$ кривой Эдвардса. */
+   ak_uint64 d[ak_mpzn512_size];
+  /*! \brief Константа \f$ s \f$ бирационального отображения. */
+   ak_uint64 s[ak_mpzn512_size];
+  /*! \brief Константа \f$ t \f$ бирационального отображения. */
+   ak_uint64 t[ak_mpzn512_size];
+ } edwards_params[] = {
+  { &id_tc26_gost_3410_2012_256_paramSetA,
+    { 0x40c8687d966dd5b1LL, 0x1fb647d3f0757f77LL, 0xffda75588b970634LL, 0x845fa0e16716c1bbLL }, /* d */
+    { 0x2fcde5e09a6488c5LL, 0xf8126e0b03e2a022LL, 0x000962a9dd1a3e72LL, 0xdee817c7a63a4f91LL }, /* s */
+    { 0x8acc116a43bcf88cLL, 0x05490bf8a813953eLL, 0xaaa468e41743d65eLL, 0x6b65457ae683caf4LL }  /* t */
+  },
+  { &id_tc26_gost_3410_2012_512_paramSetC,
+    { 0x6515a5166d05caf7LL, 0xae6dc7d439a723d5LL, 0xdc1c74edcea76671LL, 0x853a44eed58ae3e5LL,
+      0xc84c79f64266472eLL, 0xa1a4bfeccd0cf540LL, 0xab899e4c73783aa1LL, 0xde66ec2f500fc692LL }, /* d */
+    { 0xa6ba96ba64be8cb4LL, 0x94648e0af196370aLL, 0x88f8e2c48c562663LL, 0x5eb16ec44a9d4706LL,
+      0xcdece1826f666e34LL, 0x9796d004ccbcc2afLL, 0x551d986ce321f157LL, 0x486644f42bfc0e5bLL }, /* s */
+    { 0xe62e462e6780f788LL, 0x9d124bf8b44685f8LL, 0xfa04be27a2713bbdLL, 0x163460d278ec7b50LL,
+      0x76b769a90b110bddLL, 0xf0461ffcccd77e35LL, 0x71ec450cbde95f1aLL, 0x2511275d3802a118LL }  /* t */
+  },
+  { NULL, { 0 }, { 0 }, { 0 }}
+ };
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! @param ec Эллиптическая кривая в форме Вейерштрасса.
+    @return Функция возвращает указатель на параметры эквивалентной скрученной кривой Эдвардса.
+    Если кривая не эквивалентна известной кривой Эдвардса, возвращается NULL.                     */
+/* ----------------------------------------------------------------------------------------------- */
+ static const struct edwards_params *ak_wcurve_get_edwards_params( ak_wcurve ec )
+{
+  const struct edwards_params *ed = edwards_params;
+
+  while( ed->wc != NULL ) {
+    if( ed->wc == ec ) return ed;
+    ed++;
+  }
+ return NULL;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция проверяет выполнение равенств \f$ 4s = 1-d,\ 6t = 1+d,\ a = s^2 - 3t^2,\
+    b = 2t^3 - ts^2 \f$, связывающих параметры кривой в форме Вейерштрасса и параметры
+    эквивалентной ей скрученной кривой Эдвардса.
+
+    @param ec Эллиптическая кривая в форме Вейерштрасса.
+    @param ed Параметры кривой Эдвардса.
+    @return Функция возвращает \ref ak_error_ok в случае, если параметры определены корректно.
+    В противном случае возвращается \ref ak_error_curve_not_supported.                            */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_wcurve_edwards_params_is_ok( ak_wcurve ec, const struct edwards_params *ed )
+{
+  ak_mpznmax one = ak_mpznmax_zero, u, v, w;
+  ak_uint64 *p = ec->p, n = ec->n;
+  const size_t size = ec->size;
+
+  ak_wcurve_set_montgomery_one( one, ec );
+  ak_mpzn_lshift_montgomery( u, ( ak_uint64 *)ed->s, p, size );
+  ak_mpzn_lshift_montgomery( u, u, p, size );
+  ak_mpzn_add_montgomery( u, u, ( ak_uint64 *)ed->d, p, size );          // u = 4s + d
+  if( ak_mpzn_cmp( u, one, size ) != 0 ) return ak_error_curve_not_supported;
+  ak_mpzn_lshift_montgomery( u, ( ak_uint64 *)ed->t, p, size );
+  ak_mpzn_add_montgomery( v, u, ( ak_uint64 *)ed->t, p, size );
+  ak_mpzn_lshift_montgomery( v, v, p, size );
+  ak_mpzn_sub_montgomery( v, v, ( ak_uint64 *)ed->d, p, size );          // v = 6t - d
+  if( ak_mpzn_cmp( v, one, size ) != 0 ) return ak_error_curve_not_supported;
+
+  ec->sqr( u, ( ak_uint64 *)ed->s, p, n, size );                          // u = s^2
+  ec->sqr( v, ( ak_uint64 *)ed->t, p, n, size );                          // v = t^2
+  ak_mpzn_lshift_montgomery( w, v, p, size );
+  ak_mpzn_add_montgomery( w, w, v, p, size );
+  ak_mpzn_sub_montgomery( w, u, w, p, size );
+  if( ak_mpzn_cmp( w, ec->a, size ) != 0 ) return ak_error_curve_not_supported;
+  ak_mpzn_lshift_montgomery( w, v, p, size );
+  ak_mpzn_sub_montgomery( w, w, u, p, size );
+  ec->mul( w, w, ( ak_uint64 *)ed->t, p, n, size );
+  if( ak_mpzn_cmp( w, ec->b, size ) != 0 ) return ak_error_curve_not_supported;
+ return ak_error_ok;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Функция принимает на вход контекст эллиптической кривой, заданной в короткой форме Вейерштрасса,
     и выполняет следующие математические проверки
@@ -113,7 +228,9 @@
      - проверяется, что фиксированная точка кривой, содержащаяся в контексте эллиптической кривой,
        действительно принадлежит эллиптической кривой,
      - проверяется, что порядок этой точки кривой равен простому числу \f$ q \f$,
-       содержащемуся в контексте эллиптической кривой.
+       содержащемуся в контексте эллиптической кривой,
+     - для кривых, эквивалентных скрученным кривым Эдвардса, проверяется корректность
+       параметров эквивалентной кривой.
 
      @param ec контекст структуры эллиптической кривой, содержащий в себе значения параметров.
      Константные значения структур, которые могут быть использованы библиотекой,
@@ -127,12 +244,22 @@
   ak_mpznmax temp;
   struct wpoint wp;
   const char *str = NULL;
+  const struct edwards_params *ed = NULL;
   int error = ak_error_ok;
 
  /* создали кривую и проверяем веоичину старшего коэффициента ее молуля */
   if( ec->p[ ec->size-1 ] < 0x100000000LL )
     return ak_error_message( ak_error_curve_prime_modulo, __func__ ,
                                            "using elliptic curve parameters with wrong module" );
+ /* проверяем, что функции арифметики Монтгомери соответствуют виду модуля */
+  if(( ec->mul == NULL ) || ( ec->sqr == NULL ))
+    return ak_error_message( ak_error_undefined_function, __func__ ,
+                                  "using elliptic curve parameters with undefined arithmetic" );
+  if((( ec->mul == ak_mpzn_mul_montgomery_pseudo_mersenne ) ||
+      ( ec->sqr == ak_mpzn_sqr_montgomery_pseudo_mersenne )) &&
+                                       ( ak_mpzn_is_pseudo_mersenne( ec->p, ec->size ) != ak_true ))
+    return ak_error_message( ak_error_curve_prime_modulo, __func__ ,
+                      "using pseudo-mersenne arithmetic with elliptic curve of general module" );
 
  /* проверяем соответствие данных в памяти их символьному представлению */
   if(( str = ak_mpzn_to_hexstr( ec->p, ec->size )) == NULL )
@@ -154,6 +281,11 @@
   if(( error = ak_wcurve_discriminant_is_ok( ec )) != ak_error_ok )
     return ak_error_message( ak_error_curve_discriminant, __func__ ,
                                        "using elliptic curve parameters with zero discriminant" );
+ /* проверяем параметры эквивалентной кривой Эдвардса, используемые при вычислении кратных точек */
+  if(( ed = ak_wcurve_get_edwards_params( ec )) != NULL )
+    if(( error = ak_wcurve_edwards_params_is_ok( ec, ed )) != ak_error_ok )
+      return ak_error_message( error, __func__ ,
+                                    "elliptic curve has wrong parameters of twisted Edwards curve" );
  /* теперь проверяем принадлежность точки кривой */
   if(( error = ak_wpoint_set( &wp, ec )) != ak_error_ok )
     return ak_error_message( error, __func__, "incorect asiigning a temporary point" );
@@ -182,10 +314,10 @@
   if( oid != NULL ) {
     ak_error_message_fmt( error, __func__, "elliptic curve: %s (oid: %s)",
                                                                        oid->name[0], oid->id[0] );
-    ak_mpzn_mul_montgomery( tmp, ec->a, one, ec->p, ec->n, ec->size );
+    ec->mul( tmp, ec->a, one, ec->p, ec->n, ec->size );
     ak_error_message_fmt( error, __func__, " a = %s",
                                      str = ak_mpzn_to_hexstr_alloc( tmp, ec->size )); free( str );
-    ak_mpzn_mul_montgomery( tmp, ec->b, one, ec->p, ec->n, ec->size );
+    ec->mul( tmp, ec->b, one, ec->p, ec->n, ec->size );
     ak_error_message_fmt( error, __func__, " b = %s",
                                      str = ak_mpzn_to_hexstr_alloc( tmp, ec->size )); free( str );
     ak_error_message_fmt( error, __func__, " b = %s",
@@ -235,9 +367,9 @@
 
   fprintf( fp, "\nparameters:\n");
 
-  ak_mpzn_mul_montgomery( tmp, ec->a, one, ec->p, ec->n, ec->size );
+  ec->mul( tmp, ec->a, one, ec->p, ec->n, ec->size );
   fprintf( fp, "  a =  0x%s\n", ak_mpzn_to_hexstr( tmp, ec->size ));
-  ak_mpzn_mul_montgomery( tmp, ec->b, one, ec->p, ec->n, ec->size );
+  ec->mul( tmp, ec->b, one, ec->p, ec->n, ec->size );
   fprintf( fp, "  b =  0x%s\n", ak_mpzn_to_hexstr( tmp, ec->size ));
 
   fprintf( fp, "  p =  0x%s\n", ak_mpzn_to_hexstr( ec->p, ec->size ));
@@ -393,23 +525,23 @@
 
  /* Проверяем принадлежность точки заданной кривой */
   ak_mpzn_set( t, ec->a, ec->size );
-  ak_mpzn_mul_montgomery( t, t, wp->x, ec->p, ec->n, ec->size );
+  ec->mul( t, t, wp->x, ec->p, ec->n, ec->size );
   ak_mpzn_set( s, ec->b, ec->size );
-  ak_mpzn_mul_montgomery( s, s, wp->z, ec->p, ec->n, ec->size );
+  ec->mul( s, s, wp->z, ec->p, ec->n, ec->size );
   ak_mpzn_add_montgomery( t, t, s, ec->p, ec->size ); // теперь в t величина (ax+bz)
 
   ak_mpzn_set( s, wp->z, ec->size );
-  ak_mpzn_mul_montgomery( s, s, s, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( t, t, s, ec->p, ec->n, ec->size ); // теперь в t величина (ax+bz)z^2
+  ec->sqr( s, s, ec->p, ec->n, ec->size );
+  ec->mul( t, t, s, ec->p, ec->n, ec->size ); // теперь в t величина (ax+bz)z^2
 
   ak_mpzn_set( s, wp->x, ec->size );
-  ak_mpzn_mul_montgomery( s, s, s, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( s, s, wp->x, ec->p, ec->n, ec->size );
+  ec->sqr( s, s, ec->p, ec->n, ec->size );
+  ec->mul( s, s, wp->x, ec->p, ec->n, ec->size );
   ak_mpzn_add_montgomery( t, t, s, ec->p, ec->size ); // теперь в t величина x^3 + (ax+bz)z^2
 
   ak_mpzn_set( s, wp->y, ec->size );
-  ak_mpzn_mul_montgomery( s, s, s, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( s, s, wp->z, ec->p, ec->n, ec->size ); // теперь в s величина x^3 + (ax+bz)z^2
+  ec->sqr( s, s, ec->p, ec->n, ec->size );
+  ec->mul( s, s, wp->z, ec->p, ec->n, ec->size ); // теперь в s величина x^3 + (ax+bz)z^2
 
   if( ak_mpzn_cmp( t, s, ec->size )) return ak_false;
  return ak_true;
@@ -451,30 +583,30 @@
    return;
  }
  // dbl-2007-bl
- ak_mpzn_mul_montgomery( u1, wp->x, wp->x, ec->p, ec->n, ec->size );
- ak_mpzn_mul_montgomery( u2, wp->z, wp->z, ec->p, ec->n, ec->size );
+ ec->sqr( u1, wp->x, ec->p, ec->n, ec->size );
+ ec->sqr( u2, wp->z, ec->p, ec->n, ec->size );
  ak_mpzn_lshift_montgomery( u4, u1, ec->p, ec->size );
  ak_mpzn_add_montgomery( u4, u4, u1, ec->p, ec->size );
- ak_mpzn_mul_montgomery( u3, u2, ec->a, ec->p, ec->n, ec->size );
+ ec->mul( u3, u2, ec->a, ec->p, ec->n, ec->size );
  ak_mpzn_add_montgomery( u3, u3, u4, ec->p, ec->size );  // u3 = az^2 + 3x^2
- ak_mpzn_mul_montgomery( u4, wp->y, wp->z, ec->p, ec->n, ec->size );
+ ec->mul( u4, wp->y, wp->z, ec->p, ec->n, ec->size );
  ak_mpzn_lshift_montgomery( u4, u4, ec->p, ec->size );   // u4 = 2yz
- ak_mpzn_mul_montgomery( u5, wp->y, u4, ec->p, ec->n, ec->size ); // u5 = 2y^2z
+ ec->mul( u5, wp->y, u4, ec->p, ec->n, ec->size ); // u5 = 2y^2z
  ak_mpzn_lshift_montgomery( u6, u5, ec->p, ec->size ); // u6 = 2u5
- ak_mpzn_mul_montgomery( u7, u6, wp->x, ec->p, ec->n, ec->size ); // u7 = 8xy^2z
+ ec->mul( u7, u6, wp->x, ec->p, ec->n, ec->size ); // u7 = 8xy^2z
  ak_mpzn_lshift_montgomery( u1, u7, ec->p, ec->size );
  ak_mpzn_sub( u1, ec->p, u1, ec->size );
- ak_mpzn_mul_montgomery( u2, u3, u3, ec->p, ec->n, ec->size );
+ ec->sqr( u2, u3, ec->p, ec->n, ec->size );
  ak_mpzn_add_montgomery( u2, u2, u1, ec->p, ec->size );
- ak_mpzn_mul_montgomery( wp->x, u2, u4, ec->p, ec->n, ec->size );
- ak_mpzn_mul_montgomery( u6, u6, u5, ec->p, ec->n, ec->size );
+ ec->mul( wp->x, u2, u4, ec->p, ec->n, ec->size );
+ ec->mul( u6, u6, u5, ec->p, ec->n, ec->size );
  ak_mpzn_sub( u6, ec->p, u6, ec->size );
  ak_mpzn_sub( u2, ec->p, u2, ec->size );
  ak_mpzn_add_montgomery( u2, u2, u7, ec->p, ec->size );
- ak_mpzn_mul_montgomery( wp->y, u2, u3, ec->p, ec->n, ec->size );
+ ec->mul( wp->y, u2, u3, ec->p, ec->n, ec->size );
  ak_mpzn_add_montgomery( wp->y, wp->y, u6, ec->p, ec->size );
- ak_mpzn_mul_montgomery( wp->z, u4, u4, ec->p, ec->n, ec->size );
- ak_mpzn_mul_montgomery( wp->z, wp->z, u4, ec->p, ec->n, ec->size );
+ ec->sqr( wp->z, u4, ec->p, ec->n, ec->size );
+ ec->mul( wp->z, wp->z, u4, ec->p, ec->n, ec->size );
 }
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -522,11 +654,11 @@
   }
   // поскольку удвоение точки с помощью формул сложения дает бесконечно удаленную точку,
   // необходимо выполнить проверку
-  ak_mpzn_mul_montgomery( u1, wp1->x, wp2->z, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( u2, wp2->x, wp1->z, ec->p, ec->n, ec->size );
+  ec->mul( u1, wp1->x, wp2->z, ec->p, ec->n, ec->size );
+  ec->mul( u2, wp2->x, wp1->z, ec->p, ec->n, ec->size );
   if( ak_mpzn_cmp( u1, u2, ec->size ) == 0 ) { // случай совпадения х-координат точки
-    ak_mpzn_mul_montgomery( u1, wp1->y, wp2->z, ec->p, ec->n, ec->size );
-    ak_mpzn_mul_montgomery( u2, wp2->y, wp1->z, ec->p, ec->n, ec->size );
+    ec->mul( u1, wp1->y, wp2->z, ec->p, ec->n, ec->size );
+    ec->mul( u2, wp2->y, wp1->z, ec->p, ec->n, ec->size );
     if( ak_mpzn_cmp( u1, u2, ec->size ) == 0 ) // случай полного совпадения точек
       ak_wpoint_double( wp1, ec );
      else ak_wpoint_set_as_unit( wp1, ec );
@@ -534,31 +666,31 @@
   }
 
   //add-1998-cmo-2
-  ak_mpzn_mul_montgomery( u1, wp1->x, wp2->z, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( u2, wp1->y, wp2->z, ec->p, ec->n, ec->size );
+  ec->mul( u1, wp1->x, wp2->z, ec->p, ec->n, ec->size );
+  ec->mul( u2, wp1->y, wp2->z, ec->p, ec->n, ec->size );
   ak_mpzn_sub( u2, ec->p, u2, ec->size );
-  ak_mpzn_mul_montgomery( u3, wp1->z, wp2->z, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( u4, wp2->y, wp1->z, ec->p, ec->n, ec->size );
+  ec->mul( u3, wp1->z, wp2->z, ec->p, ec->n, ec->size );
+  ec->mul( u4, wp2->y, wp1->z, ec->p, ec->n, ec->size );
   ak_mpzn_add_montgomery( u4, u4, u2, ec->p, ec->size );
-  ak_mpzn_mul_montgomery( u5, u4, u4, ec->p, ec->n, ec->size );
+  ec->sqr( u5, u4, ec->p, ec->n, ec->size );
   ak_mpzn_sub( u7, ec->p, u1, ec->size );
-  ak_mpzn_mul_montgomery( wp1->x, wp2->x, wp1->z, ec->p, ec->n, ec->size );
+  ec->mul( wp1->x, wp2->x, wp1->z, ec->p, ec->n, ec->size );
   ak_mpzn_add_montgomery( wp1->x, wp1->x, u7, ec->p, ec->size );
-  ak_mpzn_mul_montgomery( u7, wp1->x, wp1->x, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( u6, u7, wp1->x, ec->p, ec->n, ec->size);
-  ak_mpzn_mul_montgomery( u1, u7, u1, ec->p, ec->n, ec->size );
+  ec->sqr( u7, wp1->x, ec->p, ec->n, ec->size );
+  ec->mul( u6, u7, wp1->x, ec->p, ec->n, ec->size);
+  ec->mul( u1, u7, u1, ec->p, ec->n, ec->size );
   ak_mpzn_lshift_montgomery( u7, u1, ec->p, ec->size );
   ak_mpzn_add_montgomery( u7, u7, u6, ec->p, ec->size );
   ak_mpzn_sub( u7, ec->p, u7, ec->size );
-  ak_mpzn_mul_montgomery( u5, u5, u3, ec->p, ec->n, ec->size );
+  ec->mul( u5, u5, u3, ec->p, ec->n, ec->size );
   ak_mpzn_add_montgomery( u5, u5, u7, ec->p, ec->size );
-  ak_mpzn_mul_montgomery( wp1->x, wp1->x, u5, ec->p, ec->n, ec->size );
-  ak_mpzn_mul_montgomery( u2, u2, u6, ec->p, ec->n, ec->size );
+  ec->mul( wp1->x, wp1->x, u5, ec->p, ec->n, ec->size );
+  ec->mul( u2, u2, u6, ec->p, ec->n, ec->size );
   ak_mpzn_sub( u5, ec->p, u5, ec->size );
   ak_mpzn_add_montgomery( u1, u1, u5, ec->p, ec->size );
-  ak_mpzn_mul_montgomery( wp1->y, u4, u1, ec->p, ec->n, ec->size );
+  ec->mul( wp1->y, u4, u1, ec->p, ec->n, ec->size );
   ak_mpzn_add_montgomery( wp1->y, wp1->y, u2, ec->p, ec->size );
-  ak_mpzn_mul_montgomery( wp1->z, u6, u3, ec->p, ec->n, ec->size );
+  ec->mul( wp1->z, u6, u3, ec->p, ec->n, ec->size );
 }
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -571,19 +703,17 @@
 /* ----------------------------------------------------------------------------------------------- */
  void ak_wpoint_reduce( ak_wpoint wp, ak_wcurve ec )
 {
- ak_mpznmax u, one = ak_mpznmax_one;
+ ak_mpznmax u;
  if( ak_mpzn_cmp_ui( wp->z, ec->size, 0 ) == ak_true ) {
    ak_wpoint_set_as_unit( wp, ec );
    return;
  }
 
- ak_mpzn_set_ui( u, ec->size, 2 );
- ak_mpzn_sub( u, ec->p, u, ec->size );
- ak_mpzn_modpow_montgomery( u, wp->z, u, ec->p, ec->n, ec->size ); // u <- z^{p-2} (mod p)
- ak_mpzn_mul_montgomery( u, u, one, ec->p, ec->n, ec->size );
+ ak_mpzn_inverse( u, wp->z, ec->p, ec->size );                    // u <- z^{-1} (mod p)
+ ec->mul( u, u, ec->r2, ec->p, ec->n, ec->size );
 
- ak_mpzn_mul_montgomery( wp->x, wp->x, u, ec->p, ec->n, ec->size );
- ak_mpzn_mul_montgomery( wp->y, wp->y, u, ec->p, ec->n, ec->size );
+ ec->mul( wp->x, wp->x, u, ec->p, ec->n, ec->size );
+ ec->mul( wp->y, wp->y, u, ec->p, ec->n, ec->size );
  ak_mpzn_set_ui( wp->z, ec->size, 1 );
 }
 
@@ -593,7 +723,9 @@
     равенству \f$  Q = [k]P = \underbrace{P+ \cdots + P}_{k}\f$.
 
     При вычислении используется метод `лесенки Монтгомери`, выравнивающий время работы алгоритма
-    вне зависимости от вида числа \f$ k \f$.
+    вне зависимости от вида числа \f$ k \f$. Функция используется функцией ak_wpoint_pow()
+    для точек, к которым не применимы более быстрые методы, а также для контроля
+    правильности вычислений.
 
     \b Для \b информации:
      \li Функция не приводит результирующую точку \f$ Q \f$ к аффинной форме.
@@ -607,7 +739,8 @@
     может приниимать любое неотрицательное значение.
     @param ec Эллиптическая кривая, на которой происходят вычисления                               */
 /* ----------------------------------------------------------------------------------------------- */
- void ak_wpoint_pow( ak_wpoint wq, ak_wpoint wp, ak_uint64 *k, size_t size, ak_wcurve ec )
+ void ak_wpoint_pow_montgomery( ak_wpoint wq, ak_wpoint wp, ak_uint64 *k, size_t size,
+                                                                                 ak_wcurve ec )
 {
   ak_uint64 uk = 0;
   long long int i, j;
@@ -652,6 +785,1112 @@
   return ak_mpzn_cmp_ui( ep.z, ec->size, 0 );
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*                 вычисление кратных точек с использованием предвычисленных таблиц                */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Количество бит вычета, обрабатываемых за одно обращение к таблице кратных точек. */
+ #define ak_wcurve_table_window     (4)
+/*! \brief Количество ненулевых точек в одной строке таблицы кратных точек. */
+ #define ak_wcurve_table_row_size   ((1 << ak_wcurve_table_window) - 1)
+/*! \brief Количество машинных слов, занимаемых таблицей кратных точек. */
+ #define ak_wcurve_table_words( size ) \
+                   ( 2*ak_wcurve_table_row_size*( 64/ak_wcurve_table_window )*( size )*( size ))
+/*! \brief Максимальное количество эллиптических кривых, для которых создаются таблицы. */
+ #define ak_wcurve_table_max_count  (16)
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Таблица кратных образующей точки эллиптической кривой.
+
+    Для \f$ i = 0, \ldots, 16\cdot\text{size}-1 \f$ и \f$ j = 1, \ldots, 15 \f$ таблица содержит
+    аффинные координаты (в представлении Монтгомери) точек \f$ [j\cdot 16^i]P \f$, где
+    \f$ P \f$ образующая точка кривой. Строки таблицы располагаются последовательно,
+    каждая точка занимает `2*size` машинных слов (сначала x-координата, потом y-координата).       */
+/* ----------------------------------------------------------------------------------------------- */
+ typedef struct wcurve_table {
+  /*! \brief Эллиптическая кривая, для образующей точки которой построена таблица. */
+   ak_wcurve wc;
+  /*! \brief Величина \f$ 3b \pmod{p} \f$ в представлении Монтгомери. */
+   ak_uint64 b3[ak_mpzn512_size];
+  /*! \brief Единица в представлении Монтгомери. */
+   ak_uint64 one[ak_mpzn512_size];
+  /*! \brief Массив точек. */
+   ak_uint64 *points;
+  /*! \brief Параметры эквивалентной скрученной кривой Эдвардса (NULL, если кривая
+      не эквивалентна известной кривой Эдвардса). */
+   const struct edwards_params *ed;
+  /*! \brief Массив точек эквивалентной скрученной кривой Эдвардса (NULL, если массив не создан). */
+   ak_uint64 *epoints;
+ } *ak_wcurve_table;
+
+/*! \brief Таблицы кратных точек, созданные для используемых эллиптических кривых. */
+ static struct wcurve_table wcurve_tables[ak_wcurve_table_max_count];
+/*! \brief Количество созданных таблиц кратных точек. */
+ static size_t wcurve_tables_count = 0;
+#ifdef AK_HAVE_PTHREAD_H
+/*! \brief Мьютекс, защищающий массив таблиц кратных точек при одновременном обращении потоков. */
+ static pthread_mutex_t wcurve_tables_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Для двух заданных точек эллиптической кривой \f$ P \f$ и \f$ Q \f$ вычисляется сумма
+    \f$ P+Q \f$, которая присваивается точке \f$ P\f$. В отличие от функции ak_wpoint_add(),
+    используются полные формулы сложения, корректные для любых точек подгруппы нечетного порядка
+    (в том числе, для совпадающих точек и бесконечно удаленной точки). Формулы не содержат
+    ветвлений, зависящих от складываемых точек, см. J.Renes, C.Costello, L.Batina,
+    <a href="https://eprint.iacr.org/2015/1060">Complete addition formulas for prime order
+    elliptic curves</a>, 2016 (алгоритм 1).
+
+    @param wp1 Точка \f$ P \f$, в которую помещается результат операции сложения; первое слагаемое
+    @param wp2 Точка \f$ Q \f$, второе слагаемое
+    @param b3 Величина \f$ 3b \pmod{p} \f$ в представлении Монтгомери
+    @param ec Эллиптическая кривая, которой принадллежат складываемые точки                        */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_wpoint_add_complete( ak_wpoint wp1, ak_wpoint wp2, ak_uint64 *b3, ak_wcurve ec )
+{
+  ak_mpznmax t0, t1, t2, t3, t4, t5, x3, y3, z3;
+  ak_uint64 *p = ec->p, n = ec->n;
+  const size_t size = ec->size;
+
+  ec->mul( t0, wp1->x, wp2->x, p, n, size );
+  ec->mul( t1, wp1->y, wp2->y, p, n, size );
+  ec->mul( t2, wp1->z, wp2->z, p, n, size );
+  ak_mpzn_add_montgomery( t3, wp1->x, wp1->y, p, size );
+  ak_mpzn_add_montgomery( t4, wp2->x, wp2->y, p, size );
+  ec->mul( t3, t3, t4, p, n, size );
+  ak_mpzn_add_montgomery( t4, t0, t1, p, size );
+  ak_mpzn_sub_montgomery( t3, t3, t4, p, size );      // t3 = x1y2 + x2y1
+  ak_mpzn_add_montgomery( t4, wp1->x, wp1->z, p, size );
+  ak_mpzn_add_montgomery( t5, wp2->x, wp2->z, p, size );
+  ec->mul( t4, t4, t5, p, n, size );
+  ak_mpzn_add_montgomery( t5, t0, t2, p, size );
+  ak_mpzn_sub_montgomery( t4, t4, t5, p, size );      // t4 = x1z2 + x2z1
+  ak_mpzn_add_montgomery( t5, wp1->y, wp1->z, p, size );
+  ak_mpzn_add_montgomery( x3, wp2->y, wp2->z, p, size );
+  ec->mul( t5, t5, x3, p, n, size );
+  ak_mpzn_add_montgomery( x3, t1, t2, p, size );
+  ak_mpzn_sub_montgomery( t5, t5, x3, p, size );      // t5 = y1z2 + y2z1
+  ec->mul( z3, ec->a, t4, p, n, size );
+  ec->mul( x3, b3, t2, p, n, size );
+  ak_mpzn_add_montgomery( z3, x3, z3, p, size );
+  ak_mpzn_sub_montgomery( x3, t1, z3, p, size );
+  ak_mpzn_add_montgomery( z3, t1, z3, p, size );
+  ec->mul( y3, x3, z3, p, n, size );
+  ak_mpzn_lshift_montgomery( t1, t0, p, size );
+  ak_mpzn_add_montgomery( t1, t1, t0, p, size );      // t1 = 3x1x2
+  ec->mul( t2, ec->a, t2, p, n, size );
+  ec->mul( t4, b3, t4, p, n, size );
+  ak_mpzn_add_montgomery( t1, t1, t2, p, size );
+  ak_mpzn_sub_montgomery( t2, t0, t2, p, size );
+  ec->mul( t2, ec->a, t2, p, n, size );
+  ak_mpzn_add_montgomery( t4, t4, t2, p, size );
+  ec->mul( t0, t1, t4, p, n, size );
+  ak_mpzn_add_montgomery( y3, y3, t0, p, size );
+  ec->mul( t0, t5, t4, p, n, size );
+  ec->mul( x3, t3, x3, p, n, size );
+  ak_mpzn_sub_montgomery( wp1->x, x3, t0, p, size );
+  ec->mul( t0, t3, t1, p, n, size );
+  ec->mul( z3, t5, z3, p, n, size );
+  ak_mpzn_add_montgomery( wp1->z, z3, t0, p, size );
+  ak_mpzn_set( wp1->y, y3, size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция удваивает точку \f$ P \f$ эллиптической кривой, используя полные формулы
+    удвоения (J.Renes, C.Costello, L.Batina, алгоритм 3), корректные для любых точек
+    подгруппы нечетного порядка, в том числе для бесконечно удаленной точки.
+
+    @param wp Точка \f$ P \f$, в которую помещается результат
+    @param b3 Величина \f$ 3b \pmod{p} \f$ в представлении Монтгомери
+    @param ec Эллиптическая кривая, которой принадлежит точка                                      */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_wpoint_double_complete( ak_wpoint wp, ak_uint64 *b3, ak_wcurve ec )
+{
+  ak_mpznmax t0, t1, t2, t3, x3, y3, z3;
+  ak_uint64 *p = ec->p, n = ec->n;
+  const size_t size = ec->size;
+
+  ec->sqr( t0, wp->x, p, n, size );
+  ec->sqr( t1, wp->y, p, n, size );
+  ec->sqr( t2, wp->z, p, n, size );
+  ec->mul( t3, wp->x, wp->y, p, n, size );
+  ak_mpzn_lshift_montgomery( t3, t3, p, size );       // t3 = 2xy
+  ec->mul( z3, wp->x, wp->z, p, n, size );
+  ak_mpzn_lshift_montgomery( z3, z3, p, size );       // z3 = 2xz
+  ec->mul( x3, ec->a, z3, p, n, size );
+  ec->mul( y3, b3, t2, p, n, size );
+  ak_mpzn_add_montgomery( y3, x3, y3, p, size );
+  ak_mpzn_sub_montgomery( x3, t1, y3, p, size );
+  ak_mpzn_add_montgomery( y3, t1, y3, p, size );
+  ec->mul( y3, x3, y3, p, n, size );
+  ec->mul( x3, t3, x3, p, n, size );
+  ec->mul( z3, b3, z3, p, n, size );
+  ec->mul( t2, ec->a, t2, p, n, size );
+  ak_mpzn_sub_montgomery( t3, t0, t2, p, size );
+  ec->mul( t3, ec->a, t3, p, n, size );
+  ak_mpzn_add_montgomery( t3, t3, z3, p, size );
+  ak_mpzn_lshift_montgomery( z3, t0, p, size );
+  ak_mpzn_add_montgomery( t0, z3, t0, p, size );
+  ak_mpzn_add_montgomery( t0, t0, t2, p, size );      // t0 = 3x^2 + az^2
+  ec->mul( t0, t0, t3, p, n, size );
+  ak_mpzn_add_montgomery( wp->x, y3, t0, p, size );   /* значение y3 */
+  ec->mul( t2, wp->y, wp->z, p, n, size );
+  ak_mpzn_lshift_montgomery( t2, t2, p, size );       // t2 = 2yz
+  ec->mul( t0, t2, t3, p, n, size );
+  ec->mul( z3, t2, t1, p, n, size );
+  ak_mpzn_lshift_montgomery( z3, z3, p, size );
+  ak_mpzn_lshift_montgomery( wp->z, z3, p, size );
+  ak_mpzn_set( wp->y, wp->x, size );
+  ak_mpzn_sub_montgomery( wp->x, x3, t0, p, size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция заменяет каждый из заданных вычетов \f$ z_0, \ldots, z_{n-1} \f$ обратным к нему
+    вычетом по модулю \f$ p \f$, используя одно обращение элемента конечного поля
+    (метод Монтгомери). Все вычеты должны быть отличны от нуля и заданы в представлении Монтгомери.
+
+    @param zt Массив из `count*wc->size` машинных слов, содержащий обращаемые вычеты.
+    @param pr Вспомогательный массив того же размера.
+    @param count Количество обращаемых вычетов.
+    @param wc Эллиптическая кривая, по модулю которой выполняются вычисления.                      */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_wcurve_batch_inverse( ak_uint64 *zt, ak_uint64 *pr, size_t count, ak_wcurve wc )
+{
+  ak_mpznmax u, inv;
+  size_t idx;
+  const size_t size = wc->size;
+
+  memcpy( pr, zt, size*sizeof( ak_uint64 ));
+  for( idx = 1; idx < count; idx++ )
+     wc->mul( pr + idx*size, pr + (idx-1)*size, zt + idx*size, wc->p, wc->n, size );
+  ak_mpzn_inverse_montgomery( inv, pr + (count-1)*size, wc->p, wc->n, wc->r2, size );
+
+  for( idx = count-1; idx > 0; idx-- ) {
+     wc->mul( u, inv, pr + (idx-1)*size, wc->p, wc->n, size ); /* u <- 1/z[idx] */
+     wc->mul( inv, inv, zt + idx*size, wc->p, wc->n, size );
+     memcpy( zt + idx*size, u, size*sizeof( ak_uint64 ));
+  }
+  memcpy( zt, inv, size*sizeof( ak_uint64 ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет точки \f$ [j\cdot 16^i]Q \f$ таблицы кратных точки \f$ Q \f$, после чего
+    одновременно приводит их к аффинной форме, используя одно обращение элемента конечного поля
+    (метод Монтгомери). Формат таблицы совпадает с форматом таблицы образующей точки
+    (см. описание struct wcurve_table).
+
+    @param points Массив, в который помещаются точки таблицы; память под массив
+    (ak_wcurve_table_words() машинных слов) должна быть выделена заранее.
+    @param wq Точка \f$ Q \f$, принадлежащая подгруппе порядка \f$ q \f$.
+    @param b3 Величина \f$ 3b \pmod{p} \f$ в представлении Монтгомери
+    @param wc Эллиптическая кривая.
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_wcurve_table_build( ak_uint64 *points, ak_wpoint wq, ak_uint64 *b3, ak_wcurve wc )
+{
+  struct wpoint base, wp;
+  ak_uint64 *zt = NULL, *ptr = NULL;
+  const size_t size = wc->size, rows = 64*size/ak_wcurve_table_window,
+               count = rows*ak_wcurve_table_row_size;
+  size_t i, j, idx;
+
+  if(( zt = malloc( 2*count*size*sizeof( ak_uint64 ))) == NULL )
+    return ak_error_message( ak_error_out_of_memory, __func__, "incorrect memory allocation" );
+
+ /* вычисляем точки [j*16^i]Q в проективных координатах */
+  ak_wpoint_set_wpoint( &base, wq, wc );
+  for( i = 0, idx = 0; i < rows; i++ ) {
+     ak_wpoint_set_wpoint( &wp, &base, wc );
+     for( j = 1; j <= ak_wcurve_table_row_size; j++, idx++ ) {
+        if( j > 1 ) ak_wpoint_add_complete( &wp, &base, b3, wc );
+        ptr = points + 2*idx*size;
+        memcpy( ptr, wp.x, size*sizeof( ak_uint64 ));
+        memcpy( ptr + size, wp.y, size*sizeof( ak_uint64 ));
+        memcpy( zt + idx*size, wp.z, size*sizeof( ak_uint64 ));
+     }
+     ak_wpoint_add_complete( &base, &wp, b3, wc ); /* base <- 16*base */
+  }
+
+ /* обращаем все z-координаты одновременно */
+  ak_wcurve_batch_inverse( zt, zt + count*size, count, wc );
+  for( idx = 0; idx < count; idx++ ) {
+     ptr = points + 2*idx*size;
+     wc->mul( ptr, ptr, zt + idx*size, wc->p, wc->n, size );
+     wc->mul( ptr + size, ptr + size, zt + idx*size, wc->p, wc->n, size );
+  }
+
+  free( zt );
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                  арифметика эквивалентных скрученных кривых Эдвардса                            */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Точка скрученной кривой Эдвардса в расширенных проективных координатах.
+
+    Точка \f$ (X:Y:Z:T) \f$ соответствует аффинной точке \f$ (u,v) = (X/Z, Y/Z) \f$,
+    при этом \f$ T = XY/Z \f$. Все координаты хранятся в представлении Монтгомери.                  */
+/* ----------------------------------------------------------------------------------------------- */
+ typedef struct epoint {
+  /*! \brief x-координата */
+   ak_uint64 x[ak_mpzn512_size];
+  /*! \brief y-координата */
+   ak_uint64 y[ak_mpzn512_size];
+  /*! \brief z-координата */
+   ak_uint64 z[ak_mpzn512_size];
+  /*! \brief t-координата */
+   ak_uint64 t[ak_mpzn512_size];
+ } *ak_epoint;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция прибавляет к точке \f$ P = (X_1:Y_1:Z_1:T_1) \f$ точку \f$ Q = (X_2:Y_2:Z_2:T_2) \f$
+    скрученной кривой Эдвардса, см. H.Hisil, K.K.-H.Wong, G.Carter, E.Dawson,
+    <a href="https://eprint.iacr.org/2008/522">Twisted Edwards curves revisited</a>, 2008.
+    Поскольку \f$ e = 1 \f$ является квадратом, а \f$ d \f$ - нет, формулы сложения полны,
+    то есть корректны для любых точек кривой и не содержат ветвлений.
+
+    @param ep Точка \f$ P \f$, в которую помещается результат.
+    @param x2 Координата \f$ X_2 \f$.
+    @param y2 Координата \f$ Y_2 \f$.
+    @param z2 Координата \f$ Z_2 \f$; если значение равно NULL, то \f$ Z_2 = 1 \f$
+    (точка \f$ Q \f$ задана в аффинной форме).
+    @param dt2 Величина \f$ dT_2 \f$.
+    @param ec Эллиптическая кривая, на которой происходят вычисления.                               */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_epoint_add( ak_epoint ep, ak_uint64 *x2, ak_uint64 *y2, ak_uint64 *z2,
+                                                                  ak_uint64 *dt2, ak_wcurve ec )
+{
+  ak_mpznmax a, b, c, d, e;
+  ak_uint64 *p = ec->p, n = ec->n;
+  const size_t size = ec->size;
+
+  ec->mul( a, ep->x, x2, p, n, size );
+  ec->mul( b, ep->y, y2, p, n, size );
+  ec->mul( c, ep->t, dt2, p, n, size );
+  if( z2 == NULL ) memcpy( d, ep->z, size*sizeof( ak_uint64 ));
+   else ec->mul( d, ep->z, z2, p, n, size );
+  ak_mpzn_add_montgomery( e, ep->x, ep->y, p, size );
+  ak_mpzn_add_montgomery( ep->t, x2, y2, p, size );
+  ec->mul( e, e, ep->t, p, n, size );
+  ak_mpzn_sub_montgomery( e, e, a, p, size );
+  ak_mpzn_sub_montgomery( e, e, b, p, size );         // e = x1y2 + x2y1
+  ak_mpzn_sub_montgomery( b, b, a, p, size );         // h = y1y2 - x1x2
+  ak_mpzn_sub_montgomery( a, d, c, p, size );         // f = z1z2 - dt1t2
+  ak_mpzn_add_montgomery( d, d, c, p, size );         // g = z1z2 + dt1t2
+  ec->mul( ep->x, e, a, p, n, size );
+  ec->mul( ep->y, d, b, p, n, size );
+  ec->mul( ep->t, e, b, p, n, size );
+  ec->mul( ep->z, a, d, p, n, size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция удваивает точку \f$ P = (X:Y:Z:T) \f$ скрученной кривой Эдвардса
+    (координата \f$ T \f$ исходной точки не используется).
+
+    @param ep Точка \f$ P \f$, в которую помещается результат.
+    @param ec Эллиптическая кривая, на которой происходят вычисления.                               */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_epoint_double( ak_epoint ep, ak_wcurve ec )
+{
+  ak_mpznmax a, b, c, e;
+  ak_uint64 *p = ec->p, n = ec->n;
+  const size_t size = ec->size;
+
+  ec->sqr( a, ep->x, p, n, size );
+  ec->sqr( b, ep->y, p, n, size );
+  ec->sqr( c, ep->z, p, n, size );
+  ak_mpzn_lshift_montgomery( c, c, p, size );         // c = 2z^2
+  ak_mpzn_add_montgomery( e, ep->x, ep->y, p, size );
+  ec->sqr( e, e, p, n, size );
+  ak_mpzn_sub_montgomery( e, e, a, p, size );
+  ak_mpzn_sub_montgomery( e, e, b, p, size );         // e = 2xy
+  ak_mpzn_sub_montgomery( ep->t, a, b, p, size );     // h = x^2 - y^2
+  ak_mpzn_add_montgomery( a, a, b, p, size );         // g = x^2 + y^2
+  ak_mpzn_sub_montgomery( c, a, c, p, size );         // f = g - 2z^2
+  ec->mul( ep->x, e, c, p, n, size );
+  ec->mul( ep->y, a, ep->t, p, n, size );
+  ec->mul( ep->t, e, ep->t, p, n, size );
+  ec->mul( ep->z, c, a, p, n, size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет точку \f$ (X:Y:Z:T) \f$ кривой Эдвардса, соответствующую точке
+    \f$ P = (x:y:z) \f$ кривой в форме Вейерштрасса, по формулам
+    \f$ X = w(w+sz),\ Y = y(w-sz),\ Z = y(w+sz),\ T = w(w-sz) \f$, где \f$ w = x - tz\f$.
+
+    @param ep Точка кривой Эдвардса, в которую помещается результат.
+    @param wp Точка \f$ P \f$ кривой в форме Вейерштрасса.
+    @param ed Параметры кривой Эдвардса.
+    @param ec Эллиптическая кривая в форме Вейерштрасса.
+    @return Функция возвращает \ref ak_false, если точка \f$ P \f$ не может быть отображена
+    в точку кривой Эдвардса (точка \f$ P \f$ является бесконечно удаленной или
+    имеет порядок 2). В противном случае возвращается \ref ak_true.                                */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_epoint_set_wpoint( ak_epoint ep, ak_wpoint wp,
+                                                 const struct edwards_params *ed, ak_wcurve ec )
+{
+  ak_mpznmax w, w1, w2;
+  ak_uint64 *p = ec->p, n = ec->n;
+  const size_t size = ec->size;
+
+  ec->mul( w, ( ak_uint64 *)ed->t, wp->z, p, n, size );
+  ak_mpzn_sub_montgomery( w, wp->x, w, p, size );
+  ec->mul( w2, ( ak_uint64 *)ed->s, wp->z, p, n, size );
+  ak_mpzn_add_montgomery( w1, w, w2, p, size );
+  ak_mpzn_sub_montgomery( w2, w, w2, p, size );
+  ec->mul( ep->x, w, w1, p, n, size );
+  ec->mul( ep->y, wp->y, w2, p, n, size );
+  ec->mul( ep->z, wp->y, w1, p, n, size );
+  ec->mul( ep->t, w, w2, p, n, size );
+ return !ak_mpzn_cmp_ui( ep->z, size, 0 );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет точку \f$ (x:y:z) \f$ кривой в форме Вейерштрасса, соответствующую точке
+    \f$ (X:Y:Z:T) \f$ кривой Эдвардса, по формулам
+    \f$ x = (s(Z+Y) + t(Z-Y))X,\ y = s(Z+Y)Z,\ z = (Z-Y)X \f$. Нейтральный элемент
+    \f$ (0:1:1:0) \f$ кривой Эдвардса переходит в бесконечно удаленную точку, точка
+    \f$ (0:-1:1:0) \f$ второго порядка - в точку \f$ (t:0:1) \f$ (выбор выполняется с помощью
+    масок).
+
+    @param wp Точка кривой в форме Вейерштрасса, в которую помещается результат.
+    @param ep Точка кривой Эдвардса.
+    @param ed Параметры кривой Эдвардса.
+    @param ec Эллиптическая кривая в форме Вейерштрасса.                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_wpoint_set_epoint( ak_wpoint wp, ak_epoint ep,
+                                                 const struct edwards_params *ed, ak_wcurve ec )
+{
+  size_t i;
+  ak_mpznmax w1, w2, w3, one = ak_mpznmax_zero;
+  ak_uint64 *p = ec->p, n = ec->n, mask = 0;
+  const size_t size = ec->size;
+
+  ak_mpzn_add_montgomery( w1, ep->z, ep->y, p, size );
+  ec->mul( w1, ( ak_uint64 *)ed->s, w1, p, n, size );
+  ak_mpzn_sub_montgomery( w2, ep->z, ep->y, p, size );
+  ec->mul( w3, ( ak_uint64 *)ed->t, w2, p, n, size );
+  ak_mpzn_add_montgomery( w3, w3, w1, p, size );
+  ec->mul( wp->x, w3, ep->x, p, n, size );
+  ec->mul( wp->y, w1, ep->z, p, n, size );
+  ec->mul( wp->z, w2, ep->x, p, n, size );
+
+ /* нулевая y-координата возникает только для точки (0:-1:1:0) */
+  ak_wcurve_set_montgomery_one( one, ec );
+  for( i = 0; i < size; i++ ) mask |= wp->y[i];
+  mask = ( ak_uint64 )0 - (((( mask | (( ak_uint64 )0 - mask )) >> 63 )^1 ));
+  for( i = 0; i < size; i++ ) {
+     wp->x[i] |= ed->t[i]&mask;
+     wp->z[i] |= one[i]&mask;
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция создает таблицу точек \f$ [j\cdot 16^i]P \f$ кривой Эдвардса, используя
+    уже вычисленную таблицу аффинных точек кривой в форме Вейерштрасса. Каждая точка таблицы
+    занимает `3*size` машинных слов и задается аффинными координатами
+    \f$ u = (x-t)/y,\ v = (x-t-s)/(x-t+s) \f$ и величиной \f$ duv \f$.
+
+    @param tb Таблица кратных точек, для которой уже созданы точки кривой в форме Вейерштрасса
+    и определены параметры кривой Эдвардса.
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_wcurve_table_build_edwards( ak_wcurve_table tb )
+{
+  size_t idx;
+  ak_wcurve wc = tb->wc;
+  ak_mpznmax u, v, w;
+  ak_uint64 *zt = NULL, *ptr = NULL, *eptr = NULL, *p = wc->p, n = wc->n;
+  ak_uint64 *es = ( ak_uint64 *)tb->ed->s, *et = ( ak_uint64 *)tb->ed->t;
+  const size_t size = wc->size,
+               count = ( 64*size/ak_wcurve_table_window )*ak_wcurve_table_row_size;
+
+  if(( zt = malloc( 2*count*size*sizeof( ak_uint64 ))) == NULL )
+    return ak_error_message( ak_error_out_of_memory, __func__, "incorrect memory allocation" );
+  if(( tb->epoints = malloc( 3*count*size*sizeof( ak_uint64 ))) == NULL ) {
+    free( zt );
+    return ak_error_message( ak_error_out_of_memory, __func__, "incorrect memory allocation" );
+  }
+
+ /* для каждой аффинной точки (x,y) вычисляем w = x - t и обращаем y(w + s) */
+  for( idx = 0; idx < count; idx++ ) {
+     ptr = tb->points + 2*idx*size;
+     eptr = tb->epoints + 3*idx*size;
+     ak_mpzn_sub_montgomery( eptr, ptr, et, p, size );
+     ak_mpzn_add_montgomery( u, eptr, es, p, size );
+     wc->mul( zt + idx*size, ptr + size, u, p, n, size );
+  }
+  ak_wcurve_batch_inverse( zt, zt + count*size, count, wc );
+
+ /* u = w/y, v = (w - s)/(w + s) */
+  for( idx = 0; idx < count; idx++ ) {
+     ptr = tb->points + 2*idx*size;
+     eptr = tb->epoints + 3*idx*size;
+     ak_mpzn_add_montgomery( u, eptr, es, p, size );
+     ak_mpzn_sub_montgomery( v, eptr, es, p, size );
+     wc->mul( u, u, zt + idx*size, p, n, size );                   // u = 1/y
+     wc->mul( eptr, eptr, u, p, n, size );
+     wc->mul( v, v, ptr + size, p, n, size );
+     wc->mul( eptr + size, v, zt + idx*size, p, n, size );
+     wc->mul( w, eptr, eptr + size, p, n, size );
+     wc->mul( eptr + 2*size, w, ( ak_uint64 *)tb->ed->d, p, n, size );
+  }
+
+  free( zt );
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция ищет таблицу кратных точек для заданной кривой; если таблица отсутствует, то она
+    создается (при первом обращении). Созданные таблицы не изменяются и удаляются только
+    при завершении работы с библиотекой.
+
+    @param wc Эллиптическая кривая.
+    @return Указатель на таблицу. Если таблица не может быть создана, возвращается NULL.           */
+/* ----------------------------------------------------------------------------------------------- */
+ static ak_wcurve_table ak_wcurve_table_get( ak_wcurve wc )
+{
+  size_t i;
+  ak_wcurve_table tb = NULL;
+
+#ifdef AK_HAVE_PTHREAD_H
+  pthread_mutex_lock( &wcurve_tables_mutex );
+#endif
+  for( i = 0; i < wcurve_tables_count; i++ )
+     if( wcurve_tables[i].wc == wc ) { tb = wcurve_tables+i; goto labex; }
+  if( wcurve_tables_count == ak_wcurve_table_max_count ) goto labex;
+
+ /* создаем новую таблицу */
+  tb = wcurve_tables + wcurve_tables_count;
+  tb->wc = wc;
+  tb->epoints = NULL;
+  tb->ed = ak_wcurve_get_edwards_params( wc );
+  memset( tb->one, 0, sizeof( tb->one ));
+  ak_wcurve_set_montgomery_one( tb->one, wc );
+  ak_mpzn_lshift_montgomery( tb->b3, wc->b, wc->p, wc->size );
+  ak_mpzn_add_montgomery( tb->b3, tb->b3, wc->b, wc->p, wc->size );
+  if(( tb->points = malloc( ak_wcurve_table_words( wc->size )*sizeof( ak_uint64 ))) == NULL ) {
+    ak_error_message( ak_error_out_of_memory, __func__, "incorrect memory allocation" );
+    tb = NULL;
+    goto labex;
+  }
+  if( ak_wcurve_table_build( tb->points, &wc->point, tb->b3, wc ) != ak_error_ok ) {
+    ak_error_message( ak_error_get_value(), __func__,
+                                         "incorrect creation of precomputed table of base point" );
+    free( tb->points );
+    tb->points = NULL;
+    tb = NULL;
+    goto labex;
+  }
+ /* для кривых, эквивалентных кривым Эдвардса, создаем вторую таблицу;
+    в случае ошибки вычисления выполняются в форме Вейерштрасса */
+  if(( tb->ed != NULL ) && ( ak_wcurve_table_build_edwards( tb ) != ak_error_ok )) {
+    if( tb->epoints != NULL ) free( tb->epoints );
+    tb->epoints = NULL;
+  }
+  wcurve_tables_count++;
+
+  labex:
+#ifdef AK_HAVE_PTHREAD_H
+  pthread_mutex_unlock( &wcurve_tables_mutex );
+#endif
+ return tb;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция удаляет все таблицы кратных точек, созданные функцией ak_wpoint_pow_base().
+    Вызывается при завершении работы с библиотекой.                                                */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_wcurve_tables_destroy( void )
+{
+  size_t i;
+
+#ifdef AK_HAVE_PTHREAD_H
+  pthread_mutex_lock( &wcurve_tables_mutex );
+#endif
+  for( i = 0; i < wcurve_tables_count; i++ ) {
+     if( wcurve_tables[i].points != NULL ) free( wcurve_tables[i].points );
+     if( wcurve_tables[i].epoints != NULL ) free( wcurve_tables[i].epoints );
+     memset( wcurve_tables+i, 0, sizeof( struct wcurve_table ));
+  }
+  wcurve_tables_count = 0;
+#ifdef AK_HAVE_PTHREAD_H
+  pthread_mutex_unlock( &wcurve_tables_mutex );
+#endif
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                    вычисление кратных точек методом фиксированного окна                         */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Количество бит вычета, обрабатываемых за одну итерацию метода фиксированного окна. */
+ #define ak_wpoint_pow_window      (4)
+/*! \brief Количество точек в таблице, используемой методом фиксированного окна. */
+ #define ak_wpoint_pow_table_size  (1 << ak_wpoint_pow_window)
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет кратную точку \f$ Q = [k]P \f$ кривой в форме Вейерштрасса методом
+    фиксированного окна: для \f$ j = 0, \ldots, 15 \f$ вычисляются точки \f$ [j]P \f$, после чего
+    для каждой цифры \f$ k_i \f$ разложения \f$ k = \sum k_i 16^i \f$ выполняются четыре удвоения
+    и одно сложение. Используются полные формулы сложения и удвоения, а выбор точки из таблицы
+    выполняется с помощью масок, поэтому время работы функции не зависит от \f$ k \f$.
+
+    \b Для \b информации: полные формулы корректны только для кривых нечетного порядка.
+
+    @param wq Точка \f$ Q \f$, в которую помещается результат.
+    @param wp Точка \f$ P \f$.
+    @param k Степень кратности.
+    @param size Размер степени \f$ k \f$ в машинных словах.
+    @param ec Эллиптическая кривая, на которой происходят вычисления                               */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_wpoint_pow_fixed_window( ak_wpoint wq, ak_wpoint wp, ak_uint64 *k, size_t size,
+                                                                                 ak_wcurve ec )
+{
+  long long int i;
+  size_t j, l;
+  ak_mpznmax b3;
+  ak_uint64 digit, mask;
+  struct wpoint wr, wt, table[ak_wpoint_pow_table_size];
+
+  ak_mpzn_lshift_montgomery( b3, ec->b, ec->p, ec->size );
+  ak_mpzn_add_montgomery( b3, b3, ec->b, ec->p, ec->size );
+
+ /* вычисляем точки [j]P */
+  ak_wpoint_set_as_unit( table, ec );
+  ak_wpoint_set_wpoint( table+1, wp, ec );
+  for( j = 2; j < ak_wpoint_pow_table_size; j++ ) {
+     ak_wpoint_set_wpoint( table+j, table+j-1, ec );
+     ak_wpoint_add_complete( table+j, wp, b3, ec );
+  }
+
+  ak_wpoint_set_as_unit( &wr, ec );
+  for( i = ( long long int )( 64/ak_wpoint_pow_window )*size - 1; i >= 0; i-- ) {
+     digit = ( k[i >> 4] >> ( ak_wpoint_pow_window*( i&0xf )))&0xf;
+     for( j = 0; j < ak_wpoint_pow_window; j++ ) ak_wpoint_double_complete( &wr, b3, ec );
+
+    /* выбираем точку [digit]P, просматривая всю таблицу */
+     memset( &wt, 0, sizeof( struct wpoint ));
+     for( j = 0; j < ak_wpoint_pow_table_size; j++ ) {
+        mask = ( ak_uint64 )0 - ((( digit^j ) - 1 ) >> 63 );
+        for( l = 0; l < ec->size; l++ ) {
+           wt.x[l] |= table[j].x[l]&mask;
+           wt.y[l] |= table[j].y[l]&mask;
+           wt.z[l] |= table[j].z[l]&mask;
+        }
+     }
+     ak_wpoint_add_complete( &wr, &wt, b3, ec );
+  }
+  ak_wpoint_set_wpoint( wq, &wr, ec );
+
+  memset( &wt, 0, sizeof( struct wpoint ));
+  memset( table, 0, sizeof( table ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет кратную точку \f$ [k]P \f$ скрученной кривой Эдвардса методом
+    фиксированного окна (аналог функции ak_wpoint_pow_fixed_window()). Формулы сложения
+    на кривой Эдвардса полны для всех точек кривой, поэтому функция может применяться к точкам
+    любого порядка.
+
+    @param ep Точка \f$ P \f$, в которую также помещается результат.
+    @param k Степень кратности.
+    @param size Размер степени \f$ k \f$ в машинных словах.
+    @param ed Параметры кривой Эдвардса.
+    @param ec Эллиптическая кривая в форме Вейерштрасса.                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_epoint_pow_fixed_window( ak_epoint ep, ak_uint64 *k, size_t size,
+                                                 const struct edwards_params *ed, ak_wcurve ec )
+{
+  long long int i;
+  size_t j, l;
+  ak_uint64 digit, mask;
+  struct epoint et, table[ak_wpoint_pow_table_size];
+
+ /* вычисляем точки [j]P; в поле t хранится величина dT */
+  memset( table, 0, sizeof( struct epoint ));
+  ak_wcurve_set_montgomery_one( table[0].y, ec );
+  memcpy( table[0].z, table[0].y, ec->size*sizeof( ak_uint64 ));
+  memcpy( &et, ep, sizeof( struct epoint ));
+  for( j = 1; j < ak_wpoint_pow_table_size; j++ ) {
+     if( j > 1 ) ak_epoint_add( &et, table[1].x, table[1].y, table[1].z, table[1].t, ec );
+     memcpy( table+j, &et, sizeof( struct epoint ));
+     ec->mul( table[j].t, et.t, ( ak_uint64 *)ed->d, ec->p, ec->n, ec->size );
+  }
+
+ /* нейтральный элемент (0:1:1:0) */
+  memcpy( ep, table, sizeof( struct epoint ));
+  for( i = ( long long int )( 64/ak_wpoint_pow_window )*size - 1; i >= 0; i-- ) {
+     digit = ( k[i >> 4] >> ( ak_wpoint_pow_window*( i&0xf )))&0xf;
+     for( j = 0; j < ak_wpoint_pow_window; j++ ) ak_epoint_double( ep, ec );
+
+    /* выбираем точку [digit]P, просматривая всю таблицу */
+     memset( &et, 0, sizeof( struct epoint ));
+     for( j = 0; j < ak_wpoint_pow_table_size; j++ ) {
+        mask = ( ak_uint64 )0 - ((( digit^j ) - 1 ) >> 63 );
+        for( l = 0; l < ec->size; l++ ) {
+           et.x[l] |= table[j].x[l]&mask;
+           et.y[l] |= table[j].y[l]&mask;
+           et.z[l] |= table[j].z[l]&mask;
+           et.t[l] |= table[j].t[l]&mask;
+        }
+     }
+     ak_epoint_add( ep, et.x, et.y, et.z, et.t, ec );
+  }
+
+  memset( &et, 0, sizeof( struct epoint ));
+  memset( table, 0, sizeof( table ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Для заданной точки \f$ P = (x:y:z) \f$ и заданного целого числа (вычета) \f$ k \f$
+    функция вычисляет кратную точку \f$ Q \f$, удовлетворяющую
+    равенству \f$  Q = [k]P = \underbrace{P+ \cdots + P}_{k}\f$.
+
+    При вычислении используется метод фиксированного окна с выбором точек из таблицы
+    с помощью масок и полными формулами сложения, поэтому время работы функции не зависит
+    от вида числа \f$ k \f$:
+     \li для кривых нечетного порядка вычисления выполняются на кривой в форме Вейерштрасса,
+     \li для кривых, эквивалентных скрученным кривым Эдвардса (paramSetA и paramSetC
+     из Р 50.1.114-2016), вычисления выполняются на кривой Эдвардса,
+     \li в остальных случаях (а также для бесконечно удаленной точки и точек второго порядка
+     на кривых Эдвардса) используется лесенка Монтгомери, см. ak_wpoint_pow_montgomery().
+
+    \b Для \b информации:
+     \li Функция не приводит результирующую точку \f$ Q \f$ к аффинной форме.
+     \li Исходная точка \f$ P \f$ и результирующая точка \f$ Q \f$ могут совпадать.
+
+    @param wq Точка \f$ Q \f$, в которую помещается результат.
+    @param wp Точка \f$ P \f$, которая возводится в степень.
+    @param k Степень кратности.
+    @param size Размер степени \f$ k \f$ в машинных словах - значение, как правило,
+    задаваемое константой \ref ak_mpzn256_size или \ref ak_mpzn512_size. В общем случае
+    может приниимать любое неотрицательное значение.
+    @param ec Эллиптическая кривая, на которой происходят вычисления                               */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_wpoint_pow( ak_wpoint wq, ak_wpoint wp, ak_uint64 *k, size_t size, ak_wcurve ec )
+{
+  struct epoint ep;
+  const struct edwards_params *ed = NULL;
+
+  if( ec->cofactor == 1 ) {
+    ak_wpoint_pow_fixed_window( wq, wp, k, size, ec );
+    return;
+  }
+  if((( ed = ak_wcurve_get_edwards_params( ec )) != NULL ) &&
+                                                      ak_epoint_set_wpoint( &ep, wp, ed, ec )) {
+    ak_epoint_pow_fixed_window( &ep, k, size, ed, ec );
+    ak_wpoint_set_epoint( wq, &ep, ed, ec );
+    memset( &ep, 0, sizeof( struct epoint ));
+    return;
+  }
+  ak_wpoint_pow_montgomery( wq, wp, k, size, ec );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет точку \f$ [k]P \f$ скрученной кривой Эдвардса, где \f$ P \f$ образ
+    образующей точки кривой, используя таблицу точек кривой Эдвардса
+    (аналог функции ak_wpoint_pow_base()). Выбор точек из таблицы выполняется с помощью масок,
+    поэтому время работы функции не зависит от значения \f$ k \f$.
+
+    @param ep Точка, в которую помещается результат.
+    @param k Степень кратности.
+    @param size Размер степени \f$ k \f$ в машинных словах.
+    @param tb Таблица кратных точек, содержащая точки кривой Эдвардса.                             */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_epoint_pow_base( ak_epoint ep, ak_uint64 *k, size_t size, ak_wcurve_table tb )
+{
+  struct epoint eq;
+  ak_wcurve ec = tb->wc;
+  ak_uint64 *ptr, digit, mask;
+  size_t i, j, l, rows = 64*size/ak_wcurve_table_window;
+
+ /* нейтральный элемент (0:1:1:0) */
+  memset( ep, 0, sizeof( struct epoint ));
+  memcpy( ep->y, tb->one, ec->size*sizeof( ak_uint64 ));
+  memcpy( ep->z, tb->one, ec->size*sizeof( ak_uint64 ));
+
+  memset( &eq, 0, sizeof( struct epoint ));
+  for( i = 0; i < rows; i++ ) {
+     digit = ( k[i >> 4] >> ( ak_wcurve_table_window*( i&0xf )))&0xf;
+
+    /* выбираем точку (u, v, duv), просматривая всю строку таблицы;
+       при нулевом значении digit формируем нейтральный элемент (0, 1, 0) */
+     mask = ( ak_uint64 )0 - (( digit - 1 ) >> 63 );
+     for( l = 0; l < ec->size; l++ ) {
+        eq.x[l] = eq.t[l] = 0;
+        eq.y[l] = tb->one[l]&mask;
+     }
+     ptr = tb->epoints + 3*i*ak_wcurve_table_row_size*ec->size;
+     for( j = 1; j <= ak_wcurve_table_row_size; j++, ptr += 3*ec->size ) {
+        mask = ( ak_uint64 )0 - ((( digit^j ) - 1 ) >> 63 );
+        for( l = 0; l < ec->size; l++ ) {
+           eq.x[l] |= ptr[l]&mask;
+           eq.y[l] |= ptr[ec->size+l]&mask;
+           eq.t[l] |= ptr[2*ec->size+l]&mask;
+        }
+     }
+     ak_epoint_add( ep, eq.x, eq.y, NULL, eq.t, ec );
+  }
+  memset( &eq, 0, sizeof( struct epoint ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Для образующей точки \f$ P \f$ эллиптической кривой и заданного целого числа (вычета) \f$ k \f$
+    функция вычисляет кратную точку \f$ Q = [k]P \f$.
+
+    Вычет \f$ k \f$ представляется в виде \f$ k = \sum k_i 16^i\f$, где \f$ 0 \leq k_i < 16\f$,
+    и искомая точка вычисляется как сумма \f$ Q = \sum [k_i16^i]P \f$ точек, взятых
+    из предвычисленной таблицы. Таблица для каждой кривой создается при первом обращении.
+    Для выбора точки из таблицы просматривается вся строка таблицы (выбор выполняется
+    с помощью масок), сложение выполняется по полным формулам, поэтому время работы функции
+    не зависит от значения \f$ k \f$.
+
+    Если таблица не может быть создана, то используется функция ak_wpoint_pow().
+    Для кривых, бирационально эквивалентных скрученным кривым Эдвардса (paramSetA и paramSetC
+    из Р 50.1.114-2016), сложение точек выполняется на кривой Эдвардса в расширенных
+    координатах, а результат отображается обратно в точку кривой в форме Вейерштрасса.
+
+    \b Для \b информации: функция не приводит результирующую точку \f$ Q \f$ к аффинной форме.
+
+    @param wq Точка \f$ Q \f$, в которую помещается результат.
+    @param k Степень кратности.
+    @param size Размер степени \f$ k \f$ в машинных словах; значение не должно превышать
+    размера параметров кривой.
+    @param ec Эллиптическая кривая, на которой происходят вычисления                               */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_wpoint_pow_base( ak_wpoint wq, ak_uint64 *k, size_t size, ak_wcurve ec )
+{
+  struct wpoint wp;
+  struct epoint ep;
+  ak_uint64 *ptr, digit, mask;
+  ak_wcurve_table tb = NULL;
+  size_t i, j, l, rows = 64*size/ak_wcurve_table_window;
+
+  if(( size > ec->size ) || (( tb = ak_wcurve_table_get( ec )) == NULL )) {
+    ak_wpoint_pow( wq, &ec->point, k, size, ec );
+    return;
+  }
+  if( tb->epoints != NULL ) {
+    ak_epoint_pow_base( &ep, k, size, tb );
+    ak_wpoint_set_epoint( wq, &ep, tb->ed, ec );
+    memset( &ep, 0, sizeof( struct epoint ));
+    return;
+  }
+
+  ak_wpoint_set_as_unit( wq, ec );
+  memset( &wp, 0, sizeof( struct wpoint ));
+  for( i = 0; i < rows; i++ ) {
+     digit = ( k[i >> 4] >> ( ak_wcurve_table_window*( i&0xf )))&0xf;
+
+    /* выбираем точку [digit*16^i]P, просматривая всю строку таблицы */
+     memset( wp.x, 0, ec->size*sizeof( ak_uint64 ));
+     memset( wp.y, 0, ec->size*sizeof( ak_uint64 ));
+     ptr = tb->points + 2*i*ak_wcurve_table_row_size*ec->size;
+     for( j = 1; j <= ak_wcurve_table_row_size; j++, ptr += 2*ec->size ) {
+        mask = ( ak_uint64 )0 - ((( digit^j ) - 1 ) >> 63 );
+        for( l = 0; l < ec->size; l++ ) {
+           wp.x[l] |= ptr[l]&mask;
+           wp.y[l] |= ptr[ec->size+l]&mask;
+        }
+     }
+    /* при нулевом значении digit формируем бесконечно удаленную точку (0:1:0) */
+     mask = ( ak_uint64 )0 - (( digit - 1 ) >> 63 );
+     for( l = 0; l < ec->size; l++ ) {
+        wp.y[l] |= tb->one[l]&mask;
+        wp.z[l] = tb->one[l]&(~mask);
+     }
+     ak_wpoint_add_complete( wq, &wp, tb->b3, ec );
+  }
+  memset( &wp, 0, sizeof( struct wpoint ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Ширина окна при представлении вычета в несмежной форме (wNAF). */
+ #define ak_wcurve_wnaf_window  (5)
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет представление вычета \f$ k \f$ в виде \f$ k = \sum_{i} k_i 2^i \f$, где
+    каждая цифра \f$ k_i \f$ либо равна нулю, либо является нечетным числом, удовлетворяющим
+    неравенству \f$ |k_i| < 2^{w-1}\f$; среди любых \f$ w \f$ последовательных цифр
+    не более одной отлично от нуля (представление wNAF).
+
+    @param naf Массив, в который помещаются цифры представления; под массив должна быть
+    заранее выделена память для хранения `64*size+1` значений.
+    @param k Вычет, для которого вычисляется представление.
+    @param size Размер вычета в машинных словах.
+    @return Функция возвращает количество цифр в представлении.                                    */
+/* ----------------------------------------------------------------------------------------------- */
+ static size_t ak_mpzn_to_wnaf( int *naf, ak_uint64 *k, const size_t size )
+{
+  int digit = 0;
+  ak_uint64 t[ak_mpzn512_size+1], u, cy;
+  size_t i, len = 0;
+
+  memcpy( t, k, size*sizeof( ak_uint64 ));
+  t[size] = 0;
+  while( !ak_mpzn_cmp_ui( t, size+1, 0 )) {
+    if( t[0]&1 ) {
+      digit = ( int )( t[0]&(( 1 << ak_wcurve_wnaf_window ) - 1 ));
+      if( digit >= ( 1 << ( ak_wcurve_wnaf_window - 1 )))
+        digit -= ( 1 << ak_wcurve_wnaf_window );
+     /* вычитаем из t значение цифры */
+      if( digit > 0 ) {
+        u = t[0]; t[0] -= ( ak_uint64 )digit; cy = t[0] > u;
+        for( i = 1; cy && ( i <= size ); i++ ) { cy = ( t[i] == 0 ); t[i]--; }
+      } else {
+          u = t[0]; t[0] += ( ak_uint64 )( -digit ); cy = t[0] < u;
+          for( i = 1; cy && ( i <= size ); i++ ) { t[i]++; cy = ( t[i] == 0 ); }
+        }
+    } else digit = 0;
+    naf[len++] = digit;
+   /* сдвигаем t на один разряд вправо */
+    for( i = 0; i < size; i++ ) t[i] = ( t[i] >> 1 )^( t[i+1] << 63 );
+    t[size] >>= 1;
+  }
+ return len;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция прибавляет к точке \f$ R \f$ точки \f$ [k_i16^i]Q \f$, взятые из таблицы кратных
+    точки \f$ Q \f$, то есть вычисляет \f$ R + [k]Q \f$. Нулевые цифры вычета \f$ k \f$
+    пропускаются, поэтому время работы функции зависит от \f$ k \f$.
+
+    @param wr Точка \f$ R \f$, к которой прибавляется результат.
+    @param k Степень кратности.
+    @param points Таблица кратных точки \f$ Q \f$.
+    @param one Единица в представлении Монтгомери.
+    @param size Размер степени \f$ k \f$ в машинных словах.
+    @param ec Эллиптическая кривая, на которой происходят вычисления                               */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_wpoint_add_table_multiples( ak_wpoint wr, ak_uint64 *k, ak_uint64 *points,
+                                                 ak_uint64 *one, size_t size, ak_wcurve ec )
+{
+  size_t j;
+  struct wpoint wp;
+  ak_uint64 digit, *ptr;
+  const size_t rows = 64*size/ak_wcurve_table_window;
+
+  memcpy( wp.z, one, ec->size*sizeof( ak_uint64 ));
+  for( j = 0; j < rows; j++ ) {
+     digit = ( k[j >> 4] >> ( ak_wcurve_table_window*( j&0xf )))&0xf;
+     if( digit == 0 ) continue;
+     ptr = points + 2*( j*ak_wcurve_table_row_size + digit - 1 )*ec->size;
+     memcpy( wp.x, ptr, ec->size*sizeof( ak_uint64 ));
+     memcpy( wp.y, ptr + ec->size, ec->size*sizeof( ak_uint64 ));
+     ak_wpoint_add( wr, &wp, ec );
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет точку \f$ [k_1]P + [k_2]Q \f$ скрученной кривой Эдвардса
+    (аналог функции ak_wpoint_pow_sum()), где \f$ P \f$ образ образующей точки кривой,
+    а \f$ Q \f$ образ заданной точки кривой в форме Вейерштрасса.
+
+    @param ep Точка, в которую помещается результат.
+    @param k1 Степень кратности образующей точки.
+    @param wq Точка \f$ Q \f$ кривой в форме Вейерштрасса.
+    @param k2 Степень кратности точки \f$ Q \f$.
+    @param size Размер степеней \f$ k_1, k_2 \f$ в машинных словах.
+    @param tb Таблица кратных точек, содержащая точки кривой Эдвардса.
+    @return Функция возвращает \ref ak_false, если точка \f$ Q \f$ не может быть отображена
+    в точку кривой Эдвардса. В противном случае возвращается \ref ak_true.                          */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_epoint_pow_sum( ak_epoint ep, ak_uint64 *k1, ak_wpoint wq, ak_uint64 *k2,
+                                                              size_t size, ak_wcurve_table tb )
+{
+  long long int i;
+  int naf[64*ak_mpzn512_size+1];
+  ak_wcurve ec = tb->wc;
+  ak_mpznmax x, t, zero = ak_mpznmax_zero;
+  ak_uint64 digit, *ptr;
+  struct epoint eq, e2, tq[1 << ( ak_wcurve_wnaf_window - 2 )];
+  size_t j, len;
+  const size_t rows = 64*size/ak_wcurve_table_window;
+
+  if( !ak_epoint_set_wpoint( &eq, wq, tb->ed, ec )) return ak_false;
+
+ /* вычисляем нечетные кратные Q, 3Q, 5Q, ...; в поле t хранится величина dT */
+  memcpy( &e2, &eq, sizeof( struct epoint ));
+  ak_epoint_double( &e2, ec );
+  ec->mul( e2.t, e2.t, ( ak_uint64 *)tb->ed->d, ec->p, ec->n, ec->size );
+  for( j = 0; j < ( 1 << ( ak_wcurve_wnaf_window - 2 )); j++ ) {
+     if( j > 0 ) ak_epoint_add( &eq, e2.x, e2.y, e2.z, e2.t, ec );
+     memcpy( tq+j, &eq, sizeof( struct epoint ));
+     ec->mul( tq[j].t, eq.t, ( ak_uint64 *)tb->ed->d, ec->p, ec->n, ec->size );
+  }
+
+ /* вычисляем [k2]Q */
+  len = ak_mpzn_to_wnaf( naf, k2, size );
+  memset( ep, 0, sizeof( struct epoint ));
+  memcpy( ep->y, tb->one, ec->size*sizeof( ak_uint64 ));
+  memcpy( ep->z, tb->one, ec->size*sizeof( ak_uint64 ));
+  for( i = ( long long int )len-1; i >= 0; i-- ) {
+     ak_epoint_double( ep, ec );
+     if( naf[i] > 0 )
+       ak_epoint_add( ep, tq[naf[i] >> 1].x, tq[naf[i] >> 1].y,
+                                                       tq[naf[i] >> 1].z, tq[naf[i] >> 1].t, ec );
+     if( naf[i] < 0 ) { /* -(X:Y:Z:T) = (-X:Y:Z:-T) */
+       ak_mpzn_sub_montgomery( x, zero, tq[( -naf[i] ) >> 1].x, ec->p, ec->size );
+       ak_mpzn_sub_montgomery( t, zero, tq[( -naf[i] ) >> 1].t, ec->p, ec->size );
+       ak_epoint_add( ep, x, tq[( -naf[i] ) >> 1].y, tq[( -naf[i] ) >> 1].z, t, ec );
+     }
+  }
+
+ /* прибавляем [k1]P, используя таблицу точек кривой Эдвардса */
+  for( j = 0; j < rows; j++ ) {
+     digit = ( k1[j >> 4] >> ( ak_wcurve_table_window*( j&0xf )))&0xf;
+     if( digit == 0 ) continue;
+     ptr = tb->epoints + 3*( j*ak_wcurve_table_row_size + digit - 1 )*ec->size;
+     ak_epoint_add( ep, ptr, ptr + ec->size, NULL, ptr + 2*ec->size, ec );
+  }
+ return ak_true;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Для образующей точки \f$ P \f$ эллиптической кривой, заданной точки \f$ Q \f$ и
+    двух вычетов \f$ k_1, k_2 \f$ функция вычисляет точку \f$ R = [k_1]P + [k_2]Q \f$.
+
+    Вычисления выполняются одновременно: кратная точка \f$ [k_2]Q \f$ вычисляется с помощью
+    представления вычета \f$ k_2 \f$ в несмежной форме (wNAF) и таблицы нечетных кратных
+    точки \f$ Q \f$, вырабатываемой при каждом вызове функции, а точки \f$ [k_{1,i}16^i]P \f$
+    берутся из предвычисленной таблицы образующей точки (см. ak_wpoint_pow_base())
+    и прибавляются к тому же результату. Как и в функции ak_wpoint_pow_base(), для кривых,
+    эквивалентных скрученным кривым Эдвардса, вычисления выполняются на кривой Эдвардса.
+
+    \warning Время работы функции зависит от значений \f$ k_1, k_2 \f$, поэтому функция
+    предназначена только для вычислений с открытыми данными, например, при проверке
+    электронной подписи.
+
+    \b Для \b информации: функция не приводит результирующую точку \f$ R \f$ к аффинной форме.
+
+    @param wr Точка \f$ R \f$, в которую помещается результат.
+    @param k1 Степень кратности образующей точки.
+    @param wq Точка \f$ Q \f$.
+    @param k2 Степень кратности точки \f$ Q \f$.
+    @param size Размер степеней \f$ k_1, k_2 \f$ в машинных словах; значение не должно превышать
+    размера параметров кривой.
+    @param ec Эллиптическая кривая, на которой происходят вычисления                               */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_wpoint_pow_sum( ak_wpoint wr, ak_uint64 *k1, ak_wpoint wq, ak_uint64 *k2,
+                                                                    size_t size, ak_wcurve ec )
+{
+  long long int i;
+  int naf[64*ak_mpzn512_size+1];
+  struct epoint ep;
+  ak_wcurve_table tb = NULL;
+  struct wpoint wp, tq[1 << ( ak_wcurve_wnaf_window - 2 )];
+  size_t j, len;
+
+  if(( size > ec->size ) || (( tb = ak_wcurve_table_get( ec )) == NULL )) {
+    ak_wpoint_pow( &wp, wq, k2, size, ec );
+    ak_wpoint_pow( wr, &ec->point, k1, size, ec );
+    ak_wpoint_add( wr, &wp, ec );
+    return;
+  }
+  if(( tb->epoints != NULL ) && ak_epoint_pow_sum( &ep, k1, wq, k2, size, tb )) {
+    ak_wpoint_set_epoint( wr, &ep, tb->ed, ec );
+    return;
+  }
+
+ /* вычисляем нечетные кратные Q, 3Q, 5Q, ... */
+  ak_wpoint_set_wpoint( tq, wq, ec );
+  ak_wpoint_set_wpoint( &wp, wq, ec );
+  ak_wpoint_double( &wp, ec );
+  for( j = 1; j < ( 1 << ( ak_wcurve_wnaf_window - 2 )); j++ ) {
+     ak_wpoint_set_wpoint( tq+j, tq+j-1, ec );
+     ak_wpoint_add( tq+j, &wp, ec );
+  }
+
+ /* вычисляем [k2]Q */
+  len = ak_mpzn_to_wnaf( naf, k2, size );
+  ak_wpoint_set_as_unit( wr, ec );
+  for( i = ( long long int )len-1; i >= 0; i-- ) {
+     ak_wpoint_double( wr, ec );
+     if( naf[i] > 0 ) ak_wpoint_add( wr, tq + ( naf[i] >> 1 ), ec );
+     if( naf[i] < 0 ) {
+       ak_wpoint_set_wpoint( &wp, tq + (( -naf[i] ) >> 1 ), ec );
+       ak_mpzn_sub( wp.y, ec->p, wp.y, ec->size );
+       ak_wpoint_add( wr, &wp, ec );
+     }
+  }
+
+ /* прибавляем [k1]P, используя таблицу образующей точки */
+  ak_wpoint_add_table_multiples( wr, k1, tb->points, tb->one, size, ec );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция создает таблицу, содержащую аффинные координаты точек \f$ [j\cdot 16^i]Q \f$
+    для \f$ i = 0, \ldots, 16\cdot\text{size}-1 \f$ и \f$ j = 1, \ldots, 15 \f$. Таблица
+    используется функцией ak_wpoint_pow_sum_table() и занимает
+    \f$ 61440 \f$ октетов для кривых с 256-ти битным модулем и
+    \f$ 245760 \f$ октетов для кривых с 512-ти битным модулем.
+
+    @param wq Точка \f$ Q \f$, принадлежащая подгруппе порядка \f$ q \f$.
+    @param ec Эллиптическая кривая, которой принадлежит точка.
+    @return Указатель на созданную таблицу. Память должна быть освобождена
+    с помощью функции free(). В случае ошибки возвращается NULL.                                   */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_uint64 *ak_wpoint_table_new( ak_wpoint wq, ak_wcurve ec )
+{
+  ak_uint64 *points = NULL;
+  ak_mpznmax b3;
+
+  if( wq == NULL ) {
+    ak_error_message( ak_error_null_pointer, __func__, "using null pointer to elliptic curve point" );
+    return NULL;
+  }
+  if( ec == NULL ) {
+    ak_error_message( ak_error_null_pointer, __func__, "using null pointer to elliptic curve" );
+    return NULL;
+  }
+  if(( points = malloc( ak_wcurve_table_words( ec->size )*sizeof( ak_uint64 ))) == NULL ) {
+    ak_error_message( ak_error_out_of_memory, __func__, "incorrect memory allocation" );
+    return NULL;
+  }
+  ak_mpzn_lshift_montgomery( b3, ec->b, ec->p, ec->size );
+  ak_mpzn_add_montgomery( b3, b3, ec->b, ec->p, ec->size );
+  if( ak_wcurve_table_build( points, wq, b3, ec ) != ak_error_ok ) {
+    ak_error_message( ak_error_get_value(), __func__, "incorrect creation of precomputed table" );
+    free( points );
+    return NULL;
+  }
+ return points;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет точку \f$ R = [k_1]P + [k_2]Q \f$, где \f$ P \f$ образующая точка кривой,
+    а для точки \f$ Q \f$ заранее создана таблица кратных точек (см. ak_wpoint_table_new()).
+    В отличие от функции ak_wpoint_pow_sum() вычисления не содержат удвоений точек,
+    а количество сложений примерно в два раза меньше.
+
+    \warning Время работы функции зависит от значений \f$ k_1, k_2 \f$, поэтому функция
+    предназначена только для вычислений с открытыми данными.
+
+    @param wr Точка \f$ R \f$, в которую помещается результат.
+    @param k1 Степень кратности образующей точки.
+    @param k2 Степень кратности точки \f$ Q \f$.
+    @param qtable Таблица кратных точки \f$ Q \f$.
+    @param size Размер степеней \f$ k_1, k_2 \f$ в машинных словах; значение не должно превышать
+    размера параметров кривой.
+    @param ec Эллиптическая кривая, на которой происходят вычисления                               */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_wpoint_pow_sum_table( ak_wpoint wr, ak_uint64 *k1, ak_uint64 *k2, ak_uint64 *qtable,
+                                                                    size_t size, ak_wcurve ec )
+{
+  struct wpoint wp;
+  ak_mpznmax one = ak_mpznmax_zero;
+  ak_wcurve_table tb = NULL;
+
+  ak_wcurve_set_montgomery_one( one, ec );
+  ak_wpoint_set_as_unit( wr, ec );
+  ak_wpoint_add_table_multiples( wr, k2, qtable, one, size, ec );
+
+  if(( size > ec->size ) || (( tb = ak_wcurve_table_get( ec )) == NULL )) {
+    ak_wpoint_pow( &wp, &ec->point, k1, size, ec );
+    ak_wpoint_add( wr, &wp, ec );
+  } else ak_wpoint_add_table_multiples( wr, k1, tb->points, tb->one, size, ec );
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*                                                                                    ak_curves.c  */
 /* ----------------------------------------------------------------------------------------------- */
@@ -1318,6 +1318,170 @@
  return result;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция продолжает вычисления с заданного промежуточного состояния `state` (которое
+    не изменяется), обрабатывает ровно один 64-х октетный блок `m` и завершает вычисление хеш-кода.
+    Функция не выполняет никаких проверок и не использует контекст итерационного сжатия,
+    что позволяет применять ее во внутренних циклах, например, в реализации алгоритма PBKDF2,
+    где многократно вычисляется хеш-код от сообщения фиксированной длины.
+
+    \param state Промежуточное состояние функции хеширования Стрибог.
+    \param m Обрабатываемый блок данных длины 64 октета.
+    \param out Массив, куда помещается результат; длина массива должна быть не менее 64 октетов,
+    для функции Стрибог256 заполняются только первые 32 октета.
+    Массивы `m` и `out` могут совпадать.                                                          */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_hash_streebog_block64( const ak_streebog state, const ak_uint64 *m, ak_uint64 *out )
+{
+  struct streebog sx;
+  ak_uint64 pad[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+
+  ((ak_uint8 *)pad)[0] = 1; /* дополнение пустого остатка сообщения */
+  memcpy( &sx, state, sizeof( struct streebog ));
+
+ /* полный блок данных */
+  ak_hash_context_streebog_g( &sx, sx.n, m );
+  ak_hash_context_streebog_add( &sx, 512 );
+  ak_hash_context_streebog_sadd( &sx, m );
+ /* завершение вычислений (остаток сообщения имеет нулевую длину) */
+  ak_hash_context_streebog_g( &sx, sx.n, pad );
+  ak_hash_context_streebog_sadd( &sx, pad );
+  ak_hash_context_streebog_g( &sx, NULL, sx.n );
+  ak_hash_context_streebog_g( &sx, NULL, sx.sigma );
+
+  if( sx.hsize == 64 ) memcpy( out, sx.h, 64 );
+    else memcpy( out, sx.h+4, 32 );
+  memset( &sx, 0, sizeof( struct streebog ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Преобразование G, выполняемое одновременно для нескольких независимых состояний.
+    \details Вычисления для различных состояний чередуются внутри каждого раунда, что позволяет
+    процессору совмещать во времени обращения к таблицам независимых потоков данных.
+    \param ctx Массив промежуточных состояний.
+    \param withn Флаг использования вектора n в качестве ключа первого раунда.
+    \param m Массив указателей на обрабатываемые блоки данных.
+    \param lanes Количество состояний, не более \ref ak_hash_streebog_max_lanes.                 */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_hash_context_streebog_g_lanes( ak_streebog ctx, const bool_t withn,
+                                                       const ak_uint64 **m, const size_t lanes )
+{
+   size_t idx = 0, ldx = 0;
+   ak_uint64 K[ak_hash_streebog_max_lanes][8],
+             T[ak_hash_streebog_max_lanes][8], B[8];
+
+   for( ldx = 0; ldx < lanes; ldx++ ) {
+      if( withn ) {
+        ak_hash_context_streebog_x( B, ctx[ldx].h, ctx[ldx].n );
+        ak_hash_context_streebog_lps( K[ldx], B );
+      }
+       else ak_hash_context_streebog_lps( K[ldx], ctx[ldx].h );
+      for( idx = 0; idx < 8; idx++ ) T[ldx][idx] = m[ldx][idx];
+   }
+
+   for( idx = 0; idx < 12; idx++ ) {
+      for( ldx = 0; ldx < lanes; ldx++ ) {
+         ak_hash_context_streebog_x( B, T[ldx], K[ldx] );
+         ak_hash_context_streebog_lps( T[ldx], B );
+         ak_hash_context_streebog_x( B, K[ldx], streebog_c[idx] );
+         ak_hash_context_streebog_lps( K[ldx], B );
+      }
+   }
+   for( ldx = 0; ldx < lanes; ldx++ )
+      for ( idx = 0; idx < 8; idx++ ) ctx[ldx].h[idx] ^= T[ldx][idx] ^ K[ldx][idx] ^ m[ldx][idx];
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция выполняет те же вычисления, что и функция ak_hash_streebog_block64(),
+    одновременно для нескольких независимых состояний и блоков данных.
+
+    \param state Массив промежуточных состояний (не изменяется).
+    \param data Массив обрабатываемых блоков; результат помещается на место исходных данных.
+    \param lanes Количество обрабатываемых блоков, от 1 до \ref ak_hash_streebog_max_lanes.      */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_hash_streebog_block64_lanes( const ak_streebog *state,
+                                                       ak_uint64 (*data)[8], const size_t lanes )
+{
+  size_t ldx = 0;
+  const ak_uint64 *m[ak_hash_streebog_max_lanes];
+  struct streebog sx[ak_hash_streebog_max_lanes];
+  ak_uint64 pad[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+
+  ((ak_uint8 *)pad)[0] = 1;
+  for( ldx = 0; ldx < lanes; ldx++ ) {
+     memcpy( sx+ldx, state[ldx], sizeof( struct streebog ));
+     m[ldx] = data[ldx];
+  }
+ /* полный блок данных */
+  ak_hash_context_streebog_g_lanes( sx, ak_true, m, lanes );
+  for( ldx = 0; ldx < lanes; ldx++ ) {
+     ak_hash_context_streebog_add( sx+ldx, 512 );
+     ak_hash_context_streebog_sadd( sx+ldx, data[ldx] );
+     m[ldx] = pad;
+  }
+ /* завершение вычислений */
+  ak_hash_context_streebog_g_lanes( sx, ak_true, m, lanes );
+  for( ldx = 0; ldx < lanes; ldx++ ) {
+     ak_hash_context_streebog_sadd( sx+ldx, pad );
+     m[ldx] = sx[ldx].n;
+  }
+  ak_hash_context_streebog_g_lanes( sx, ak_false, m, lanes );
+  for( ldx = 0; ldx < lanes; ldx++ ) m[ldx] = sx[ldx].sigma;
+  ak_hash_context_streebog_g_lanes( sx, ak_false, m, lanes );
+
+  for( ldx = 0; ldx < lanes; ldx++ ) {
+     if( sx[ldx].hsize == 64 ) memcpy( data[ldx], sx[ldx].h, 64 );
+       else memcpy( data[ldx], sx[ldx].h+4, 32 );
+  }
+  memset( sx, 0, sizeof( sx ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция продолжает вычисления с заданных промежуточных состояний (которые не изменяются),
+    обрабатывает последние блоки сообщений одинаковой длины `size` (менее 64-х октетов)
+    и завершает вычисление хеш-кодов. Такие вычисления многократно выполняются, например,
+    при выработке производных ключей с помощью алгоритма HMAC.
+
+    \param state Массив промежуточных состояний (не изменяется).
+    \param data Массив обрабатываемых блоков; результат помещается на место исходных данных.
+    \param size Длина обрабатываемых блоков в октетах, должна быть меньше 64.
+    \param lanes Количество обрабатываемых блоков, от 1 до \ref ak_hash_streebog_max_lanes.      */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_hash_streebog_final_lanes( const ak_streebog *state,
+                                  ak_uint64 (*data)[8], const size_t size, const size_t lanes )
+{
+  size_t ldx = 0;
+  const ak_uint64 *m[ak_hash_streebog_max_lanes];
+  struct streebog sx[ak_hash_streebog_max_lanes];
+  ak_uint64 block[ak_hash_streebog_max_lanes][8];
+
+  for( ldx = 0; ldx < lanes; ldx++ ) {
+     memcpy( sx+ldx, state[ldx], sizeof( struct streebog ));
+     memset( block[ldx], 0, 64 );
+     memcpy( block[ldx], data[ldx], size );
+     (( ak_uint8 * )block[ldx])[size] = 1; /* дополнение */
+     m[ldx] = block[ldx];
+  }
+ /* неполный блок данных */
+  ak_hash_context_streebog_g_lanes( sx, ak_true, m, lanes );
+  for( ldx = 0; ldx < lanes; ldx++ ) {
+     ak_hash_context_streebog_add( sx+ldx, size << 3 );
+     ak_hash_context_streebog_sadd( sx+ldx, block[ldx] );
+     m[ldx] = sx[ldx].n;
+  }
+ /* завершение вычислений */
+  ak_hash_context_streebog_g_lanes( sx, ak_false, m, lanes );
+  for( ldx = 0; ldx < lanes; ldx++ ) m[ldx] = sx[ldx].sigma;
+  ak_hash_context_streebog_g_lanes( sx, ak_false, m, lanes );
+
+  for( ldx = 0; ldx < lanes; ldx++ ) {
+     if( sx[ldx].hsize == 64 ) memcpy( data[ldx], sx[ldx].h, 64 );
+       else memcpy( data[ldx], sx[ldx].h+4, 32 );
+  }
+  memset( sx, 0, sizeof( sx ));
+  memset( block, 0, sizeof( block ));
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*                               Реализация функция класса hash                                    */
 /* ----------------------------------------------------------------------------------------------- */
@@ -17,6 +17,9 @@
 #else
  #error Library cannot be compiled without string.h header
 #endif
+#ifdef AK_HAVE_PTHREAD_H
+ #include <pthread.h>
+#endif
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Очистка контекста алгоритма hmac.
@@ -313,7 +316,8 @@
 
     \param hctx Контекст алгоритма HMAC выработки имитовставки. К моменту вызова функции контекст
     должен быть инициализирован.
-    \param generator Контекст генератора псевдо-случайных чисел.
+    \param generator Контекст генератора псевдо-случайных чисел
+    (значение NULL означает использование генератора текущего потока).
 
     @return В случае успеха возвращается значение \ref ak_error_ok. В противном случае
     возвращается код ошибки.                                                                       */
@@ -488,6 +492,117 @@
  return hctx->mctx.bsize;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Проверка параметров алгоритма PBKDF2.
+    \return В случае корректных параметров функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_hmac_pbkdf2_streebog512_check( const ak_pointer pass, const size_t pass_size,
+                               const ak_pointer salt, const size_t dklen, const ak_pointer out )
+{
+  if( pass == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                                 "using null pointer to password" );
+  if( !pass_size ) return ak_error_message( ak_error_wrong_length, __func__ ,
+                                                                   "using a zero length password" );
+  if( salt == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                                     "using null pointer to salt" );
+  if(( dklen < 32 ) || ( dklen > 64 )) return ak_error_message( ak_error_wrong_length,
+                                       __func__ , "using a wrong length for resulting key vector" );
+  if( out == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                     "using null pointer to resulting key vector" );
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Вычисление состояний функции хеширования после обработки блоков ipad и opad.
+    \details Ключ, длина которого превышает длину блока, заменяется его хеш-кодом (см. RFC 2104).
+    После выполнения функции контекст хеширования находится в состоянии `istate`.
+
+    \param ctx Контекст функции хеширования семейства Стрибог, используемый для вычислений.
+    \param key Ключ алгоритма HMAC.
+    \param key_size Длина ключа (в октетах).
+    \param istate Состояние после обработки блока ipad.
+    \param ostate Состояние после обработки блока opad.
+    \return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_hmac_streebog_states( ak_hash ctx, const ak_pointer key, const size_t key_size,
+                                                           ak_streebog istate, ak_streebog ostate )
+{
+  size_t idx = 0;
+  int error = ak_error_ok;
+  ak_uint64 ipad[8], opad[8];
+  ak_uint8 *kp = ( ak_uint8 * )ipad;
+
+  memset( ipad, 0, sizeof( ipad ));
+  if( key_size > sizeof( ipad )) {
+    if(( error = ak_hash_ptr( ctx, key, key_size, ipad, sizeof( ipad ))) != ak_error_ok ) {
+      ak_error_message( error, __func__, "incorrect hashing of long key" );
+      goto lab_exit;
+    }
+  } else memcpy( ipad, key, key_size );
+  for( idx = 0; idx < sizeof( ipad ); idx++ ) {
+     (( ak_uint8 * )opad)[idx] = kp[idx] ^ 0x5C;
+     kp[idx] ^= 0x36;
+  }
+
+ /* вычисляем промежуточные состояния после обработки блоков ipad и opad,
+    далее они используются без повторного вычисления */
+  ak_hash_clean( ctx );
+  ak_hash_update( ctx, opad, sizeof( opad ));
+  memcpy( ostate, &ctx->data.sctx, sizeof( struct streebog ));
+  ak_hash_clean( ctx );
+  ak_hash_update( ctx, ipad, sizeof( ipad ));
+  memcpy( istate, &ctx->data.sctx, sizeof( struct streebog ));
+
+  lab_exit:
+   memset( ipad, 0, sizeof( ipad ));
+   memset( opad, 0, sizeof( opad ));
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Вычисление начальных состояний и первой итерации алгоритма PBKDF2.
+    \details Функция вычисляет состояния функции хеширования Стрибог512 после обработки блоков
+    ipad и opad, а также значение U1 = hmac( pass, salt || 0x00000001 ).
+
+    \param ctx Контекст функции хеширования Стрибог512, используемый для вычислений.
+    \param istate Состояние после обработки блока ipad.
+    \param ostate Состояние после обработки блока opad.
+    \param result Массив длины 64 октета, куда помещается значение U1.
+    \return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_hmac_pbkdf2_streebog512_start( ak_hash ctx,
+                              const ak_pointer pass, const size_t pass_size, const ak_pointer salt,
+                  const size_t salt_size, ak_streebog istate, ak_streebog ostate, ak_uint64 *result )
+{
+  int error = ak_error_ok;
+
+ /* формируем ключ алгоритма hmac: длинный пароль заменяется его хеш-кодом (см. RFC 2104) */
+  if(( error = ak_hmac_streebog_states( ctx, pass, pass_size, istate, ostate )) != ak_error_ok ) {
+    ak_error_message( error, __func__, "incorrect evaluation of hmac initial states" );
+    goto lab_exit;
+  }
+
+ /* вычисляем значение первой строки U1 = hmac( salt || 0x00000001 ) */
+  memset( result, 0, 64 );
+  (( ak_uint8 * )result)[3] = 1;
+  if(( error = ak_hash_update( ctx, salt, salt_size )) != ak_error_ok ) {
+    ak_error_message( error, __func__, "incorrect updating of internal hash context" );
+    goto lab_exit;
+  }
+  if(( error = ak_hash_finalize( ctx, result, 4, result, 64 )) != ak_error_ok ) {
+    ak_error_message( error, __func__, "incorrect finalizing of internal hash context" );
+    goto lab_exit;
+  }
+  ak_hash_streebog_block64( ostate, result, result );
+
+  lab_exit:
+   ak_hash_clean( ctx );
+ return error;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Пароль должен представлять собой ненулевую строку символов в utf8
     кодировке. Размер вырабатываемого ключевого вектора может колебаться от 32-х до 64-х байт.
@@ -506,6 +621,10 @@
     @param out Указатель на массив, куда будет помещен результат; под данный массив должна быть
     заранее выделена память не менее, чем dklen байт.
 
+    \note Для ускорения вычислений функция не использует контекст struct hmac: состояния функции
+    хеширования после обработки блоков ipad и opad вычисляются один раз, а каждая итерация
+    сводится к двум вызовам функции ak_hash_streebog_block64() для сообщения длины 64 октета.
+
     @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
     возвращается код ошибки.                                                                       */
 /* ----------------------------------------------------------------------------------------------- */
@@ -513,57 +632,594 @@
          const size_t pass_size, const ak_pointer salt, const size_t salt_size, const size_t cnt,
                                                                const size_t dklen, ak_pointer out )
 {
-  struct hmac hctx;
-  ak_uint8 result[64];
-  int error = ak_error_ok;
+  struct hash ctx;
   size_t idx = 0, jdx = 0;
+  int error = ak_error_ok;
+  struct streebog istate, ostate;
+  ak_uint64 result[8];
+  ak_uint8 *rp = ( ak_uint8 * )result;
 
  /* в начале, многочисленные проверки входных параметров */
-  if( pass == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
-                                                                 "using null pointer to password" );
-  if( !pass_size ) return ak_error_message( ak_error_wrong_length, __func__ ,
-                                                                   "using a zero length password" );
-  if( salt == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
-                                                                     "using null pointer to salt" );
-  if(( dklen < 32 ) || ( dklen > 64 )) return ak_error_message( ak_error_wrong_length,
-                                       __func__ , "using a wrong length for resulting key vector" );
-  if( out == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
-                                                     "using null pointer to resulting key vector" );
- /* создаем контекст алгоритма hmac и определяем его ключ */
-  if(( error = ak_hmac_create_streebog512( &hctx )) != ak_error_ok )
-    return ak_error_message( error, __func__, "wrong creation of hmac-streebog512 key context" );
-  if(( error = ak_hmac_set_key( &hctx, pass, pass_size )) != ak_error_ok ) {
-    ak_error_message( error, __func__, "wrong initialization of hmac-streebog512 secret key" );
+  if(( error = ak_hmac_pbkdf2_streebog512_check( pass, pass_size,
+                                                             salt, dklen, out )) != ak_error_ok )
+    return error;
+
+ /* контекст функции хеширования используется только для вычисления
+    начальных состояний и первой итерации алгоритма */
+  if(( error = ak_hash_create_streebog512( &ctx )) != ak_error_ok )
+    return ak_error_message( error, __func__, "wrong creation of streebog512 hash context" );
+  if(( error = ak_hmac_pbkdf2_streebog512_start( &ctx, pass, pass_size,
+                                  salt, salt_size, &istate, &ostate, result )) != ak_error_ok ) {
+    ak_error_message( error, __func__, "incorrect evaluation of first pbkdf2 iteration" );
     goto lab_exit;
   }
+  memcpy( out, rp+64-dklen, dklen );
 
- /* начальная инициализация промежуточного вектора */
-  memset( result, 0, 64 );
-  result[3] = 1;
+ /* теперь основной цикл по значению аргумента c:
+    каждая итерация - это ровно два вызова сжатия для блока фиксированной длины */
+  for( idx = 1; idx < cnt; idx++ ) {
+     ak_hash_streebog_block64( &istate, result, result );
+     ak_hash_streebog_block64( &ostate, result, result );
+     for( jdx = 0; jdx < dklen; jdx++ ) ((ak_uint8 *)out)[jdx] ^= rp[64-dklen+jdx];
+  }
 
- /* вычисляем значение первой строки U1  */
-  if(( error = ak_hmac_clean( &hctx )) != ak_error_ok ) {
-    ak_error_message( error, __func__, "incorrect cleaning of internal hmac context");
-    goto lab_exit;
+  lab_exit:
+   memset( result, 0, sizeof( result ));
+   memset( &istate, 0, sizeof( struct streebog ));
+   memset( &ostate, 0, sizeof( struct streebog ));
+   ak_hash_destroy( &ctx );
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Выполнение группы задач алгоритма PBKDF2 с чередованием вычислений.
+    \details Итерации для всех задач группы выполняются одновременно с помощью функции
+    ak_hash_streebog_block64_lanes(); завершенные задачи исключаются из обработки.
+    \param tasks Указатель на первую задачу группы.
+    \param count Количество задач в группе, не более \ref ak_hash_streebog_max_lanes.            */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_hmac_pbkdf2_streebog512_lanes( ak_pbkdf2_task tasks, const size_t count )
+{
+  struct hash ctx;
+  int error = ak_error_ok;
+  size_t idx = 0, jdx = 0, lanes = 0;
+  ak_pbkdf2_task lt[ak_hash_streebog_max_lanes];
+  struct streebog istate[ak_hash_streebog_max_lanes], ostate[ak_hash_streebog_max_lanes];
+  ak_streebog ip[ak_hash_streebog_max_lanes], op[ak_hash_streebog_max_lanes];
+  ak_uint64 result[ak_hash_streebog_max_lanes][8];
+  size_t iter[ak_hash_streebog_max_lanes];
+
+  if(( error = ak_hash_create_streebog512( &ctx )) != ak_error_ok ) {
+    for( idx = 0; idx < count; idx++ ) tasks[idx].error = error;
+    return;
   }
-  if(( error = ak_hmac_update( &hctx, salt, salt_size )) != ak_error_ok ) {
-    ak_error_message( error, __func__, "incorrect updating of internal hmac context");
-    goto lab_exit;
+
+ /* вычисляем первые итерации и формируем перечень активных задач */
+  for( idx = 0; idx < count; idx++ ) {
+     ak_pbkdf2_task tk = tasks+idx;
+     if(( tk->error = ak_hmac_pbkdf2_streebog512_check( tk->pass, tk->pass_size,
+                                                 tk->salt, tk->dklen, tk->out )) != ak_error_ok )
+       continue;
+     if(( tk->error = ak_hmac_pbkdf2_streebog512_start( &ctx, tk->pass, tk->pass_size,
+          tk->salt, tk->salt_size, istate+lanes, ostate+lanes, result[lanes] )) != ak_error_ok )
+       continue;
+     memcpy( tk->out, (( ak_uint8 *)result[lanes])+64-tk->dklen, tk->dklen );
+     if( tk->count < 2 ) continue;
+
+     lt[lanes] = tk;
+     ip[lanes] = istate+lanes;
+     op[lanes] = ostate+lanes;
+     iter[lanes] = 1;
+     lanes++;
+  }
+
+ /* основной цикл: на каждом шаге выполняется одна итерация для каждой активной задачи */
+  while( lanes ) {
+    ak_hash_streebog_block64_lanes( ip, result, lanes );
+    ak_hash_streebog_block64_lanes( op, result, lanes );
+
+    for( idx = 0; idx < lanes; ) {
+       ak_uint8 *rp = (( ak_uint8 *)result[idx])+64-lt[idx]->dklen;
+       for( jdx = 0; jdx < lt[idx]->dklen; jdx++ ) (( ak_uint8 *)lt[idx]->out)[jdx] ^= rp[jdx];
+
+       if( ++iter[idx] < lt[idx]->count ) { idx++; continue; }
+      /* задача завершена, на ее место переносим последнюю активную задачу */
+       if( idx != --lanes ) {
+         lt[idx] = lt[lanes];
+         ip[idx] = ip[lanes];
+         op[idx] = op[lanes];
+         iter[idx] = iter[lanes];
+         memcpy( result[idx], result[lanes], 64 );
+       }
+    }
+  }
+
+  memset( result, 0, sizeof( result ));
+  memset( istate, 0, sizeof( istate ));
+  memset( ostate, 0, sizeof( ostate ));
+  ak_hash_destroy( &ctx );
+}
+
+#ifdef AK_HAVE_PTHREAD_H
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Общие данные потоков, выполняющих пакетную выработку ключей. */
+ typedef struct pbkdf2_batch {
+  /*! \brief Массив задач */
+   ak_pbkdf2_task tasks;
+  /*! \brief Общее количество задач */
+   size_t count;
+  /*! \brief Индекс первой задачи, еще не переданной на обработку */
+   size_t next;
+  /*! \brief Мьютекс, защищающий значение next */
+   pthread_mutex_t mutex;
+ } *ak_pbkdf2_batch;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция потока: последовательная обработка групп задач из общего массива. */
+/* ----------------------------------------------------------------------------------------------- */
+ static void *ak_hmac_pbkdf2_streebog512_thread( void *ptr )
+{
+  size_t first = 0;
+  ak_pbkdf2_batch batch = ( ak_pbkdf2_batch )ptr;
+
+  for( ;; ) {
+     pthread_mutex_lock( &batch->mutex );
+     first = batch->next;
+     batch->next = ak_min( batch->count, first + ak_hash_streebog_max_lanes );
+     pthread_mutex_unlock( &batch->mutex );
+
+     if( first >= batch->count ) break;
+     ak_hmac_pbkdf2_streebog512_lanes( batch->tasks + first,
+                                         ak_min( batch->count - first, ak_hash_streebog_max_lanes ));
+  }
+ return NULL;
+}
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вырабатывает ключевые векторы для массива независимых задач (пароль, соль,
+    количество итераций) в соответствии с алгоритмом PBKDF2 из Р 50.1.111-2016; результат
+    совпадает с последовательным вызовом функции ak_hmac_pbkdf2_streebog512() для каждой задачи.
+
+    Задачи разбиваются на группы по \ref ak_hash_streebog_max_lanes штук, итерации внутри группы
+    выполняются одновременно (с чередованием вычислений функции хеширования).
+    Если библиотека собрана с поддержкой pthreads и значение `threads` больше единицы,
+    группы обрабатываются заданным количеством потоков.
+
+    @param tasks Массив задач. Для каждой задачи в поле `error` помещается код ошибки
+    (или \ref ak_error_ok), результат помещается в область памяти, на которую указывает поле `out`.
+    @param count Количество задач в массиве.
+    @param threads Максимальное количество потоков; значения 0 и 1 означают, что вычисления
+    выполняются в вызывающем потоке.
+
+    @return Функция возвращает \ref ak_error_ok, если все задачи выполнены успешно. В противном
+    случае возвращается код ошибки последней из невыполненных задач.                               */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_hmac_pbkdf2_streebog512_batch( ak_pbkdf2_task tasks, const size_t count,
+                                                                             const size_t threads )
+{
+  size_t idx = 0;
+  int error = ak_error_ok;
+
+  if( tasks == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                          "using null pointer to array of tasks" );
+  if( !count ) return ak_error_message( ak_error_zero_length, __func__ ,
+                                                         "using zero length of array of tasks" );
+#ifdef AK_HAVE_PTHREAD_H
+  if( threads > 1 ) {
+    struct pbkdf2_batch batch;
+    size_t tcnt = ak_min( threads, ( count + ak_hash_streebog_max_lanes - 1 )/
+                                                                      ak_hash_streebog_max_lanes );
+    pthread_t *tid = NULL;
+
+    if(( tid = malloc( tcnt*sizeof( pthread_t ))) == NULL )
+      return ak_error_message( ak_error_out_of_memory, __func__ ,
+                                                 "incorrect memory allocation for thread handles" );
+    batch.tasks = tasks;
+    batch.count = count;
+    batch.next = 0;
+    pthread_mutex_init( &batch.mutex, NULL );
+
+   /* если поток не удалось создать, его работу выполнят остальные потоки */
+    for( idx = 0; idx < tcnt; idx++ )
+       if( pthread_create( tid+idx, NULL, ak_hmac_pbkdf2_streebog512_thread, &batch ) != 0 ) break;
+    if( idx == 0 ) ak_hmac_pbkdf2_streebog512_thread( &batch );
+    while( idx > 0 ) pthread_join( tid[--idx], NULL );
+
+    pthread_mutex_destroy( &batch.mutex );
+    free( tid );
+  } else
+#endif
+  {
+    for( idx = 0; idx < count; idx += ak_hash_streebog_max_lanes )
+       ak_hmac_pbkdf2_streebog512_lanes( tasks+idx,
+                                             ak_min( count - idx, ak_hash_streebog_max_lanes ));
+  }
+
+  for( idx = 0; idx < count; idx++ )
+     if( tasks[idx].error != ak_error_ok ) error = tasks[idx].error;
+  if( error != ak_error_ok )
+    ak_error_message( error, __func__, "some of pbkdf2 tasks are not completed" );
+
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                      функции выработки производных ключей (Р 50.1.113-2016)                     */
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция реализует алгоритм KDF_TREE_GOSTR3411_2012_256, описанный в Р 50.1.113-2016
+    (раздел 4.5): вырабатывается последовательность \f$ K(1) || K(2) || \ldots \f$, где
+    \f$ K(i) = HMAC_{256}( key, [i]_R || label || 0x00 || seed || [L]_b ) \f$, а \f$ L \f$ длина
+    вырабатываемой последовательности в битах. При `R = 1` и `out_size = 32` функция вычисляет
+    значение алгоритма KDF_GOSTR3411_2012_256 (раздел 4.4).
+
+    @param key Исходный ключ.
+    @param key_size Длина исходного ключа (в октетах).
+    @param label Метка, определяющая назначение вырабатываемого ключа.
+    @param label_size Длина метки (в октетах), может быть равна нулю.
+    @param seed Инициализационный вектор.
+    @param seed_size Длина инициализационного вектора (в октетах), может быть равна нулю.
+    @param R Количество октетов в представлении номера блока, от 1 до 4.
+    @param out Указатель на область памяти, куда помещается результат.
+    @param out_size Длина вырабатываемой последовательности (в октетах).
+
+    \note Состояния функции хеширования после обработки блоков ipad и opad вычисляются один раз
+    и используются для выработки всех блоков последовательности.
+
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_hmac_kdf_tree_streebog256( const ak_pointer key, const size_t key_size,
+                                       const ak_pointer label, const size_t label_size,
+                                       const ak_pointer seed, const size_t seed_size,
+                                       const size_t R, ak_pointer out, const size_t out_size )
+{
+  struct hash ctx;
+  int error = ak_error_ok;
+  struct streebog istate, ostate;
+  size_t idx = 0, jdx = 0, blocks = 0, lsize = 0;
+  ak_uint8 ibuf[4], lbuf[8], zero = 0, inner[32];
+  ak_uint64 length = ( ak_uint64 )out_size << 3;
+
+ /* проверяем входные параметры */
+  if( key == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                               "using null pointer to input key" );
+  if( !key_size ) return ak_error_message( ak_error_zero_length, __func__ ,
+                                                                "using input key of zero length" );
+  if(( label == NULL ) && label_size ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                                    "using null pointer to label" );
+  if(( seed == NULL ) && seed_size ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                                     "using null pointer to seed" );
+  if(( R == 0 ) || ( R > sizeof( ibuf ))) return ak_error_message( ak_error_wrong_length,
+                                              __func__ , "using wrong length of counter encoding" );
+  if( out == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                          "using null pointer to output buffer" );
+  if( !out_size ) return ak_error_message( ak_error_zero_length, __func__ ,
+                                                            "using output buffer of zero length" );
+ /* номер последнего блока должен представляться R октетами */
+  blocks = ( out_size + 31 ) >> 5;
+  if(( R < sizeof( ibuf )) && ( blocks >> ( R << 3 ))) return ak_error_message(
+                      ak_error_wrong_length, __func__ , "using too huge length of output buffer" );
+
+ /* длина последовательности представляется минимально возможным количеством октетов */
+  for( idx = 0; idx < sizeof( lbuf ); idx++ ) {
+     lbuf[sizeof( lbuf ) - 1 - idx] = ( ak_uint8 )( length >> ( idx << 3 ));
+     if( length >> ( idx << 3 )) lsize = idx+1;
   }
-  if(( error = ak_hmac_finalize( &hctx, result, 4, result, sizeof( result ))) != ak_error_ok ) {
-    ak_error_message( error, __func__, "incorrect finalizing of internal mac context");
+
+  if(( error = ak_hash_create_streebog256( &ctx )) != ak_error_ok )
+    return ak_error_message( error, __func__, "wrong creation of streebog256 hash context" );
+  if(( error = ak_hmac_streebog_states( &ctx, key, key_size, &istate, &ostate )) != ak_error_ok ) {
+    ak_error_message( error, __func__, "incorrect evaluation of hmac initial states" );
     goto lab_exit;
   }
-  memcpy( out, result+64-dklen, dklen );
 
- /* теперь основной цикл по значению аргумента c */
-  for( idx = 1; idx < cnt; idx++ ) {
-     ak_hmac_ptr( &hctx, result, 64, result, sizeof( result ));
-     for( jdx = 0; jdx < dklen; jdx++ ) ((ak_uint8 *)out)[jdx] ^= result[64-dklen+jdx];
+  for( idx = 1; idx <= blocks; idx++ ) {
+     for( jdx = 0; jdx < R; jdx++ ) ibuf[R - 1 - jdx] = ( ak_uint8 )( idx >> ( jdx << 3 ));
+
+    /* внутреннее преобразование начинается с сохраненного состояния */
+     ak_hash_clean( &ctx );
+     memcpy( &ctx.data.sctx, &istate, sizeof( struct streebog ));
+     ak_hash_update( &ctx, ibuf, R );
+     if( label_size ) ak_hash_update( &ctx, label, label_size );
+     ak_hash_update( &ctx, &zero, 1 );
+     if( seed_size ) ak_hash_update( &ctx, seed, seed_size );
+     if(( error = ak_hash_finalize( &ctx, lbuf + sizeof( lbuf ) - lsize, lsize,
+                                                          inner, sizeof( inner ))) != ak_error_ok ) {
+       ak_error_message( error, __func__, "incorrect finalizing of internal hash context" );
+       goto lab_exit;
+     }
+    /* внешнее преобразование */
+     ak_hash_clean( &ctx );
+     memcpy( &ctx.data.sctx, &ostate, sizeof( struct streebog ));
+     if(( error = ak_hash_finalize( &ctx, inner, sizeof( inner ),
+                                                          inner, sizeof( inner ))) != ak_error_ok ) {
+       ak_error_message( error, __func__, "incorrect finalizing of internal hash context" );
+       goto lab_exit;
+     }
+     memcpy(( ak_uint8 * )out + (( idx - 1 ) << 5 ), inner,
+                                                    ak_min( sizeof( inner ), out_size - (( idx - 1 ) << 5 )));
   }
-  memset( result, 0, 64 );
 
-  lab_exit: ak_hmac_destroy( &hctx );
+  lab_exit:
+   memset( inner, 0, sizeof( inner ));
+   memset( &istate, 0, sizeof( struct streebog ));
+   memset( &ostate, 0, sizeof( struct streebog ));
+   ak_hash_destroy( &ctx );
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Длина сообщения, обрабатываемого при выработке ключа уровня ключевого дерева. */
+ #define ak_kdf_tree_message_size  (18)
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Формирование сообщения 0x01 || "levelj" || 0x00 || STR_8( value ) || 0x01 || 0x00.
+    \param data Массив, куда помещается сообщение.
+    \param level Номер уровня ключевого дерева.
+    \param value Номер ключа с наложенной маской уровня.                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_kdf_tree_message( ak_uint64 *data, const size_t level, const ak_uint64 value )
+{
+  size_t idx = 0;
+  ak_uint8 *mp = ( ak_uint8 * )data;
+
+  mp[0] = 0x01;
+  memcpy( mp+1, "level", 5 );
+  mp[6] = ( ak_uint8 )( '0' + level );
+  mp[7] = 0x00;
+  for( idx = 0; idx < 8; idx++ ) mp[15-idx] = ( ak_uint8 )( value >> ( idx << 3 ));
+  mp[16] = 0x01;
+  mp[17] = 0x00;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Вычисление значений HMAC с сохраненными состояниями для нескольких сообщений.
+    \param ip Массив состояний после обработки блока ipad.
+    \param op Массив состояний после обработки блока opad.
+    \param data Массив сообщений; результат (32 октета) помещается на место сообщений.
+    \param lanes Количество сообщений, от 1 до \ref ak_hash_streebog_max_lanes.                  */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_kdf_tree_hmac_lanes( const ak_streebog *ip, const ak_streebog *op,
+                                                       ak_uint64 (*data)[8], const size_t lanes )
+{
+  ak_hash_streebog_final_lanes( ip, data, ak_kdf_tree_message_size, lanes );
+  ak_hash_streebog_final_lanes( op, data, 32, lanes );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Проверка того, что ключи вышестоящих уровней вычислены для заданного номера ключа. */
+/* ----------------------------------------------------------------------------------------------- */
+ static bool_t ak_kdf_tree_is_cached( ak_kdf_tree tree, const ak_uint64 index )
+{
+  size_t jdx = 1;
+
+  if( tree->valid < tree->levels ) return ak_false;
+  for( ; jdx < tree->levels; jdx++ )
+     if( tree->index[jdx] != ( index&tree->mask[jdx-1] )) return ak_false;
+ return ak_true;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Вычисление состояний для ключей уровней, предшествующих последнему.
+    \details Повторно вычисляются только ключи тех уровней, для которых изменилось значение
+    номера ключа с наложенной маской, а также ключи всех нижестоящих уровней.
+    \return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_kdf_tree_update( ak_kdf_tree tree, const ak_uint64 index )
+{
+  size_t jdx = 1;
+  int error = ak_error_ok;
+  ak_uint64 key[1][8];
+  ak_streebog ip, op;
+
+ /* определяем уровни, ключи которых не изменяются */
+  while(( jdx < tree->valid ) && ( tree->index[jdx] == ( index&tree->mask[jdx-1] ))) jdx++;
+  tree->valid = jdx;
+
+ /* вычисляем ключи оставшихся уровней и состояния функции хеширования для них */
+  for( ; jdx < tree->levels; jdx++ ) {
+     tree->index[jdx] = index&tree->mask[jdx-1];
+     ip = tree->istate+jdx-1;
+     op = tree->ostate+jdx-1;
+     ak_kdf_tree_message( key[0], jdx, tree->index[jdx] );
+     ak_kdf_tree_hmac_lanes( &ip, &op, key, 1 );
+     if(( error = ak_hmac_streebog_states( &tree->ctx, key[0], 32,
+                                       tree->istate+jdx, tree->ostate+jdx )) != ak_error_ok ) {
+       ak_error_message( error, __func__, "incorrect evaluation of hmac initial states" );
+       break;
+     }
+     tree->valid = jdx+1;
+  }
+
+  ak_hash_clean( &tree->ctx );
+  memset( key, 0, sizeof( key ));
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Присвоение значения ключа контексту секретного ключа блочного шифра или HMAC. */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_kdf_tree_assign_key( ak_pointer ctx, const ak_pointer key )
+{
+  ak_skey skey = ( ak_skey )ctx;
+
+  if( skey == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                      "using null pointer to secret key context" );
+  if( skey->oid == NULL ) return ak_error_message( ak_error_undefined_value, __func__ ,
+                                                   "using secret key context with undefined oid" );
+  switch( skey->oid->engine ) {
+    case block_cipher: return ak_bckey_set_key(( ak_bckey )ctx, key, 32 );
+    case hmac_function: return ak_hmac_set_key(( ak_hmac )ctx, key, 32 );
+    default: return ak_error_message( ak_error_oid_engine, __func__ ,
+                                                "using secret key context with unsupported engine" );
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет и сохраняет состояния функции хеширования Стрибог256 для исходного ключа.
+
+    @param tree Контекст ключевого дерева.
+    @param key Исходный ключ.
+    @param size Длина исходного ключа (в октетах).
+    @param masks Массив масок уровней дерева (количество элементов равно `levels`).
+    @param levels Количество уровней дерева, от 1 до \ref ak_kdf_tree_max_levels.
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_kdf_tree_create( ak_kdf_tree tree, const ak_pointer key, const size_t size,
+                                                   const ak_uint64 *masks, const size_t levels )
+{
+  int error = ak_error_ok;
+
+  if( tree == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                            "using null pointer to key tree" );
+  if( key == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                               "using null pointer to input key" );
+  if( !size ) return ak_error_message( ak_error_zero_length, __func__ ,
+                                                                "using input key of zero length" );
+  if( masks == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                           "using null pointer to level masks" );
+  if(( levels == 0 ) || ( levels > ak_kdf_tree_max_levels ))
+    return ak_error_message( ak_error_wrong_length, __func__ ,
+                                                       "using wrong number of key tree levels" );
+
+  memset( tree, 0, sizeof( struct kdf_tree ));
+  if(( error = ak_hash_create_streebog256( &tree->ctx )) != ak_error_ok )
+    return ak_error_message( error, __func__, "wrong creation of streebog256 hash context" );
+  memcpy( tree->mask, masks, levels*sizeof( ak_uint64 ));
+  tree->levels = levels;
+
+  if(( error = ak_hmac_streebog_states( &tree->ctx, key, size,
+                                                  tree->istate, tree->ostate )) != ak_error_ok ) {
+    ak_error_message( error, __func__, "incorrect evaluation of hmac initial states" );
+    ak_kdf_tree_destroy( tree );
+    return error;
+  }
+  ak_hash_clean( &tree->ctx );
+  tree->valid = 1;
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! @param tree Контекст ключевого дерева.
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_kdf_tree_destroy( ak_kdf_tree tree )
+{
+  int error = ak_error_ok;
+
+  if( tree == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                            "using null pointer to key tree" );
+  if(( error = ak_hash_destroy( &tree->ctx )) != ak_error_ok )
+    ak_error_message( error, __func__, "incorrect destroying of hash context" );
+  memset( tree->istate, 0, sizeof( tree->istate ));
+  memset( tree->ostate, 0, sizeof( tree->ostate ));
+  memset( tree->index, 0, sizeof( tree->index ));
+  tree->levels = tree->valid = 0;
+
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вырабатывает ключ последнего уровня дерева. Ключи вышестоящих уровней вычисляются
+    только в том случае, если они отличаются от ключей, использованных при предыдущем вызове.
+
+    @param tree Контекст ключевого дерева.
+    @param index Номер вырабатываемого ключа.
+    @param out Указатель на область памяти, куда помещается ключ.
+    @param out_size Размер области памяти (в октетах), должен быть не менее 32-х.
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_kdf_tree_get_key( ak_kdf_tree tree, const ak_uint64 index,
+                                                           ak_pointer out, const size_t out_size )
+{
+  int error = ak_error_ok;
+  ak_uint64 key[1][8];
+  ak_streebog ip, op;
+
+  if( tree == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                            "using null pointer to key tree" );
+  if( !tree->levels ) return ak_error_message( ak_error_key_value, __func__ ,
+                                                          "using key tree with undefined key" );
+  if( out == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                          "using null pointer to output buffer" );
+  if( out_size < 32 ) return ak_error_message( ak_error_wrong_length, __func__ ,
+                                                        "using output buffer with small length" );
+  if(( error = ak_kdf_tree_update( tree, index )) != ak_error_ok )
+    return ak_error_message( error, __func__, "incorrect evaluation of key tree levels" );
+
+  ip = tree->istate + tree->levels-1;
+  op = tree->ostate + tree->levels-1;
+  ak_kdf_tree_message( key[0], tree->levels, index&tree->mask[tree->levels-1] );
+  ak_kdf_tree_hmac_lanes( &ip, &op, key, 1 );
+  memcpy( out, key[0], 32 );
+  memset( key, 0, sizeof( key ));
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вырабатывает ключи с номерами `index`, `index+1`, ..., `index+count-1` и присваивает
+    их значения заранее созданным контекстам секретных ключей блочного шифрования или алгоритма
+    HMAC (например, полученным из пула контекстов с помощью функции ak_key_pool_get()).
+    Для блочных шифров выполняется развертка ключа, поэтому после выполнения функции
+    контексты готовы к использованию.
+
+    Ключи, имеющие общие ключи вышестоящих уровней, вырабатываются группами по
+    \ref ak_hash_streebog_max_lanes штук с чередованием вычислений функции хеширования.
+
+    @param tree Контекст ключевого дерева.
+    @param index Номер первого вырабатываемого ключа.
+    @param contexts Массив указателей на контексты секретных ключей.
+    @param count Количество элементов массива.
+    @return В случае успеха функция возвращает \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_kdf_tree_set_keys( ak_kdf_tree tree, const ak_uint64 index,
+                                                      ak_pointer *contexts, const size_t count )
+{
+  size_t idx = 0, ldx = 0, lanes = 0;
+  int error = ak_error_ok;
+  ak_uint64 keys[ak_hash_streebog_max_lanes][8];
+  ak_streebog ip[ak_hash_streebog_max_lanes], op[ak_hash_streebog_max_lanes];
+
+  if( tree == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                            "using null pointer to key tree" );
+  if( !tree->levels ) return ak_error_message( ak_error_key_value, __func__ ,
+                                                          "using key tree with undefined key" );
+  if( contexts == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                       "using null pointer to array of contexts" );
+  if( !count ) return ak_error_message( ak_error_zero_length, __func__ ,
+                                                       "using zero length of array of contexts" );
+  while( idx < count ) {
+    if(( error = ak_kdf_tree_update( tree, index+idx )) != ak_error_ok ) {
+      ak_error_message( error, __func__, "incorrect evaluation of key tree levels" );
+      break;
+    }
+   /* формируем группу ключей с общими ключами вышестоящих уровней */
+    for( lanes = 0; ( lanes < ak_hash_streebog_max_lanes ) && ( idx+lanes < count ); lanes++ ) {
+       ak_uint64 value = index+idx+lanes;
+       if( !ak_kdf_tree_is_cached( tree, value )) break;
+       ak_kdf_tree_message( keys[lanes], tree->levels, value&tree->mask[tree->levels-1] );
+       ip[lanes] = tree->istate + tree->levels-1;
+       op[lanes] = tree->ostate + tree->levels-1;
+    }
+    ak_kdf_tree_hmac_lanes( ip, op, keys, lanes );
+
+    for( ldx = 0; ldx < lanes; ldx++, idx++ )
+       if(( error = ak_kdf_tree_assign_key( contexts[idx], keys[ldx] )) != ak_error_ok ) {
+         ak_error_message( error, __func__, "incorrect assigning a derived key value" );
+         goto lab_exit;
+       }
+  }
+
+  lab_exit:
+   memset( keys, 0, sizeof( keys ));
  return error;
 }
 
@@ -782,6 +1438,9 @@
            salt_one[4]     = "salt",
            salt_two[5]     = { 's', 'a', 0, 'l', 't' };
 
+  struct hmac hctx;
+  size_t idx = 0, jdx = 0;
+  ak_uint8 longpass[100], longsalt[70], u[64], R5[64];
   ak_uint8 out[64];
   int error = ak_error_ok;
   int audit = ak_log_get_level();
@@ -841,6 +1500,130 @@
   }
   if( audit >= ak_log_maximum ) ak_error_message( ak_error_ok, __func__ ,
                                              "the 4th test for pbkdf2 from R 50.1.111-2016 is Ok" );
+
+ /* сравнение с вычислениями на основе контекста hmac для длинных пароля и соли */
+  memset( longpass, 0x5a, sizeof( longpass ));
+  memset( longsalt, 0xa5, sizeof( longsalt ));
+  if(( error = ak_hmac_pbkdf2_streebog512( longpass, sizeof( longpass ),
+                            longsalt, sizeof( longsalt ), 3, 64, out )) != ak_error_ok ) {
+    ak_error_message( error,__func__, "incorrect transformation password to key");
+    return ak_false;
+  }
+  if(( error = ak_hmac_create_streebog512( &hctx )) != ak_error_ok ) {
+    ak_error_message( error, __func__, "wrong creation of hmac-streebog512 key context" );
+    return ak_false;
+  }
+  ak_hmac_set_key( &hctx, longpass, sizeof( longpass ));
+  memset( u, 0, sizeof( u ));
+  u[3] = 1;
+  ak_hmac_clean( &hctx );
+  ak_hmac_update( &hctx, longsalt, sizeof( longsalt ));
+  ak_hmac_finalize( &hctx, u, 4, u, sizeof( u ));
+  memcpy( R5, u, sizeof( u ));
+  for( idx = 1; idx < 3; idx++ ) {
+     ak_hmac_ptr( &hctx, u, sizeof( u ), u, sizeof( u ));
+     for( jdx = 0; jdx < sizeof( u ); jdx++ ) R5[jdx] ^= u[jdx];
+  }
+  ak_hmac_destroy( &hctx );
+  if( !ak_ptr_is_equal_with_log( out, R5, 64 )) {
+    ak_error_message( ak_error_not_equal_data, __func__ ,
+                                    "wrong comparison of pbkdf2 with hmac-streebog512 iterations" );
+    return ak_false;
+  }
+  if( audit >= ak_log_maximum ) ak_error_message( ak_error_ok, __func__ ,
+                              "the comparison of pbkdf2 with hmac-streebog512 iterations is Ok" );
+ return ak_true;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ bool_t ak_libakrypt_test_kdf_tree( void )
+{
+ /* тестовые значения из Р 50.1.113-2016 (см. также RFC 7836, приложение A) */
+  ak_uint8 key[32] = {
+   0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+   0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f
+  };
+  ak_uint8 label[4] = { 0x26, 0xbd, 0xb8, 0x78 };
+  ak_uint8 seed[8] = { 0xaf, 0x21, 0x43, 0x41, 0x45, 0x65, 0x63, 0x78 };
+
+  ak_uint8 R1[32] = {
+   0xa1, 0xaa, 0x5f, 0x7d, 0xe4, 0x02, 0xd7, 0xb3, 0xd3, 0x23, 0xf2, 0x99, 0x1c, 0x8d, 0x45, 0x34,
+   0x01, 0x31, 0x37, 0x01, 0x0a, 0x83, 0x75, 0x4f, 0xd0, 0xaf, 0x6d, 0x7c, 0xd4, 0x92, 0x2e, 0xd9
+  };
+
+  ak_uint8 R2[64] = {
+   0x22, 0xb6, 0x83, 0x78, 0x45, 0xc6, 0xbe, 0xf6, 0x5e, 0xa7, 0x16, 0x72, 0xb2, 0x65, 0x83, 0x10,
+   0x86, 0xd3, 0xc7, 0x6a, 0xeb, 0xe6, 0xda, 0xe9, 0x1c, 0xad, 0x51, 0xd8, 0x3f, 0x79, 0xd1, 0x6b,
+   0x07, 0x4c, 0x93, 0x30, 0x59, 0x9d, 0x7f, 0x8d, 0x71, 0x2f, 0xca, 0x54, 0x39, 0x2f, 0x4d, 0xdd,
+   0xe9, 0x37, 0x51, 0x20, 0x6b, 0x35, 0x84, 0xc8, 0xf4, 0x3f, 0x9e, 0x6d, 0xc5, 0x15, 0x31, 0xf9
+  };
+
+  struct kdf_tree tree;
+  size_t idx = 0, jdx = 0;
+  ak_uint64 masks[3] = { 0xfffffffff0000000LL, 0xffffffffffff0000LL, 0xfffffffffffffff8LL };
+  ak_uint64 indexes[3] = { 0x0000000000000005LL, 0x0000000000000006LL, 0x0000000010000001LL };
+  ak_uint8 out[64], level[32], value[8], name[6] = "level";
+  int error = ak_error_ok;
+  int audit = ak_log_get_level();
+
+ /* алгоритм KDF_GOSTR3411_2012_256 */
+  if(( error = ak_hmac_kdf_tree_streebog256( key, sizeof( key ), label, sizeof( label ),
+                                            seed, sizeof( seed ), 1, out, 32 )) != ak_error_ok ) {
+    ak_error_message( error, __func__, "incorrect evaluation of derived key" );
+    return ak_false;
+  }
+  if( !ak_ptr_is_equal_with_log( out, R1, 32 )) {
+    ak_error_message( ak_error_not_equal_data, __func__ ,
+                                        "wrong test for kdf256 from R 50.1.113-2016" );
+    return ak_false;
+  }
+  if( audit >= ak_log_maximum ) ak_error_message( ak_error_ok, __func__ ,
+                                                 "the test for kdf256 from R 50.1.113-2016 is Ok" );
+
+ /* алгоритм KDF_TREE_GOSTR3411_2012_256 */
+  if(( error = ak_hmac_kdf_tree_streebog256( key, sizeof( key ), label, sizeof( label ),
+                                            seed, sizeof( seed ), 1, out, 64 )) != ak_error_ok ) {
+    ak_error_message( error, __func__, "incorrect evaluation of derived key" );
+    return ak_false;
+  }
+  if( !ak_ptr_is_equal_with_log( out, R2, 64 )) {
+    ak_error_message( ak_error_not_equal_data, __func__ ,
+                                        "wrong test for kdf_tree from R 50.1.113-2016" );
+    return ak_false;
+  }
+  if( audit >= ak_log_maximum ) ak_error_message( ak_error_ok, __func__ ,
+                                               "the test for kdf_tree from R 50.1.113-2016 is Ok" );
+
+ /* сравнение ключей трехуровневого дерева с последовательным вычислением ключей уровней */
+  if(( error = ak_kdf_tree_create( &tree, key, sizeof( key ), masks, 3 )) != ak_error_ok ) {
+    ak_error_message( error, __func__, "wrong creation of key tree" );
+    return ak_false;
+  }
+  for( idx = 0; idx < 3; idx++ ) {
+     memcpy( level, key, sizeof( key ));
+     for( jdx = 0; jdx < 3; jdx++ ) {
+        size_t kdx = 0;
+        ak_uint64 mv = indexes[idx]&masks[jdx];
+        for( kdx = 0; kdx < 8; kdx++ ) value[7-kdx] = ( ak_uint8 )( mv >> ( kdx << 3 ));
+        name[5] = ( ak_uint8 )( '1' + jdx );
+        ak_hmac_kdf_tree_streebog256( level, sizeof( level ), name, sizeof( name ),
+                                                         value, sizeof( value ), 1, level, 32 );
+     }
+     if(( error = ak_kdf_tree_get_key( &tree, indexes[idx], out, 32 )) != ak_error_ok ) {
+       ak_error_message( error, __func__, "incorrect evaluation of key tree element" );
+       break;
+     }
+     if( !ak_ptr_is_equal_with_log( out, level, 32 )) {
+       ak_error_message( error = ak_error_not_equal_data, __func__ ,
+                                                    "wrong comparison of key tree elements" );
+       break;
+     }
+  }
+  ak_kdf_tree_destroy( &tree );
+  memset( level, 0, sizeof( level ));
+  if( error != ak_error_ok ) return ak_false;
+  if( audit >= ak_log_maximum ) ak_error_message( ak_error_ok, __func__ ,
+                                                "the comparison of key tree elements is Ok" );
  return ak_true;
 }
 
@@ -131,19 +131,6 @@
  return z;
 }
 
-/* ----------------------------------------------------------------------------------------------- */
-/*! \brief Функция умножает вектор w на матрицу D, результат помещается в вектор x.                */
-/* ----------------------------------------------------------------------------------------------- */
- static void ak_kuznechik_matrix_mul_vector( linear_matrix D, ak_uint8 *w, ak_uint8* x )
-{
-  int i = 0, j = 0;
-  for( i = 0; i < 16; i++ ) {
-    ak_uint8 z = ak_bckey_context_kuznechik_mul_gf256( D[i][0], w[0] );
-    for( j = 1; j < 16; j++ ) z ^= ak_bckey_context_kuznechik_mul_gf256( D[i][j], w[j] );
-    x[i] = z;
-  }
-}
-
 /* ---------------------------------------------------------------------------------------------- */
 /*! \brief Функция возводит квадратную матрицу в квадрат. */
 /* ---------------------------------------------------------------------------------------------- */
@@ -164,23 +151,6 @@
    for( j = 0; j < 16; j++ ) a[i][j] = c[i][j];
 }
 
-/* ---------------------------------------------------------------------------------------------- */
-/*! \brief Функция реализует линейное преобразование L согласно ГОСТ Р 34.12-2015
-    (шестнадцать тактов работы линейного регистра сдвига).                                        */
-/* ---------------------------------------------------------------------------------------------- */
- static void ak_kuznechik_linear_steps( ak_uint8 *w  )
-{
-  int i = 0, j = 0;
-  for( j = 0; j < 16; j++ ) {
-     ak_uint8 z = ak_bckey_context_kuznechik_mul_gf256( w[0], kuznechik_parameters.reg[0] );
-     for( i = 1; i < 16; i++ ) {
-        w[i-1] = w[i];
-        z ^= ak_bckey_context_kuznechik_mul_gf256( w[i], kuznechik_parameters.reg[i] );
-     }
-     w[15] = z;
-  }
-}
-
 /* ----------------------------------------------------------------------------------------------- */
 /*! Для заданного линейного регистра сдвига, задаваемого набором коэффициентов `reg`,
     функция вычисляет 16-ю степень сопровождающей матрицы.
@@ -275,13 +245,13 @@
 /* ----------------------------------------------------------------------------------------------- */
 /*                                функции для работы с контекстом                                  */
 /* ----------------------------------------------------------------------------------------------- */
-/*! \brief Функция освобождает память, занимаемую развернутыми ключами алгоритма Кузнечик.
+/*! \brief Функция очищает развернутые ключи алгоритма Кузнечик, не освобождая занимаемую ими память.
     \param skey Указатель на контекст секретного ключа, содержащего развернутые
     раундовые ключи и маски.
     \return Функция возвращает \ref ak_error_ok в случае успеха.
     В противном случае возвращается код ошибки.                                                    */
 /* ----------------------------------------------------------------------------------------------- */
- static int ak_kuznechik_delete_keys( ak_skey skey )
+ static int ak_kuznechik_wipe_keys( ak_skey skey )
 {
   int error = ak_error_ok;
 
@@ -289,18 +259,77 @@
   if( skey == NULL ) return ak_error_message( ak_error_null_pointer,
                                                  __func__ , "using a null pointer to secret key" );
   if( skey->data != NULL ) {
-   /* теперь очистка и освобождение памяти */
     if(( error = ak_ptr_wipe( skey->data, sizeof( ak_kuznechik_expanded_keys ),
                                                              &skey->generator )) != ak_error_ok ) {
       ak_error_message( error, __func__, "incorrect wiping an internal data" );
       memset( skey->data, 0, sizeof( ak_kuznechik_expanded_keys ));
     }
+  }
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция освобождает память, занимаемую развернутыми ключами алгоритма Кузнечик.
+    \param skey Указатель на контекст секретного ключа, содержащего развернутые
+    раундовые ключи и маски.
+    \return Функция возвращает \ref ak_error_ok в случае успеха.
+    В противном случае возвращается код ошибки.                                                    */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_kuznechik_delete_keys( ak_skey skey )
+{
+  int error = ak_error_ok;
+
+ /* выполняем стандартные проверки */
+  if( skey == NULL ) return ak_error_message( ak_error_null_pointer,
+                                                 __func__ , "using a null pointer to secret key" );
+  if( skey->data != NULL ) {
+   /* теперь очистка и освобождение памяти */
+    error = ak_kuznechik_wipe_keys( skey );
     free( skey->data );
     skey->data = NULL;
   }
  return error;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет значение L( S( x )) для вектора x, заданного в каноническом
+    представлении, с помощью развернутых таблиц зашифрования.
+    \details В режиме совместимости с openssl развернутые таблицы содержат векторы,
+    байты которых записаны в обратном порядке, поэтому результат дополнительно переворачивается.  */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_kuznechik_ls_canonical( ak_uint64 *x, ak_int64 oc )
+{
+  int i = 0;
+  ak_uint64 t[2] = { 0, 0 };
+  ak_uint8 *b = ( ak_uint8 *)x;
+
+  for( i = 0; i < 16; i++ ) {
+     t[0] ^= kuznechik_parameters.enc[i][b[i]][0];
+     t[1] ^= kuznechik_parameters.enc[i][b[i]][1];
+  }
+  if( oc ) { x[0] = bswap_64( t[1] ); x[1] = bswap_64( t[0] ); }
+   else { x[0] = t[0]; x[1] = t[1]; }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет значение y = L^{-1}( x ) для вектора x, заданного в каноническом
+    представлении, с помощью развернутых таблиц расшифрования
+    (таблицы содержат значения L^{-1}( S^{-1}( x )), поэтому к входу применяется замена S). */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_kuznechik_linv_canonical( ak_uint64 *x, ak_uint64 *y, ak_int64 oc )
+{
+  int i = 0;
+  ak_uint64 t[2] = { 0, 0 };
+  ak_uint8 *b = ( ak_uint8 *)x;
+
+  for( i = 0; i < 16; i++ ) {
+     t[0] ^= kuznechik_parameters.dec[i][kuznechik_parameters.pi[b[i]]][0];
+     t[1] ^= kuznechik_parameters.dec[i][kuznechik_parameters.pi[b[i]]][1];
+  }
+  if( oc ) { y[0] = bswap_64( t[1] ); y[1] = bswap_64( t[0] ); }
+   else { y[0] = t[0]; y[1] = t[1]; }
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Функция реализует развертку ключей для алгоритма Кузнечик.
     \param skey Указатель на контекст секретного ключа, в который помещаются развернутые
@@ -311,8 +340,9 @@
  static int ak_kuznechik_schedule_keys( ak_skey skey )
 {
   ak_uint8 reverse[64];
-  int i = 0, j = 0, l = 0, kdx = 2;
-  ak_uint64 a0[2], a1[2], c[2], t[2], idx = 0;
+  int i = 0, j = 0, kdx = 2;
+  ak_uint64 a0[2], a1[2], c[2], t[2];
+  ak_uint8 idx = 0;
   ak_int64 oc = ak_libakrypt_get_option_by_name( "openssl_compability" );
   ak_uint64 *ekey = NULL, *mkey = NULL, *dkey = NULL, *xkey = NULL, *rkey = NULL, *lkey = NULL;
 
@@ -324,11 +354,10 @@
  /* проверяем целостность ключа */
   if( skey->check_icode( skey ) != ak_true ) return ak_error_message( ak_error_wrong_key_icode,
                                                 __func__ , "using key with wrong integrity code" );
- /* удаляем былое */
-  if( skey->data != NULL ) ak_kuznechik_delete_keys( skey );
-
- /* далее, по-возможности, выделяем выравненную память */
-  if(( skey->data = ak_aligned_malloc( sizeof( ak_kuznechik_expanded_keys ))) == NULL )
+ /* память под раундовые ключи выделяется однократно (по-возможности, выравненная) и
+    используется повторно при последующих присвоениях ключа; прежние значения перезаписываются */
+  if(( skey->data == NULL ) &&
+                 (( skey->data = ak_aligned_malloc( sizeof( ak_kuznechik_expanded_keys ))) == NULL ))
     return ak_error_message( ak_error_out_of_memory, __func__ ,
                                                              "wrong allocation of internal data" );
  /* получаем указатели на области памяти */
@@ -359,23 +388,19 @@
   dkey[0] = a1[0]^xkey[0]; dkey[1] = a1[1]^xkey[1];
 
   ekey[2] = a0[0]^mkey[2]; ekey[3] = a0[1]^mkey[3];
-  ak_kuznechik_matrix_mul_vector( kuznechik_parameters.Linv,
-                                            (ak_uint8 *)a0, (ak_uint8 *)( dkey+2 ));
+  ak_kuznechik_linv_canonical( a0, dkey+2, oc );
   dkey[2] ^= xkey[2]; dkey[3] ^= xkey[3];
 
   for( j = 0; j < 4; j++ ) {
      for( i = 0; i < 8; i++ ) {
-      #ifdef AK_LITTLE_ENDIAN
-        c[0] = ++idx; /* вычисляем константу алгоритма согласно ГОСТ Р 34.12-2015 */
-      #else
-        c[0] = bswap_64( ++idx );
-      #endif
-        c[1] = 0;
-        ak_kuznechik_linear_steps(( ak_uint8 *)c );
+       /* вычисляем константу алгоритма согласно ГОСТ Р 34.12-2015: C = L( idx ),
+          для этого используем вектор, переходящий в ( idx, 0, ..., 0 ) при нелинейной замене */
+        memset( c, kuznechik_parameters.pinv[0], sizeof( c ));
+        ((ak_uint8 *)c)[0] = kuznechik_parameters.pinv[ ++idx ];
+        ak_kuznechik_ls_canonical( c, oc );
 
         t[0] = a1[0] ^ c[0]; t[1] = a1[1] ^ c[1];
-        for( l = 0; l < 16; l++ ) ((ak_uint8 *)t)[l] = kuznechik_parameters.pi[ ((ak_uint8 *)t)[l]];
-        ak_kuznechik_linear_steps(( ak_uint8 *)t );
+        ak_kuznechik_ls_canonical( t, oc );
 
         t[0] ^= a0[0]; t[1] ^= a0[1];
         a0[0] = a1[0]; a0[1] = a1[1];
@@ -383,14 +408,12 @@
      }
      kdx += 2;
      ekey[kdx] = a1[0]^mkey[kdx]; ekey[kdx+1] = a1[1]^mkey[kdx+1];
-     ak_kuznechik_matrix_mul_vector( kuznechik_parameters.Linv,
-                                         ( ak_uint8 *)a1, (ak_uint8 *)( dkey+kdx ));
+     ak_kuznechik_linv_canonical( a1, dkey+kdx, oc );
      dkey[kdx] ^= xkey[kdx]; dkey[kdx+1] ^= xkey[kdx+1];
 
      kdx += 2;
      ekey[kdx] = a0[0]^mkey[kdx]; ekey[kdx+1] = a0[1]^mkey[kdx+1];
-     ak_kuznechik_matrix_mul_vector( kuznechik_parameters.Linv,
-                                         ( ak_uint8 *)a0, (ak_uint8 *)( dkey+kdx ));
+     ak_kuznechik_linv_canonical( a0, dkey+kdx, oc );
      dkey[kdx] ^= xkey[kdx]; dkey[kdx+1] ^= xkey[kdx+1];
   }
 
@@ -703,6 +726,7 @@
  /* устанавливаем методы */
   bkey->schedule_keys = ak_kuznechik_schedule_keys;
   bkey->delete_keys = ak_kuznechik_delete_keys;
+  bkey->wipe_keys = ak_kuznechik_wipe_keys;
   if( oc ) {
     bkey->encrypt = ak_kuznechik_encrypt_with_mask_oc;
     bkey->decrypt = ak_kuznechik_decrypt_with_mask_oc;
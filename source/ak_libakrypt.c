@@ -82,6 +82,9 @@
   #ifdef AK_HAVE_BUILTIN_MULQ_GCC
    ak_error_message( ak_error_ok, __func__ , "library applies assembler code for mulq command" );
   #endif
+  #ifdef AK_HAVE_BUILTIN_UINT128
+   ak_error_message( ak_error_ok, __func__ , "library applies 128-bit integers for montgomery arithmetic" );
+  #endif
   #ifdef AK_HAVE_PTHREAD_H
    ak_error_message( ak_error_ok, __func__ , "library runs with pthreads support" );
   #endif
@@ -190,7 +193,7 @@
   if( audit >= ak_log_maximum )
     ak_error_message( ak_error_ok, __func__ , "testing mac algorithms started" );
 
- /* тестирование механизмов hmac и pbkdf2 */
+ /* тестирование механизмов hmac, pbkdf2 и kdf_tree */
   if( ak_libakrypt_test_hmac_streebog() != ak_true ) {
     ak_error_message( ak_error_get_value(), __func__, "incorrect testing of hmac functions" );
     return ak_false;
@@ -199,6 +202,10 @@
     ak_error_message( ak_error_get_value(), __func__, "incorrect testing of pbkdf2 function" );
     return ak_false;
   }
+  if( ak_libakrypt_test_kdf_tree() != ak_true ) {
+    ak_error_message( ak_error_get_value(), __func__, "incorrect testing of kdf_tree functions" );
+    return ak_false;
+  }
  /* тестирование различых реализаци cmac на совпадение */
   if( ak_libakrypt_test_cmac() != ak_true ) {
     ak_error_message( ak_error_get_value(), __func__, "incorrect testing different kinds of cmac" );
@@ -401,6 +408,15 @@
   if( error != ak_error_ok )
     ak_error_message( error, __func__ , "before destroing library holds an error(s)" );
 
+ /* удаляем таблицы кратных точек эллиптических кривых */
+  ak_wcurve_tables_destroy();
+
+ /* удаляем генератор, созданный для текущего потока */
+  ak_random_thread_generator_destroy();
+
+ /* освобождаем неиспользуемую память, выделенную для хранения секретных ключей */
+  ak_skey_arena_destroy();
+
 #ifdef AK_HAVE_WINDOWS_H
   #ifdef LIBAKRYPT_NETWORK
     if( WSACleanup() != 0 )
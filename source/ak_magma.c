@@ -639,6 +639,26 @@
 #endif
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция очистки развернутых ключей для маскированной магмы
+
+    Хранящиеся маски и ключи заполняются случайным мусором, память не освобождается
+    и используется повторно при следующей развертке ключа.
+
+    @param skey Указатель на контекст секретного ключа
+
+    @return В случае успеха функция возвращает ak_error_ok. В противном случае,
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_magma_wipe_keys( ak_skey skey )
+{
+  if( skey == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                            "using a null pointer to secret key" );
+  if( skey->data != NULL )
+    ak_ptr_wipe( skey->data, sizeof( struct magma_encrypted_keys ), &skey->generator );
+ return ak_error_ok;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Функция уничтожения развернутых ключей для маскированной магмы
 
@@ -656,7 +676,7 @@
                                                             "using a null pointer to secret key" );
  /* если ключ был создан, но ему не было присвоено значение, здесь возникнет ошибка */
   if( skey->data != NULL ) {
-    ak_ptr_wipe( skey->data, sizeof( struct magma_encrypted_keys ), &skey->generator );
+    ak_magma_wipe_keys( skey );
     free( skey->data );
     skey->data = NULL;
   }
@@ -681,11 +701,12 @@
  /* проверяем целостность ключа */
   if( skey->check_icode( skey ) != ak_true ) return ak_error_message( ak_error_wrong_key_icode,
                                                 __func__ , "using key with wrong integrity code" );
- /* удаляем былое */
-  if( skey->data != NULL ) ak_magma_delete_keys( skey );
-
-  if(( data = ak_aligned_malloc( sizeof( struct magma_encrypted_keys ))) == NULL )
-    return ak_error_message( ak_error_out_of_memory, __func__, "incorrect memory allocation" );
+ /* память под раундовые ключи выделяется однократно и используется повторно
+    при последующих присвоениях ключа */
+  if(( data = skey->data ) == NULL ) {
+    if(( data = ak_aligned_malloc( sizeof( struct magma_encrypted_keys ))) == NULL )
+      return ak_error_message( ak_error_out_of_memory, __func__, "incorrect memory allocation" );
+  }
 
  /* выставляем флаги того, что память выделена */
   memset( data, 0, sizeof( struct magma_encrypted_keys ));
@@ -943,6 +964,7 @@
 
   bkey->schedule_keys = ak_magma_schedule_keys;
   bkey->delete_keys = ak_magma_delete_keys;
+  bkey->wipe_keys = ak_magma_wipe_keys;
   if( oc ) {
     bkey->encrypt = ak_magma_encrypt_with_random_walk_oc;
     bkey->decrypt = ak_magma_decrypt_with_random_walk_oc;
@@ -73,6 +73,64 @@
  } while (0)
 #endif
 
+/* ----------------------------------------------------------------------------------------------- */
+/* макрос ak_mpzn_mac вычисляет двойное слово (c,t) = t + a*b + c,
+   макрос ak_mpzn_adc вычисляет двойное слово (c,t) = t + a + c,
+   макрос ak_mpzn_sbb вычисляет слово t = t - a - b и заем b                                       */
+#ifdef AK_HAVE_BUILTIN_UINT128
+ __extension__ typedef unsigned __int128 ak_dword;
+
+ #define ak_mpzn_adc( c, t, a )                                         \
+ do {                                                                   \
+    ak_dword __w = ( ak_dword )(t) + (a) + (c);                         \
+    (t) = ( ak_uint64 )__w;                                             \
+    (c) = ( ak_uint64 )( __w >> 64 );                                   \
+ } while (0)
+
+ #define ak_mpzn_sbb( b, t, a )                                         \
+ do {                                                                   \
+    ak_dword __w = ( ak_dword )(t) - (a) - (b);                         \
+    (t) = ( ak_uint64 )__w;                                             \
+    (b) = ( ak_uint64 )( __w >> 64 )&1;                                 \
+ } while (0)
+
+ #define ak_mpzn_mac( c, t, a, b )                                      \
+ do {                                                                   \
+    ak_dword __w = ( ak_dword )(a) * (b) + (t) + (c);                    \
+    (t) = ( ak_uint64 )__w;                                             \
+    (c) = ( ak_uint64 )( __w >> 64 );                                   \
+ } while (0)
+#else
+ #define ak_mpzn_adc( c, t, a )                                         \
+ do {                                                                   \
+    ak_uint64 __w0 = (t) + (a), __w1 = ( __w0 < (a) );                  \
+    __w0 += (c);                                                        \
+    __w1 += ( __w0 < (c) );                                             \
+    (t) = __w0;                                                         \
+    (c) = __w1;                                                         \
+ } while (0)
+
+ #define ak_mpzn_sbb( b, t, a )                                         \
+ do {                                                                   \
+    ak_uint64 __w0 = (t) - (a), __w1 = ( __w0 > (t) );                  \
+    __w1 += ( __w0 < (b) );                                             \
+    (t) = __w0 - (b);                                                   \
+    (b) = __w1;                                                         \
+ } while (0)
+
+ #define ak_mpzn_mac( c, t, a, b )                                      \
+ do {                                                                   \
+    ak_uint64 __w1, __w0;                                               \
+    umul_ppmm( __w1, __w0, (a), (b) );                                  \
+    __w0 += (t);                                                        \
+    __w1 += ( __w0 < (t) );                                             \
+    __w0 += (c);                                                        \
+    __w1 += ( __w0 < (c) );                                             \
+    (t) = __w0;                                                         \
+    (c) = __w1;                                                         \
+ } while (0)
+#endif
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Функция присваивает значение вычета x вычету z. Для оптимизации вычислений проверка
     корректности входных данных не производится.
@@ -685,6 +743,47 @@
   if( t[size] != cy ) memcpy( z, t, size*sizeof( ak_uint64 ));
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычитает из вычета x вычет y по модулю p, то есть вычисляет значение сравнения
+    \f$ z \equiv x - y \pmod{p}\f$. Предполагается, что оба вычета меньше модуля p.
+    Коррекция результата (прибавление модуля) выполняется с помощью маски, без ветвлений.
+    Результат помещается в переменную z. Указатель на z может совпадать с одним из указателей на
+    аргументы.
+
+    @param z Указатель на вычет, в который помещается результат
+    @param x Уменьшаемое
+    @param y Вычитаемое
+    @param p Модуль, по которому производится операция вычитания
+    @param size Размер модуля в словах (значение константы ak_mpzn256_size или ak_mpzn512_size )   */
+/* ----------------------------------------------------------------------------------------------- */
+ inline void ak_mpzn_sub_montgomery( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+                                                                ak_uint64 *p, const size_t size )
+{
+  size_t i = 0;
+  ak_uint64 av = 0, bv = 0, cy = 0, mask = 0;
+
+ // сначала вычитаем: (x - y) -> z
+  for( i = 0; i < size; i++ ) {
+     av = x[i];
+     bv = av - cy;
+     cy = bv > av;
+     av = bv - y[i];
+     cy += av > bv;
+     z[i] = av;
+  }
+ // при возникновении заема прибавляем модуль: z + (p & mask) -> z
+  mask = ( ak_uint64 )0 - cy; cy = 0;
+  for( i = 0; i < size; i++ ) {
+     av = z[i];
+     bv = p[i]&mask;
+     bv += cy;
+     cy = bv < cy;
+     bv += av;
+     cy += bv < av;
+     z[i] = bv;
+  }
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Функция умножает вычет x на 2, после чего приводит полученную сумму
     по модулю p, то есть вычисляет значение сравнения \f$ z \equiv 2x \pmod{p}\f$.
@@ -719,6 +818,54 @@
    if( t[size] != cy ) memcpy( z, t, size*sizeof( ak_uint64 ));
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция реализует умножение Монтгомери по методу CIOS (Coarsely Integrated Operand Scanning):
+    умножение на очередное слово x и приведение по модулю p выполняются в одном цикле,
+    поэтому промежуточное значение занимает всего size+2 слова.
+
+    Функция вызывается с константным значением size (\ref ak_mpzn256_size или
+    \ref ak_mpzn512_size), что позволяет компилятору полностью развернуть все циклы.
+    Вычитание модуля на последнем шаге выполняется с помощью маски, без условных переходов.        */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_mpzn_mul_montgomery_cios( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+                                               ak_uint64 *p, ak_uint64 n0, const size_t size )
+{
+  size_t i, j;
+  ak_uint64 c, m, av, bv, cy, mask, t[ak_mpzn512_size+2];
+
+  for( i = 0; i < size+2; i++ ) t[i] = 0;
+  for( i = 0; i < size; i++ ) {
+    /* t <- t + x[i]*y */
+     for( j = 0, c = 0; j < size; j++ ) ak_mpzn_mac( c, t[j], x[i], y[j] );
+     t[size] += c;
+     t[size+1] = ( t[size] < c );
+
+    /* t <- ( t + m*p )/2^64 */
+     m = t[0]*n0;
+     c = 0;
+     ak_mpzn_mac( c, t[0], m, p[0] );
+     for( j = 1; j < size; j++ ) {
+        ak_mpzn_mac( c, t[j], m, p[j] );
+        t[j-1] = t[j];
+     }
+     t[size-1] = t[size] + c;
+     t[size] = t[size+1] + ( t[size-1] < c );
+  }
+
+ /* вычитаем из результата модуль p */
+  for( i = 0, cy = 0; i < size; i++ ) {
+     av = t[i];
+     bv = av - cy;
+     cy = bv > av;
+     av = bv - p[i];
+     cy += av > bv;
+     z[i] = av;
+  }
+ /* если t < p, то оставляем значение t */
+  mask = ( ak_uint64 )0 - ( ak_uint64 )( cy != t[size] );
+  for( i = 0; i < size; i++ ) z[i] = ( z[i]&~mask )|( t[i]&mask );
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Функция умножает два вычета x и y в представлении Монтгомери, после чего приводит полученное
     произведение по модулю p, то есть для \f$ x \equiv x_0r \pmod{p} \f$ и
@@ -727,6 +874,10 @@
     Результат помещается в переменную z. Указатель на z может совпадать с одним из указателей на
     перемножаемые вычеты.
 
+    Для модулей длины 256 и 512 бит (размер которых задается параметром size эллиптической
+    кривой) используется развернутый вариант алгоритма CIOS, для остальных длин -
+    последовательное умножение и приведение.
+
     @param z Указатель на вычет, в который помещается результат
     @param x Левый аргумент опреации сложения
     @param y Правый аргумент операции сложения
@@ -743,6 +894,17 @@
   ak_uint64 av = 0, bv = 0, cy = 0;
   ak_mpznmax t = ak_mpznmax_zero;
 
+ /* для стандартных размеров модулей используются развернутые варианты функции */
+  switch( size ) {
+    case ak_mpzn256_size:
+      ak_mpzn_mul_montgomery_cios( z, x, y, p, n0, ak_mpzn256_size );
+      return;
+    case ak_mpzn512_size:
+      ak_mpzn_mul_montgomery_cios( z, x, y, p, n0, ak_mpzn512_size );
+      return;
+    default: break;
+  }
+
   // ak_mpzn_mul( t, x, y, size );
   for( i = 0; i < size; i++ ) {
      ak_uint64 c = 0, m = x[i];
@@ -795,6 +957,257 @@
   if( cy != t[2*size] ) memcpy( z, t+size, size*sizeof( ak_uint64 ));
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция завершает приведение Монтгомери: из значения (top,u), меньшего 2p, при необходимости
+    вычитается модуль p. Вычитание выполняется с помощью маски, без условных переходов.            */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_mpzn_montgomery_correct( ak_uint64 *z, ak_uint64 *u, ak_uint64 top,
+                                                                 ak_uint64 *p, const size_t size )
+{
+  size_t i;
+  ak_uint64 av, bv, cy, mask;
+
+  for( i = 0, cy = 0; i < size; i++ ) {
+     av = u[i];
+     bv = av - cy;
+     cy = bv > av;
+     av = bv - p[i];
+     cy += av > bv;
+     z[i] = av;
+  }
+  mask = ( ak_uint64 )0 - ( ak_uint64 )( cy != top );
+  for( i = 0; i < size; i++ ) z[i] = ( z[i]&~mask )|( u[i]&mask );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет произведение t = x*y длины 2size слов.                                      */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_mpzn_mul_product( ak_uint64 *t, ak_uint64 *x, ak_uint64 *y,
+                                                                                const size_t size )
+{
+  size_t i, j;
+  ak_uint64 c;
+
+  for( j = 0, c = 0; j < size; j++ ) {
+     t[j] = 0;
+     ak_mpzn_mac( c, t[j], x[0], y[j] );
+  }
+  t[size] = c;
+  for( i = 1; i < size; i++ ) {
+     for( j = 0, c = 0; j < size; j++ ) ak_mpzn_mac( c, t[i+j], x[i], y[j] );
+     t[i+size] = c;
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет квадрат t = x*x длины 2size слов с учетом симметрии: произведения
+    \f$ x_ix_j \f$ при \f$ i < j\f$ вычисляются один раз и удваиваются, после чего добавляются
+    квадраты слов \f$ x_i^2 \f$. Это требует \f$ \text{size}(\text{size}+1)/2 \f$ умножений слов
+    вместо \f$ \text{size}^2\f$.                                                                  */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_mpzn_sqr_product( ak_uint64 *t, ak_uint64 *x, const size_t size )
+{
+  size_t i, j;
+  ak_uint64 c, lo, hi, hb;
+
+ /* произведения x[i]*x[j] при i < j */
+  t[0] = t[2*size-1] = 0;
+  for( j = 1, c = 0; j < size; j++ ) {
+     t[j] = 0;
+     ak_mpzn_mac( c, t[j], x[0], x[j] );
+  }
+  t[size] = c;
+  for( i = 1; i < size-1; i++ ) {
+     for( j = i+1, c = 0; j < size; j++ ) ak_mpzn_mac( c, t[i+j], x[i], x[j] );
+     t[i+size] = c;
+  }
+ /* удваиваем и одновременно добавляем квадраты x[i]*x[i] */
+  for( i = 0, c = 0, hb = 0; i < size; i++ ) {
+     lo = t[2*i]; hi = t[2*i+1];
+     t[2*i] = ( lo << 1 )|hb;
+     t[2*i+1] = ( hi << 1 )|( lo >> 63 );
+     hb = hi >> 63;
+     ak_mpzn_mac( c, t[2*i], x[i], x[i] );
+     ak_mpzn_adc( c, t[2*i+1], 0 );
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет квадрат вычета с помощью функции ak_mpzn_sqr_product(), после чего
+    выполняет приведение Монтгомери полученного произведения длины 2size слов.
+
+    Функция вызывается с константным значением size, что позволяет компилятору полностью
+    развернуть все циклы.                                                                          */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_mpzn_sqr_montgomery_sos( ak_uint64 *z, ak_uint64 *x,
+                                                 ak_uint64 *p, ak_uint64 n0, const size_t size )
+{
+  size_t i, j;
+  ak_uint64 c, m, cy, t[2*ak_mpzn512_size];
+
+  ak_mpzn_sqr_product( t, x, size );
+
+ /* приведение Монтгомери: t <- ( t + m*p )/2^{64size} */
+  for( i = 0, cy = 0; i < size; i++ ) {
+     m = t[i]*n0;
+     for( j = 0, c = 0; j < size; j++ ) ak_mpzn_mac( c, t[i+j], m, p[j] );
+     ak_mpzn_adc( cy, t[i+size], c );
+  }
+  ak_mpzn_montgomery_correct( z, t+size, cy, p, size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция возводит в квадрат вычет x, заданный в представлении Монтгомери, то есть для
+    \f$ x \equiv x_0r \pmod{p} \f$ вычисляет значение, удовлетворяющее сравнению
+    \f$ z \equiv x_0^2r \pmod{p}\f$. Результат совпадает с результатом вызова
+    ak_mpzn_mul_montgomery( z, x, x, p, n0, size ), однако для модулей длины 256 и 512 бит
+    вычисляется быстрее за счет использования симметрии произведения.
+    Указатель на z может совпадать с указателем на x.
+
+    @param z Указатель на вычет, в который помещается результат
+    @param x Вычет, который возводится в квадрат
+    @param p Модуль, по которому производятся вычисления
+    @param n0 Константа, используемая в вычислениях. Представляет собой младшее слово
+    числа n, удовлетворяющего равенству \f$ rs - np = 1\f$.
+    @param size Размер модуля в словах (значение константы \ref ak_mpzn256_size или
+                                                                          \ref ak_mpzn512_size).   */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_mpzn_sqr_montgomery( ak_uint64 *z, ak_uint64 *x,
+                                                   ak_uint64 *p, ak_uint64 n0, const size_t size )
+{
+  switch( size ) {
+    case ak_mpzn256_size:
+      ak_mpzn_sqr_montgomery_sos( z, x, p, n0, ak_mpzn256_size );
+      break;
+    case ak_mpzn512_size:
+      ak_mpzn_sqr_montgomery_sos( z, x, p, n0, ak_mpzn512_size );
+      break;
+    default:
+      ak_mpzn_mul_montgomery( z, x, x, p, n0, size );
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция выполняет приведение Монтгомери значения t длины 2size слов для модуля вида
+    \f$ p = 2^{64\cdot\text{size}} - c\f$, где \f$ 0 < c < 2^{64}\f$. Для такого модуля
+    \f$ mp = m2^{64\cdot\text{size}} - mc \f$, поэтому вместо прибавления \f$ m_ip \f$ на каждом шаге
+    достаточно вычесть из очередного слова произведение \f$ m_ic \f$ (одно умножение слов),
+    а сами множители \f$ m_i \f$ прибавить к старшей половине t.
+    Таким образом, приведение требует 2size умножений слов вместо \f$ \text{size}^2 \f$.
+
+    Младшее слово \f$ m_ic \f$ совпадает с текущим словом t, поэтому заем возникает только
+    при вычитании старшего слова \f$ m_{i-1}c\f$.                                                 */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline void ak_mpzn_redc_pseudo_mersenne( ak_uint64 *z, ak_uint64 *t,
+                                                 ak_uint64 *p, ak_uint64 n0, const size_t size )
+{
+  size_t i;
+  ak_uint64 c, h, l, b, v, m[ak_mpzn512_size], *u = t+size;
+  const ak_uint64 pc = ( ak_uint64 )0 - p[0];
+
+  for( i = 0, h = 0, b = 0; i < size; i++ ) {
+     v = t[i];
+     ak_mpzn_sbb( b, v, h );
+     m[i] = v*n0;
+     h = l = 0;
+     ak_mpzn_mac( h, l, m[i], pc );
+  }
+ /* u <- u - h - b + m */
+  ak_mpzn_sbb( b, u[0], h );
+  for( i = 1; i < size; i++ ) ak_mpzn_sbb( b, u[i], 0 );
+  for( i = 0, c = 0; i < size; i++ ) ak_mpzn_adc( c, u[i], m[i] );
+  ak_mpzn_montgomery_correct( z, u, c - b, p, size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция умножает два вычета x и y в представлении Монтгомери по модулю вида
+    \f$ p = 2^{64\cdot\text{size}} - c \f$ (например, модули кривых
+    id_tc26_gost_3410_2012_256_paramSetA и id_tc26_gost_3410_2012_512_paramSetA).
+    Результат совпадает с результатом функции ak_mpzn_mul_montgomery(), однако
+    приведение по модулю p использует специальный вид модуля.
+
+    Функция не проверяет вид модуля p; проверка выполняется один раз при тестировании
+    параметров эллиптической кривой (см. функцию ak_wcurve_is_ok()).
+
+    @param z Указатель на вычет, в который помещается результат
+    @param x Левый аргумент операции умножения
+    @param y Правый аргумент операции умножения
+    @param p Модуль вида \f$ 2^{64\cdot\text{size}} - c \f$
+    @param n0 Константа, используемая в вычислениях. Представляет собой младшее слово
+    числа n, удовлетворяющего равенству \f$ rs - np = 1\f$.
+    @param size Размер модуля в словах (значение константы \ref ak_mpzn256_size или
+                                                                          \ref ak_mpzn512_size).   */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_mpzn_mul_montgomery_pseudo_mersenne( ak_uint64 *z, ak_uint64 *x, ak_uint64 *y,
+                                               ak_uint64 *p, ak_uint64 n0, const size_t size )
+{
+  ak_uint64 t[2*ak_mpzn512_size];
+
+  switch( size ) {
+    case ak_mpzn256_size:
+      ak_mpzn_mul_product( t, x, y, ak_mpzn256_size );
+      ak_mpzn_redc_pseudo_mersenne( z, t, p, n0, ak_mpzn256_size );
+      break;
+    case ak_mpzn512_size:
+      ak_mpzn_mul_product( t, x, y, ak_mpzn512_size );
+      ak_mpzn_redc_pseudo_mersenne( z, t, p, n0, ak_mpzn512_size );
+      break;
+    default:
+      ak_mpzn_mul_montgomery( z, x, y, p, n0, size );
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция возводит в квадрат вычет x, заданный в представлении Монтгомери, по модулю вида
+    \f$ p = 2^{64\cdot\text{size}} - c \f$. Результат совпадает с результатом функции
+    ak_mpzn_sqr_montgomery().
+
+    @param z Указатель на вычет, в который помещается результат
+    @param x Вычет, который возводится в квадрат
+    @param p Модуль вида \f$ 2^{64\cdot\text{size}} - c \f$
+    @param n0 Константа, используемая в вычислениях. Представляет собой младшее слово
+    числа n, удовлетворяющего равенству \f$ rs - np = 1\f$.
+    @param size Размер модуля в словах (значение константы \ref ak_mpzn256_size или
+                                                                          \ref ak_mpzn512_size).   */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_mpzn_sqr_montgomery_pseudo_mersenne( ak_uint64 *z, ak_uint64 *x,
+                                                   ak_uint64 *p, ak_uint64 n0, const size_t size )
+{
+  ak_uint64 t[2*ak_mpzn512_size];
+
+  switch( size ) {
+    case ak_mpzn256_size:
+      ak_mpzn_sqr_product( t, x, ak_mpzn256_size );
+      ak_mpzn_redc_pseudo_mersenne( z, t, p, n0, ak_mpzn256_size );
+      break;
+    case ak_mpzn512_size:
+      ak_mpzn_sqr_product( t, x, ak_mpzn512_size );
+      ak_mpzn_redc_pseudo_mersenne( z, t, p, n0, ak_mpzn512_size );
+      break;
+    default:
+      ak_mpzn_mul_montgomery( z, x, x, p, n0, size );
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция проверяет, что модуль p имеет вид \f$ 2^{64\cdot\text{size}} - c \f$,
+    то есть все слова модуля, кроме младшего, состоят из единиц.
+
+    @param p Проверяемый модуль
+    @param size Размер модуля в словах
+    @return Функция возвращает \ref ak_true, если модуль имеет требуемый вид.
+    В противном случае возвращается \ref ak_false.                                                */
+/* ----------------------------------------------------------------------------------------------- */
+ bool_t ak_mpzn_is_pseudo_mersenne( ak_uint64 *p, const size_t size )
+{
+  size_t i;
+
+  if(( size < 2 ) || ( p[0] == 0 )) return ak_false;
+  for( i = 1; i < size; i++ )
+     if( p[i] != 0xffffffffffffffffLL ) return ak_false;
+ return ak_true;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Для вычета \f$ x \f$, заданного в представлении Монтгомери в виде \f$ xr \f$, где \f$ r \f$
     заданная степень двойки, вычисляется вычет \f$ z \f$,
@@ -833,7 +1246,7 @@
   for( i = s; i >= 0; i-- ) {
      uk = k[i];
      for( j = 0; j < 64; j++ ) {
-        ak_mpzn_mul_montgomery( res, res, res, p, n0, size );
+        ak_mpzn_sqr_montgomery( res, res, p, n0, size );
         if( uk&0x8000000000000000LL ) ak_mpzn_mul_montgomery( res, res, x, p, n0, size );
         uk <<= 1;
      }
@@ -841,6 +1254,124 @@
   memcpy( z, res, size*sizeof( ak_uint64 ));
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция вычисляет вычет \f$ z \f$, удовлетворяющий сравнению \f$ xz \equiv 1 \pmod{p} \f$,
+    где \f$ p \f$ нечетный модуль, а \f$ 0 \leq x < p \f$. Если \f$ x \f$ и \f$ p \f$
+    не взаимно просты (в частности, если \f$ x = 0 \f$), то результат не определен.
+
+    Используется бинарный расширенный алгоритм Евклида в варианте N.Möller (функция
+    `mpn_sec_invert` библиотеки GMP): вычисления выполняются за фиксированное количество
+    итераций \f$ 128\cdot\text{size} \f$, все условные операции реализованы с помощью масок,
+    поэтому время работы функции не зависит от значения \f$ x \f$. Это позволяет использовать
+    функцию для обращения секретных значений.
+
+    Результат помещается в переменную z. Указатель на z может совпадать с указателем на x.
+
+    @param z Вычет, в который помещается результат
+    @param x Обращаемый вычет
+    @param p Нечетный модуль, по которому производятся вычисления
+    @param size Размер модуля в словах (значение константы \ref ak_mpzn256_size
+    или \ref ak_mpzn512_size )                                                                     */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_mpzn_inverse( ak_uint64 *z, ak_uint64 *x, ak_uint64 *p, const size_t size )
+{
+  size_t i, j;
+  ak_uint64 odd, swap, cy, av, bv, t;
+  ak_mpznmax a, b, u, v, h;
+
+  memcpy( a, x, size*sizeof( ak_uint64 ));
+  memcpy( b, p, size*sizeof( ak_uint64 ));
+  ak_mpzn_set_ui( u, size, 1 );
+  ak_mpzn_set_ui( v, size, 0 );
+ /* h <- (p+1)/2 */
+  for( i = 0; i < size-1; i++ ) h[i] = ( p[i] >> 1 )^( p[i+1] << 63 );
+  h[size-1] = p[size-1] >> 1;
+  for( i = 0, cy = 1; i < size; i++ ) { h[i] += cy; cy = ( h[i] < cy ); }
+
+ /* инвариант алгоритма: a = ux, b = vx (mod p) */
+  for( j = 0; j < 128*size; j++ ) {
+    /* если a нечетно, то a <- a - b; при возникновении заема (a < b) обмениваем a и b */
+     odd = ( ak_uint64 )0 - ( a[0]&1 );
+     for( i = 0, cy = 0; i < size; i++ ) {
+        av = a[i]; bv = b[i]&odd;
+        t = av - cy; cy = t > av;
+        av = t - bv; cy += av > t;
+        a[i] = av;
+     }
+     swap = ( ak_uint64 )0 - cy;
+    /* b <- b + (a - b) = a, a <- -(a - b) = b - a */
+     for( i = 0, cy = 0; i < size; i++ ) {
+        bv = b[i]; av = a[i]&swap;
+        bv += cy; cy = bv < cy;
+        bv += av; cy += bv < av;
+        b[i] = bv;
+     }
+     for( i = 0, cy = 1&swap; i < size; i++ ) {
+        av = ( a[i]^swap ) + cy; cy = ( av < cy );
+        a[i] = av;
+     }
+    /* обмениваем u и v, после чего u <- u - v (mod p) */
+     for( i = 0; i < size; i++ ) {
+        t = ( u[i]^v[i] )&swap;
+        u[i] ^= t; v[i] ^= t;
+     }
+     for( i = 0, cy = 0; i < size; i++ ) {
+        av = u[i]; bv = v[i]&odd;
+        t = av - cy; cy = t > av;
+        av = t - bv; cy += av > t;
+        u[i] = av;
+     }
+     t = ( ak_uint64 )0 - cy;
+     for( i = 0, cy = 0; i < size; i++ ) {
+        av = u[i]; bv = p[i]&t;
+        av += cy; cy = av < cy;
+        av += bv; cy += av < bv;
+        u[i] = av;
+     }
+    /* теперь a четно: a <- a/2, u <- u/2 (mod p) */
+     for( i = 0; i < size-1; i++ ) a[i] = ( a[i] >> 1 )^( a[i+1] << 63 );
+     a[size-1] >>= 1;
+     t = ( ak_uint64 )0 - ( u[0]&1 );
+     for( i = 0; i < size-1; i++ ) u[i] = ( u[i] >> 1 )^( u[i+1] << 63 );
+     u[size-1] >>= 1;
+     for( i = 0, cy = 0; i < size; i++ ) {
+        av = u[i]; bv = h[i]&t;
+        av += cy; cy = av < cy;
+        av += bv; cy += av < bv;
+        u[i] = av;
+     }
+  }
+ /* теперь a = 0, b = НОД(x,p) = 1 и, следовательно, v = x^{-1} (mod p) */
+  memcpy( z, v, size*sizeof( ak_uint64 ));
+  memset( a, 0, sizeof( a ));
+  memset( u, 0, sizeof( u ));
+  memset( v, 0, sizeof( v ));
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Для вычета \f$ x \f$, заданного в представлении Монтгомери в виде \f$ x_0r \f$,
+    функция вычисляет вычет \f$ z \equiv x_0^{-1}r \pmod{p}\f$, то есть обратный вычет
+    в представлении Монтгомери. Результат совпадает с результатом функции
+    ak_mpzn_modpow_montgomery(), вызванной со степенью \f$ p-2 \f$, однако вычисляется
+    существенно быстрее с помощью функции ak_mpzn_inverse() (также за время, не зависящее
+    от значения \f$ x \f$).
+
+    @param z Вычет, в который помещается результат
+    @param x Обращаемый вычет (в представлении Монтгомери)
+    @param p Простой модуль, по которому производятся вычисления
+    @param n0 Константа, используемая в арифметике Монтгомери по модулю \f$ p \f$.
+    @param r2 Величина \f$ r^2 \pmod{p}\f$.
+    @param size Размер модуля в словах (значение константы \ref ak_mpzn256_size
+    или \ref ak_mpzn512_size )                                                                     */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_mpzn_inverse_montgomery( ak_uint64 *z, ak_uint64 *x, ak_uint64 *p,
+                                                ak_uint64 n0, ak_uint64 *r2, const size_t size )
+{
+  ak_mpzn_inverse( z, x, p, size );                    // z <- x_0^{-1}r^{-1}
+  ak_mpzn_mul_montgomery( z, z, r2, p, n0, size );     // z <- x_0^{-1}
+  ak_mpzn_mul_montgomery( z, z, r2, p, n0, size );     // z <- x_0^{-1}r
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 #ifdef AK_HAVE_GMP_H
 /* преобразование "туда и обратно" */
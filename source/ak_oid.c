@@ -112,16 +112,24 @@
 /*! Константные значения имен идентификаторов */
  static const char *asn1_lcg_n[] =         { "lcg", NULL };
  static const char *asn1_lcg_i[] =         { "1.2.643.2.52.1.1.1", NULL };
+ static const char *asn1_xorshift128_n[] =  { "xorshift128+", NULL };
+ static const char *asn1_xorshift128_i[] =  { "1.2.643.2.52.1.1.7", NULL };
 #if defined(__unix__) || defined(__APPLE__)
  static const char *asn1_dev_random_n[] =  { "dev-random", "/dev/random", NULL };
  static const char *asn1_dev_random_i[] =  { "1.2.643.2.52.1.1.2", NULL };
  static const char *asn1_dev_urandom_n[] = { "dev-urandom", "/dev/urandom", NULL };
  static const char *asn1_dev_urandom_i[] = { "1.2.643.2.52.1.1.3", NULL };
 #endif
+#ifdef AK_HAVE_SYSRANDOM_H
+ static const char *asn1_getrandom_n[] =    { "getrandom", NULL };
+ static const char *asn1_getrandom_i[] =    { "1.2.643.2.52.1.1.5", NULL };
+#endif
 #ifdef _WIN32
  static const char *asn1_winrtl_n[] =       { "winrtl", NULL };
  static const char *asn1_winrtl_i[] =       { "1.2.643.2.52.1.1.4", NULL };
 #endif
+ static const char *asn1_ctr_drbg_n[] =     { "ctr-drbg-kuznechik", NULL };
+ static const char *asn1_ctr_drbg_i[] =     { "1.2.643.2.52.1.1.6", NULL };
 
  static const char *asn1_streebog256_n[] = { "streebog256", "md_gost12_256", NULL };
  static const char *asn1_streebog256_i[] = { "1.2.643.7.1.1.2.2", NULL };
@@ -467,6 +475,10 @@ static struct oid libakrypt_oids[] =
   {{ sizeof( struct random ), (ak_function_create_object *)ak_random_create_lcg,
                               (ak_function_destroy_object *)ak_random_destroy, NULL, NULL, NULL },
                                                                 ak_object_undefined, NULL, NULL }},
+ { random_generator, algorithm, asn1_xorshift128_i, asn1_xorshift128_n, NULL,
+  {{ sizeof( struct random ), (ak_function_create_object *)ak_random_create_xorshift128,
+                              (ak_function_destroy_object *)ak_random_destroy, NULL, NULL, NULL },
+                                                                ak_object_undefined, NULL, NULL }},
 #if defined(__unix__) || defined(__APPLE__)
  { random_generator, algorithm, asn1_dev_random_i, asn1_dev_random_n, NULL,
   {{ sizeof( struct random ), (ak_function_create_object *)ak_random_create_random,
@@ -477,12 +489,22 @@ static struct oid libakrypt_oids[] =
                               (ak_function_destroy_object *)ak_random_destroy, NULL, NULL, NULL },
                                                                 ak_object_undefined, NULL, NULL }},
 #endif
+#ifdef AK_HAVE_SYSRANDOM_H
+ { random_generator, algorithm, asn1_getrandom_i, asn1_getrandom_n, NULL,
+  {{ sizeof( struct random ), (ak_function_create_object *)ak_random_create_getrandom,
+                              (ak_function_destroy_object *)ak_random_destroy, NULL, NULL, NULL },
+                                                                ak_object_undefined, NULL, NULL }},
+#endif
 #ifdef _WIN32
  { random_generator, algorithm,asn1_winrtl_i, asn1_winrtl_n, NULL,
   {{ sizeof( struct random ), (ak_function_create_object *)ak_random_create_winrtl,
                               (ak_function_destroy_object *)ak_random_destroy, NULL, NULL, NULL },
                                                                 ak_object_undefined, NULL, NULL }},
 #endif
+ { random_generator, algorithm, asn1_ctr_drbg_i, asn1_ctr_drbg_n, NULL,
+  {{ sizeof( struct random ), (ak_function_create_object *)ak_random_create_ctr_drbg,
+                              (ak_function_destroy_object *)ak_random_destroy, NULL, NULL, NULL },
+                                                                ak_object_undefined, NULL, NULL }},
 
 /* добавляем идентификаторы алгоритмов */
  { hash_function, algorithm, asn1_streebog256_i, asn1_streebog256_n, NULL,
@@ -50,6 +50,14 @@
      { "openssl_compability", 0, 0, 1 },
   /* флаг использования цвета при выводе сообщений библиотеки */
      { "use_color_output", 1, 0, 1 },
+  /* флаг использования буфера случайных данных в генераторе, использующем вызов getrandom() */
+     { "use_random_buffer", 1, 0, 1 },
+  /* количество запросов к генератору ctr-drbg-kuznechik между обращениями к источнику энтропии */
+     { "drbg_reseed_interval", 65536, 1, 2147483648 },
+  /* флаг размещения секретных ключей в заблокированной памяти (арене) */
+     { "use_locked_memory", 1, 0, 1 },
+  /* количество обращений к ключу в режимах шифрования, через которое проверяется его целостность */
+     { "icode_check_interval", 1, 1, 2147483648 },
      { NULL, 0, 0, 0 } /* завершающая константа, должна всегда принимать нулевые значения */
  };
 
@@ -4,7 +4,7 @@
 /*  Файл ak_random.с                                                                               */
 /*  - содержит реализацию генераторов псевдо-случайных чисел                                       */
 /* ----------------------------------------------------------------------------------------------- */
- #include <libakrypt.h>
+ #include <libakrypt-internal.h>
 
 /* ----------------------------------------------------------------------------------------------- */
 #ifdef AK_HAVE_TIME_H
@@ -16,6 +16,15 @@
 #ifdef AK_HAVE_FCNTL_H
  #include <fcntl.h>
 #endif
+#ifdef AK_HAVE_ERRNO_H
+ #include <errno.h>
+#endif
+#ifdef AK_HAVE_SYSRANDOM_H
+ #include <sys/random.h>
+#endif
+#ifdef AK_HAVE_PTHREAD_H
+ #include <pthread.h>
+#endif
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Инициализация генератора псевдо-случайных чисел.
@@ -283,6 +292,134 @@
  return error;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*                              реализация класса rng_xorshift128                                  */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция splitmix64, используемая для выработки начального состояния генератора
+    xorshift128+ (гарантирует, что состояние генератора отлично от нуля).                          */
+/* ----------------------------------------------------------------------------------------------- */
+ static ak_uint64 ak_random_splitmix64( ak_uint64 *x )
+{
+  ak_uint64 z = ( *x += 0x9E3779B97F4A7C15ULL );
+  z = ( z ^ ( z >> 30 ))*0xBF58476D1CE4E5B9ULL;
+  z = ( z ^ ( z >> 27 ))*0x94D049BB133111EBULL;
+ return z ^ ( z >> 31 );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Вычисление очередного 64-х битного значения генератора xorshift128+. */
+ #define ak_xorshift128_next( s0, s1, out ) do { \
+     ak_uint64 x = s0, y = s1; \
+     s0 = y; \
+     x ^= x << 23; \
+     s1 = x ^ y ^ ( x >> 17 ) ^ ( y >> 26 ); \
+     out = s1 + y; \
+  } while( 0 )
+
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_random_xorshift128_next( ak_random rnd )
+{
+  ak_uint64 value = 0;
+
+  if( rnd == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                      "use a null pointer to a random generator" );
+  ak_xorshift128_next( rnd->data.xs[0], rnd->data.xs[1], value );
+  ( void )value;
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_random_xorshift128_randomize_ptr( ak_random rnd,
+                                                         const ak_pointer ptr, const ssize_t size )
+{
+  ssize_t idx = 0;
+  ak_uint64 seed = 0;
+  ak_uint8 *value = ptr;
+
+  if( rnd == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                      "use a null pointer to a random generator" );
+  if( ptr == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                          "use a null pointer to initial vector" );
+  if( size <= 0 ) return ak_error_message( ak_error_wrong_length, __func__ ,
+                                                          "use initial vector with wrong length" );
+ /* сворачиваем начальное значение в 64-х битное число и вырабатываем из него состояние */
+  for( idx = 0; idx < size; idx++ ) {
+     seed ^= value[idx];
+     seed *= 0x100000001B3ULL;
+  }
+  rnd->data.xs[0] = ak_random_splitmix64( &seed );
+  rnd->data.xs[1] = ak_random_splitmix64( &seed );
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_random_xorshift128_random( ak_random rnd, const ak_pointer ptr, const ssize_t size )
+{
+  ak_uint8 *value = ptr;
+  ak_uint64 s0, s1, w[8];
+  size_t idx = 0, len = ( size_t )size;
+
+  if( rnd == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                      "use a null pointer to a random generator" );
+  if( ptr == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                                    "use a null pointer to data" );
+  if( size <= 0 ) return ak_error_message( ak_error_wrong_length, __func__ ,
+                                                           "use a data vector with wrong length" );
+  s0 = rnd->data.xs[0];
+  s1 = rnd->data.xs[1];
+
+ /* основной цикл вырабатывает блоки длины 64 байта */
+  for( ; len >= sizeof( w ); len -= sizeof( w ), value += sizeof( w )) {
+     for( idx = 0; idx < 8; idx++ ) ak_xorshift128_next( s0, s1, w[idx] );
+     memcpy( value, w, sizeof( w ));
+  }
+ /* хвост вырабатывается словами длины 8 байт */
+  while( len > 0 ) {
+     ak_xorshift128_next( s0, s1, w[0] );
+     idx = ak_min( len, sizeof( ak_uint64 ));
+     memcpy( value, w, idx );
+     value += idx;
+     len -= idx;
+  }
+
+  rnd->data.xs[0] = s0;
+  rnd->data.xs[1] = s1;
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Генератор xorshift128+ (S. Vigna) вырабатывает последовательность 64-х битных слов и
+    используется для выработки масок секретных ключей и очистки памяти. Генератор не является
+    криптографически стойким и не должен использоваться для выработки ключей и
+    случайных значений в криптографических алгоритмах.
+
+    Внутреннее состояние генератора вырабатывается функцией splitmix64 из значения
+    функции ak_random_value() или из данных, переданных функции ak_random_randomize().
+
+    @param generator Контекст создаваемого генератора.
+    \return В случае успеха, функция возвращает \ref ak_error_ok. В противном случае
+            возвращается код ошибки.                                                               */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_random_create_xorshift128( ak_random generator )
+{
+  int error = ak_error_ok;
+  ak_uint64 seed = ak_random_value(); /* вырабатываем случайное число */
+
+  if(( error = ak_random_create( generator )) != ak_error_ok )
+    return ak_error_message( error, __func__ , "wrong initialization of random generator" );
+
+  generator->oid = ak_oid_find_by_name("xorshift128+");
+  generator->next = ak_random_xorshift128_next;
+  generator->randomize_ptr = ak_random_xorshift128_randomize_ptr;
+  generator->random = ak_random_xorshift128_random;
+
+  generator->data.xs[0] = ak_random_splitmix64( &seed );
+  generator->data.xs[1] = ak_random_splitmix64( &seed );
+ return error;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*                                 реализация класса rng_file                                      */
 /* ----------------------------------------------------------------------------------------------- */
@@ -397,6 +534,598 @@
 #endif
 
 
+
+#if defined( AK_HAVE_SYSMMAN_H ) && defined( MADV_WIPEONFORK )
+/* ----------------------------------------------------------------------------------------------- */
+/*                      буфер случайных данных, обнуляемый при вызове fork()                       */
+/* ----------------------------------------------------------------------------------------------- */
+ #define AK_RANDOM_BUFFER
+/*! \brief Размер памяти (в байтах), занимаемой буфером случайных данных (одна страница). */
+ #define ak_random_buffer_size (4096)
+
+/*! \brief Буфер заранее выработанных случайных данных.
+    Неиспользованными считаются последние count байт массива data; использованные байты
+    сразу же обнуляются. При порождении нового процесса страница с буфером обнуляется ядром ОС,
+    поэтому дочерний процесс не может повторить значения, выработанные родительским процессом. */
+ typedef struct random_buffer {
+  /*! \brief Количество неиспользованных байт */
+   size_t count;
+  /*! \brief Случайные данные */
+   ak_uint8 data[ ak_random_buffer_size - sizeof( size_t )];
+ } *ak_random_buffer;
+
+/*! \brief Функция заполнения буфера случайными данными. */
+ typedef int ( ak_function_random_buffer_fill )( ak_pointer , ak_uint8 * , size_t );
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция выделяет страницу памяти, которая обнуляется в дочернем процессе и
+    не попадает в дамп памяти процесса. Если ядро ОС не поддерживает флаг MADV_WIPEONFORK,
+    функция возвращает NULL.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static ak_random_buffer ak_random_buffer_new( void )
+{
+  ak_random_buffer buf = NULL;
+
+  if(( buf = mmap( NULL, sizeof( struct random_buffer ), PROT_READ | PROT_WRITE,
+                                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 )) == MAP_FAILED )
+    return NULL;
+  if( madvise( buf, sizeof( struct random_buffer ), MADV_WIPEONFORK ) != 0 ) {
+    munmap( buf, sizeof( struct random_buffer ));
+    return NULL;
+  }
+ #ifdef MADV_DONTDUMP
+  madvise( buf, sizeof( struct random_buffer ), MADV_DONTDUMP );
+ #endif
+  buf->count = 0;
+ return buf;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_random_buffer_delete( ak_random_buffer buf )
+{
+  if( buf == NULL ) return;
+  memset( buf, 0, sizeof( struct random_buffer ));
+  if( munmap( buf, sizeof( struct random_buffer )) != 0 )
+    ak_error_message( ak_error_undefined_value, __func__ , "wrong unmapping of random data buffer" );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция копирует size байт из буфера (size должно быть меньше размера буфера),
+    при необходимости заполняя буфер заново с помощью функции fill.                                */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_random_buffer_ptr( ak_random_buffer buf, ak_uint8 *out, size_t size,
+                                               ak_function_random_buffer_fill *fill, ak_pointer ctx )
+{
+  int error = ak_error_ok;
+  size_t offset = 0;
+
+ /* используем остаток буфера и заполняем его заново */
+  if( buf->count < size ) {
+    offset = sizeof( buf->data ) - buf->count;
+    memcpy( out, buf->data + offset, buf->count );
+    memset( buf->data + offset, 0, buf->count );
+    out += buf->count;
+    size -= buf->count;
+    buf->count = 0;
+
+    if(( error = fill( ctx, buf->data, sizeof( buf->data ))) != ak_error_ok )
+      return ak_error_message( error, __func__, "wrong refilling of random data buffer" );
+    buf->count = sizeof( buf->data );
+  }
+
+  offset = sizeof( buf->data ) - buf->count;
+  memcpy( out, buf->data + offset, size );
+  memset( buf->data + offset, 0, size );
+  buf->count -= size;
+
+ return ak_error_ok;
+}
+#endif
+
+#ifdef AK_HAVE_SYSRANDOM_H
+/* ----------------------------------------------------------------------------------------------- */
+/*                                 реализация класса rng_getrandom                                 */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Заполнение заданной области памяти с помощью системного вызова getrandom(). */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_random_getrandom_fill( ak_pointer ctx, ak_uint8 *ptr, size_t size )
+{
+  ssize_t result = 0;
+
+  ( void )ctx;
+ /* вызов может вернуть меньшее количество байт, а также может быть прерван сигналом */
+  while( size > 0 ) {
+    if(( result = getrandom( ptr, size, 0 )) < 0 ) {
+     #ifdef AK_HAVE_ERRNO_H
+      if( errno == EINTR ) continue;
+      return ak_error_message_fmt( ak_error_read_data, __func__ ,
+                                "wrong reading data from getrandom() call (%s)", strerror( errno ));
+     #else
+      return ak_error_message( ak_error_read_data, __func__ ,
+                                                       "wrong reading data from getrandom() call" );
+     #endif
+    }
+    ptr += result;
+    size -= ( size_t )result;
+  }
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_random_getrandom_random( ak_random rnd, const ak_pointer ptr, const ssize_t size )
+{
+  if( rnd == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                      "use a null pointer to a random generator" );
+  if( ptr == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                                    "use a null pointer to data" );
+  if( size <= 0 ) return ak_error_message( ak_error_wrong_length, __func__ ,
+                                                           "use a data vector with wrong length" );
+#ifdef AK_RANDOM_BUFFER
+ /* короткие последовательности копируются из буфера */
+  if(( rnd->data.ctx != NULL ) && (( size_t )size < ak_random_buffer_size/2 ))
+    return ak_random_buffer_ptr( rnd->data.ctx, ptr, ( size_t )size,
+                                                                  ak_random_getrandom_fill, NULL );
+#endif
+ return ak_random_getrandom_fill( NULL, ptr, ( size_t )size );
+}
+
+#ifdef AK_RANDOM_BUFFER
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_random_getrandom_free( ak_random rnd )
+{
+  if( rnd == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                     "use a null pointer to a random generator" );
+  ak_random_buffer_delete( rnd->data.ctx );
+  rnd->data.ctx = NULL;
+
+ return ak_error_ok;
+}
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Генератор использует системный вызов getrandom() и не требует открытия файловых устройств
+    (таких как /dev/urandom), что позволяет использовать его в процессах, ограниченных
+    по количеству открытых файлов, а также в изолированном окружении.
+
+    Если опция библиотеки `use_random_buffer` отлична от нуля, то генератор выделяет страницу
+    памяти (4 Кб), которая заполняется одним системным вызовом; короткие последовательности
+    копируются из нее. Страница помечается флагом MADV_WIPEONFORK, поэтому в дочернем процессе
+    буфер оказывается пустым и заполняется заново. При отсутствии поддержки данного флага
+    ядром ОС генератор работает без буфера.
+
+    Контекст генератора (как и все остальные контексты библиотеки) не предназначен
+    для одновременного использования несколькими потоками; в многопоточной программе
+    каждый поток должен использовать собственный контекст, а следовательно, и собственный буфер.
+
+    @param generator Контекст создаваемого генератора.
+    \return В случае успеха, функция возвращает \ref ak_error_ok. В противном случае
+            возвращается код ошибки.                                                               */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_random_create_getrandom( ak_random generator )
+{
+  ak_uint8 value = 0;
+  int error = ak_error_ok;
+
+  if(( error = ak_random_create( generator )) != ak_error_ok )
+    return ak_error_message( error, __func__ , "wrong initialization of random generator" );
+
+ /* проверяем, что системный вызов поддерживается ядром ОС */
+  if(( error = ak_random_getrandom_fill( NULL, &value, 1 )) != ak_error_ok ) {
+    ak_random_destroy( generator );
+    return ak_error_message( error, __func__ , "getrandom() system call is not available" );
+  }
+
+  generator->oid = ak_oid_find_by_name("getrandom");
+  generator->next = NULL;
+  generator->randomize_ptr = NULL;
+  generator->random = ak_random_getrandom_random;
+  generator->free = NULL;
+
+#ifdef AK_RANDOM_BUFFER
+  if( ak_libakrypt_get_option_by_name( "use_random_buffer" )) {
+    generator->data.ctx = ak_random_buffer_new();
+    generator->free = ak_random_getrandom_free;
+  }
+#endif
+
+ return error;
+}
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                              реализация класса rng_ctr_drbg                                     */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Максимальный объем данных (в байтах), вырабатываемый без смены внутреннего состояния. */
+ #define ak_ctr_drbg_max_request (65536)
+/*! \brief Объем данных (в байтах), используемых для обновления внутреннего состояния:
+    ключ алгоритма Кузнечик (32 байта) и синхропосылка (8 байт), дополненные до длины трех блоков. */
+ #define ak_ctr_drbg_seed_size (48)
+
+/*! \brief Внутреннее состояние генератора, использующего алгоритм Кузнечик в режиме гаммирования. */
+ typedef struct ctr_drbg {
+  /*! \brief Текущий ключ алгоритма блочного шифрования */
+   struct bckey key;
+  /*! \brief Текущее значение синхропосылки */
+   ak_uint8 iv[8];
+  /*! \brief Количество запросов, выполненных после последнего обновления от источника энтропии */
+   ak_uint64 count;
+  /*! \brief Максимальное количество запросов между обновлениями от источника энтропии */
+   ak_uint64 interval;
+#ifndef _WIN32
+  /*! \brief Номер процесса, в котором было выполнено последнее обновление */
+   pid_t pid;
+#endif
+  /*! \brief Системный генератор, используемый в качестве источника энтропии */
+   struct random source;
+#ifdef AK_RANDOM_BUFFER
+  /*! \brief Буфер выработанной гаммы, используемый для коротких запросов */
+   ak_random_buffer buffer;
+#endif
+ } *ak_ctr_drbg;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Создание генератора, вырабатывающего случайные значения средствами операционной системы.
+    Функция последовательно пытается создать генераторы getrandom, /dev/urandom и winrtl.          */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_random_create_system( ak_random rnd )
+{
+#ifdef AK_HAVE_SYSRANDOM_H
+  if( ak_random_create_getrandom( rnd ) == ak_error_ok ) return ak_error_ok;
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+  if( ak_random_create_urandom( rnd ) == ak_error_ok ) return ak_error_ok;
+#endif
+#ifdef _WIN32
+  if( ak_random_create_winrtl( rnd ) == ak_error_ok ) return ak_error_ok;
+#endif
+ return ak_error_message( ak_error_undefined_function, __func__ ,
+                                                       "system random generator is not available" );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вырабатывает size байт гаммы на текущем ключе и, продолжая ту же гамму,
+    вырабатывает новые значения ключа и синхропосылки. Если указатель seed отличен от NULL,
+    то новые значения ключа и синхропосылки складываются с заданными 48-ю байтами.
+    Использованный ключ уничтожается, поэтому ранее выработанные значения не могут быть
+    восстановлены по текущему внутреннему состоянию генератора.                                    */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_ctr_drbg_generate( ak_ctr_drbg ctx, ak_uint8 *out, size_t size, ak_uint8 *seed )
+{
+  size_t idx = 0, head = size&( ~(size_t)0x0f ), tail = size&0x0f;
+  ak_uint8 buffer[16 + ak_ctr_drbg_seed_size], *next = buffer + ( tail ? 16 : 0 );
+  int error = ak_error_ok;
+
+ /* основной массив данных вырабатывается одним вызовом в режиме гаммирования */
+  memset( buffer, 0, sizeof( buffer ));
+  if( head ) {
+    memset( out, 0, head );
+    if(( error = ak_bckey_ctr( &ctx->key, out, out, head,
+                                               ctx->iv, sizeof( ctx->iv ))) != ak_error_ok ) {
+      memset( out, 0, head );
+      return ak_error_message( error, __func__, "wrong generation of random data" );
+    }
+  }
+ /* остаток данных и новое внутреннее состояние вырабатываются как продолжение гаммы */
+  if(( error = ak_bckey_ctr( &ctx->key, buffer, buffer,
+                           ( size_t )( next - buffer ) + ak_ctr_drbg_seed_size,
+                           head ? NULL : ctx->iv, head ? 0 : sizeof( ctx->iv ))) != ak_error_ok ) {
+    if( head ) memset( out, 0, head );
+    return ak_error_message( error, __func__, "wrong generation of random data" );
+  }
+  if( tail ) memcpy( out + head, buffer, tail );
+  if( seed != NULL )
+    for( idx = 0; idx < ak_ctr_drbg_seed_size; idx++ ) next[idx] ^= seed[idx];
+
+  if(( error = ak_bckey_set_key( &ctx->key, next, 32 )) == ak_error_ok )
+    memcpy( ctx->iv, next + 32, sizeof( ctx->iv ));
+  memset( buffer, 0, sizeof( buffer ));
+
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Обновление внутреннего состояния генератора значением, полученным от источника энтропии;
+    дополнительные данные (если они заданы) сжимаются функцией хеширования Стрибог512
+    и складываются с выработанным значением.                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_ctr_drbg_reseed( ak_ctr_drbg ctx, const ak_pointer in, const ssize_t size )
+{
+  struct hash hctx;
+  size_t idx = 0;
+  ak_uint8 seed[ak_ctr_drbg_seed_size], data[64];
+  int error = ak_error_ok;
+
+ /* выработанная ранее гамма больше не используется */
+#ifdef AK_RANDOM_BUFFER
+  if( ctx->buffer != NULL ) memset( ctx->buffer, 0, sizeof( struct random_buffer ));
+#endif
+  if(( error = ak_random_ptr( &ctx->source, seed, sizeof( seed ))) != ak_error_ok )
+    return ak_error_message( error, __func__, "wrong reading data from entropy source" );
+
+  if(( in != NULL ) && ( size > 0 )) {
+    if(( error = ak_hash_create_streebog512( &hctx )) != ak_error_ok ) goto exlab;
+    error = ak_hash_ptr( &hctx, in, ( size_t )size, data, sizeof( data ));
+    ak_hash_destroy( &hctx );
+    if( error != ak_error_ok ) goto exlab;
+    for( idx = 0; idx < sizeof( seed ); idx++ ) seed[idx] ^= data[idx];
+  }
+ /* при первом вызове ключ не определен, поэтому значение используется непосредственно */
+  if(( ctx->key.key.flags&ak_key_flag_set_key ) == 0 ) {
+    if(( error = ak_bckey_set_key( &ctx->key, seed, 32 )) == ak_error_ok )
+      memcpy( ctx->iv, seed + 32, sizeof( ctx->iv ));
+  } else error = ak_ctr_drbg_generate( ctx, data, 0, seed );
+
+  if( error == ak_error_ok ) {
+    ctx->count = 0;
+   #ifndef _WIN32
+    ctx->pid = getpid();
+   #endif
+  }
+
+  exlab:
+   memset( seed, 0, sizeof( seed ));
+   memset( data, 0, sizeof( data ));
+   if( error != ak_error_ok )
+     ak_error_message( error, __func__, "wrong update of internal state" );
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Выработка гаммы с предварительным обновлением внутреннего состояния от источника
+    энтропии по истечении заданного числа запросов, а также в дочернем процессе,
+    получившем копию состояния родительского процесса.                                            */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_ctr_drbg_fill( ak_pointer ptr, ak_uint8 *out, size_t size )
+{
+  size_t chunk = 0;
+  int error = ak_error_ok;
+  ak_ctr_drbg ctx = ( ak_ctr_drbg ) ptr;
+
+  while( size > 0 ) {
+    if(( ctx->count >= ctx->interval )
+     #ifndef _WIN32
+      || ( ctx->pid != getpid( ))
+     #endif
+    ) {
+        if(( error = ak_ctr_drbg_reseed( ctx, NULL, 0 )) != ak_error_ok ) return error;
+      }
+    chunk = ak_min( size, ak_ctr_drbg_max_request );
+    if(( error = ak_ctr_drbg_generate( ctx, out, chunk, NULL )) != ak_error_ok ) return error;
+    ctx->count++;
+    out += chunk;
+    size -= chunk;
+  }
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_random_ctr_drbg_randomize_ptr( ak_random rnd, const ak_pointer ptr, const ssize_t size )
+{
+  if( rnd == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                      "use a null pointer to a random generator" );
+  if( ptr == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                          "use a null pointer to initial vector" );
+  if( size <= 0 ) return ak_error_message( ak_error_wrong_length, __func__ ,
+                                                          "use initial vector with wrong length" );
+ return ak_ctr_drbg_reseed(( ak_ctr_drbg ) rnd->data.ctx, ptr, size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_random_ctr_drbg_random( ak_random rnd, const ak_pointer ptr, const ssize_t size )
+{
+  ak_ctr_drbg ctx = NULL;
+
+  if( rnd == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                      "use a null pointer to a random generator" );
+  if( ptr == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                                    "use a null pointer to data" );
+  if( size <= 0 ) return ak_error_message( ak_error_wrong_length, __func__ ,
+                                                           "use a data vector with wrong length" );
+  ctx = ( ak_ctr_drbg ) rnd->data.ctx;
+#ifdef AK_RANDOM_BUFFER
+ /* короткие последовательности копируются из буфера: буфер обнуляется в дочернем процессе,
+    поэтому его повторное заполнение приводит к проверке номера процесса */
+  if(( ctx->buffer != NULL ) && (( size_t )size < ak_random_buffer_size/2 ))
+    return ak_random_buffer_ptr( ctx->buffer, ptr, ( size_t )size, ak_ctr_drbg_fill, ctx );
+#endif
+ return ak_ctr_drbg_fill( ctx, ptr, ( size_t )size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_random_ctr_drbg_free( ak_random rnd )
+{
+  ak_ctr_drbg ctx = NULL;
+
+  if( rnd == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                     "use a null pointer to a random generator" );
+  if(( ctx = ( ak_ctr_drbg ) rnd->data.ctx ) == NULL ) return ak_error_ok;
+
+#ifdef AK_RANDOM_BUFFER
+  ak_random_buffer_delete( ctx->buffer );
+#endif
+  ak_bckey_destroy( &ctx->key );
+  ak_random_destroy( &ctx->source );
+  memset( ctx, 0, sizeof( struct ctr_drbg ));
+  free( ctx );
+  rnd->data.ctx = NULL;
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Генератор вырабатывает последовательность псевдо-случайных значений с помощью алгоритма
+    блочного шифрования Кузнечик (ГОСТ Р 34.12-2015) в режиме гаммирования (ГОСТ Р 34.13-2015);
+    схема генератора аналогична схеме CTR_DRBG из NIST SP 800-90A.
+
+    При каждом обращении генератор вырабатывает необходимое количество блоков гаммы за один
+    вызов функции ak_bckey_ctr(), после чего, продолжая ту же гамму, вырабатывает новые значения
+    ключа и синхропосылки; использованный ключ уничтожается. Запросы длиной более 64 Кб
+    разбиваются на несколько частей. Короткие последовательности (менее 2 Кб) копируются
+    из буфера гаммы размером 4 Кб, который обнуляется при порождении нового процесса
+    (если опция `use_random_buffer` отлична от нуля и ядро ОС поддерживает флаг MADV_WIPEONFORK);
+    использованные байты буфера сразу же обнуляются.
+
+    Начальное значение ключа, а также его последующие обновления, вырабатываются системным
+    генератором (getrandom, /dev/urandom или winrtl). Обновление выполняется после каждых
+    `drbg_reseed_interval` обращений (опция библиотеки), а также при первом обращении к генератору
+    из дочернего процесса. Функция ak_random_randomize() выполняет внеочередное обновление,
+    дополнительно используя переданные ей данные.
+
+    @param generator Контекст создаваемого генератора.
+    \return В случае успеха, функция возвращает \ref ak_error_ok. В противном случае
+            возвращается код ошибки.                                                               */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_random_create_ctr_drbg( ak_random generator )
+{
+  ak_ctr_drbg ctx = NULL;
+  int error = ak_error_ok;
+
+  if(( error = ak_random_create( generator )) != ak_error_ok )
+    return ak_error_message( error, __func__ , "wrong initialization of random generator" );
+
+  if(( ctx = malloc( sizeof( struct ctr_drbg ))) == NULL )
+    return ak_error_message( ak_error_out_of_memory, __func__ ,
+                                                   "incorrect memory allocation for drbg context" );
+  memset( ctx, 0, sizeof( struct ctr_drbg ));
+  if(( error = ak_random_create_system( &ctx->source )) != ak_error_ok ) {
+    free( ctx );
+    return ak_error_message( error, __func__ , "wrong creation of entropy source" );
+  }
+  if(( error = ak_bckey_create_kuznechik( &ctx->key )) != ak_error_ok ) {
+    ak_random_destroy( &ctx->source );
+    free( ctx );
+    return ak_error_message( error, __func__ , "wrong creation of block cipher key" );
+  }
+  ctx->interval = ( ak_uint64 ) ak_libakrypt_get_option_by_name( "drbg_reseed_interval" );
+#ifdef AK_RANDOM_BUFFER
+  if( ak_libakrypt_get_option_by_name( "use_random_buffer" ))
+    ctx->buffer = ak_random_buffer_new();
+#endif
+
+  generator->data.ctx = ctx;
+  generator->oid = ak_oid_find_by_name("ctr-drbg-kuznechik");
+  generator->next = NULL;
+  generator->randomize_ptr = ak_random_ctr_drbg_randomize_ptr;
+  generator->random = ak_random_ctr_drbg_random;
+  generator->free = ak_random_ctr_drbg_free;
+
+  if(( error = ak_ctr_drbg_reseed( ctx, NULL, 0 )) != ak_error_ok ) {
+    ak_random_destroy( generator );
+    return ak_error_message( error, __func__ , "wrong instantiation of random generator" );
+  }
+
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*                             генератор, связанный с текущим потоком                              */
+/* ----------------------------------------------------------------------------------------------- */
+#ifdef AK_HAVE_PTHREAD_H
+/*! \brief Ключ, с помощью которого каждый поток хранит указатель на собственный генератор. */
+ static pthread_key_t random_thread_key;
+/*! \brief Флаг однократного создания ключа random_thread_key. */
+ static pthread_once_t random_thread_once = PTHREAD_ONCE_INIT;
+/*! \brief Результат создания ключа random_thread_key. */
+ static int random_thread_key_error = 0;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вызывается при завершении потока и уничтожает его генератор. */
+ static void ak_random_thread_generator_delete( void *rnd )
+{
+  if( rnd != NULL ) ak_random_delete( rnd );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_random_thread_key_create( void )
+{
+  random_thread_key_error =
+                       pthread_key_create( &random_thread_key, ak_random_thread_generator_delete );
+}
+#else
+/*! \brief Генератор, используемый при отсутствии поддержки потоков. */
+ static ak_random random_thread_generator = NULL;
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция возвращает указатель на генератор, принадлежащий вызывающему потоку. Генератор
+    создается при первом обращении из потока и уничтожается при завершении потока
+    (для потока, вызвавшего функцию ak_libakrypt_destroy(), - при ее вызове). Поскольку генератор
+    не доступен другим потокам, его использование не требует блокировок.
+
+    В качестве генератора используется ctr-drbg-kuznechik, состояние которого обновляется
+    с помощью системного генератора, в том числе, при первом обращении из дочернего процесса.
+    Если данный генератор не может быть создан, используется системный генератор.
+
+    Указатель на генератор текущего потока используется функциями выработки ключей и
+    электронной подписи в случае, когда вместо генератора передается NULL.
+
+    @return Функция возвращает указатель на генератор. В случае ошибки возвращается NULL,
+    при этом код ошибки может быть получен с помощью вызова функции ak_error_get_value().          */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_random ak_random_get_thread_generator( void )
+{
+  ak_random rnd = NULL;
+
+#ifdef AK_HAVE_PTHREAD_H
+  pthread_once( &random_thread_once, ak_random_thread_key_create );
+  if( random_thread_key_error != 0 ) {
+    ak_error_message( ak_error_undefined_value, __func__ ,
+                                                "wrong creation of thread specific data key" );
+    return NULL;
+  }
+  if(( rnd = pthread_getspecific( random_thread_key )) != NULL ) return rnd;
+#else
+  if(( rnd = random_thread_generator ) != NULL ) return rnd;
+#endif
+
+  if(( rnd = malloc( sizeof( struct random ))) == NULL ) {
+    ak_error_message( ak_error_out_of_memory, __func__ ,
+                                          "incorrect memory allocation for random generator" );
+    return NULL;
+  }
+  if( ak_random_create_ctr_drbg( rnd ) != ak_error_ok ) {
+    if( ak_random_create_system( rnd ) != ak_error_ok ) {
+      free( rnd );
+      ak_error_message( ak_error_get_value(), __func__ ,
+                                                "wrong creation of thread random generator" );
+      return NULL;
+    }
+  }
+
+#ifdef AK_HAVE_PTHREAD_H
+  if( pthread_setspecific( random_thread_key, rnd ) != 0 ) {
+    ak_random_delete( rnd );
+    ak_error_message( ak_error_undefined_value, __func__ ,
+                                             "wrong assigning of thread specific random generator" );
+    return NULL;
+  }
+#else
+  random_thread_generator = rnd;
+#endif
+ return rnd;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция уничтожает генератор, принадлежащий вызывающему потоку (если он был создан).          */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_random_thread_generator_destroy( void )
+{
+#ifdef AK_HAVE_PTHREAD_H
+  ak_random rnd = NULL;
+
+  if( random_thread_key_error != 0 ) return;
+  pthread_once( &random_thread_once, ak_random_thread_key_create );
+  if(( rnd = pthread_getspecific( random_thread_key )) != NULL ) {
+    pthread_setspecific( random_thread_key, NULL );
+    ak_random_delete( rnd );
+  }
+#else
+  if( random_thread_generator != NULL )
+    random_thread_generator = ak_random_delete( random_thread_generator );
+#endif
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*                                 реализация класса rng_winrtl                                    */
 /* ----------------------------------------------------------------------------------------------- */
@@ -487,7 +1216,8 @@
 /* ----------------------------------------------------------------------------------------------- */
  int ak_ptr_wipe( ak_pointer ptr, size_t size, ak_random rnd )
 {
-  size_t idx = 0;
+  ak_uint64 x, y;
+  size_t idx = 0, words = size >> 3;
   if( rnd == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
                                                 "using null pointer to random generator context" );
   if( rnd->random == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
@@ -500,8 +1230,16 @@
     memset( ptr, 0, size );
     return ak_error_message( ak_error_write_data, __func__, "incorrect memory wiping" );
   }
- /* запись в память при чтении => необходим вызов функции чтения данных из ptr */
-  for( idx = 0; idx < size; idx++ ) ((ak_uint8 *)ptr)[idx] += ((ak_uint8 *)ptr)[size - 1 - idx];
+ /* запись в память при чтении => необходим вызов функции чтения данных из ptr;
+    основной массив обрабатывается словами длины 8 байт */
+  for( idx = 0; idx < words; idx++ ) {
+     memcpy( &x, (ak_uint8 *)ptr + ( idx << 3 ), sizeof( x ));
+     memcpy( &y, (ak_uint8 *)ptr + (( words - 1 - idx ) << 3 ), sizeof( y ));
+     x += y;
+     memcpy( (ak_uint8 *)ptr + ( idx << 3 ), &x, sizeof( x ));
+  }
+  for( idx = ( words << 3 ); idx < size; idx++ )
+     ((ak_uint8 *)ptr)[idx] += ((ak_uint8 *)ptr)[size - 1 - idx];
  return ak_error_ok;
 }
 
@@ -9,6 +9,16 @@
 #ifdef AK_HAVE_TIME_H
  #include <time.h>
 #endif
+#ifdef AK_HAVE_STDLIB_H
+ #include <stdlib.h>
+#endif
+#ifdef AK_HAVE_PTHREAD_H
+ #include <pthread.h>
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Мьютекс, защищающий создание таблиц кратных точек открытых ключей. */
+ static pthread_mutex_t verifykey_qtable_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Установление или изменение маски секретного ключа ассиметричного криптографического
@@ -37,7 +47,7 @@
 #ifndef AK_LITTLE_ENDIAN
   int i = 0;
 #endif
-  ak_mpznmax u, zeta;
+  ak_mpznmax zeta;
   ak_wcurve wc = NULL;
   int error = ak_error_ok;
   ak_uint64 *key = NULL, *mask = NULL;
@@ -80,10 +90,7 @@
      ak_mpzn_mul_montgomery( key, key, mask, wc->q, wc->nq, wc->size);
 
     /* вычисляем обратное значение для маски */
-     ak_mpzn_set_ui( u, wc->size, 2 );
-     ak_mpzn_sub( u, wc->q, u, wc->size );
-     ak_mpzn_modpow_montgomery( mask, // m <- m^{q-2} (mod q)
-                                    mask, u, wc->q, wc->nq, wc->size );
+     ak_mpzn_inverse_montgomery( mask, mask, wc->q, wc->nq, wc->r2q, wc->size ); // m <- m^{-1}
     /* меняем значение флага */
      skey->flags |= ak_key_flag_set_mask;
 
@@ -100,9 +107,7 @@
     /* домножаем ключ на случайное число */
      ak_mpzn_mul_montgomery( key, key, zeta, wc->q, wc->nq, wc->size );
     /* вычисляем обратное значение zeta */
-     ak_mpzn_set_ui( u, wc->size, 2 );
-     ak_mpzn_sub( u, wc->q, u, wc->size );
-     ak_mpzn_modpow_montgomery( zeta, zeta, u, wc->q, wc->nq, wc->size ); // z <- z^{q-2} (mod q)
+     ak_mpzn_inverse_montgomery( zeta, zeta, wc->q, wc->nq, wc->r2q, wc->size ); // z <- z^{-1}
 
     /* домножаем маску на обратное значение zeta */
      ak_mpzn_mul_montgomery( mask, mask, zeta, wc->q, wc->nq, wc->size );
@@ -459,7 +464,8 @@
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! @param sctx контекст секретного ключа алгоритма электронной подписи.
-    @param generator контекст генератора случайных чисел.
+    @param generator контекст генератора случайных чисел
+    (значение NULL означает использование генератора текущего потока).
     @return В случае успеха возвращается ноль (\ref ak_error_ok). В противном случае возвращается
     код ошибки.                                                                                    */
 /* ----------------------------------------------------------------------------------------------- */
@@ -472,8 +478,6 @@
                                                      "using null pointer to secret key context" );
   if( sctx->key.key_size == 0 ) return ak_error_message( ak_error_zero_length, __func__ ,
                                                      "using non initialized secret key context" );
-  if( generator == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
-                                                "using null pointer to random number generator" );
  /* присваиваем секретный ключ */
   if(( error = ak_skey_set_key_random( &sctx->key, generator )) != ak_error_ok )
     return ak_error_message( error, __func__ , "wrong generation a secret key context" );
@@ -594,7 +598,7 @@
 
  /* поскольку функция не экспортируется, мы оставляем все проверки функциям верхнего уровня */
  /* вычисляем r */
-  ak_wpoint_pow( &wr, &wc->point, k, wc->size, wc );
+  ak_wpoint_pow_base( &wr, k, wc->size, wc );
   ak_wpoint_reduce( &wr, wc );
   ak_mpzn_rem( r, wr.x, wc->q, wc->size );
 
@@ -635,7 +639,7 @@
 /* ----------------------------------------------------------------------------------------------- */
 /*! @param sctx Контекст секретного ключа алгоритма электронной подписи.
     @param generator Генератор случайной последовательности,
-    используемой в алгоритме подписи
+    используемой в алгоритме подписи (значение NULL означает использование генератора текущего потока).
     @param hash Последовательность байт, содержащая в себе хеш-код
     подписываемого сообщения.
     @param size Размер хеш-кода, в байтах.
@@ -659,8 +663,9 @@
 
   if( sctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
                                                       "using null pointer to secret key context" );
-  if( generator == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
-                                                 "using null pointer to random number generator" );
+  if(( generator == NULL ) && (( generator = ak_random_get_thread_generator()) == NULL ))
+    return ak_error_message( ak_error_get_value(), __func__,
+                                                   "using undefined random number generator" );
   if( hash == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
                                                               "using null pointer to hash value" );
   if( size != ( lb = sizeof( ak_uint64 )*(( ak_wcurve )sctx->key.data)->size ))
@@ -690,7 +695,7 @@
 /* ----------------------------------------------------------------------------------------------- */
 /*! @param sctx Контекст секретного ключа алгоритма электронной подписи.
     @param generator Генератор случайной последовательности,
-    используемой в алгоритме подписи
+    используемой в алгоритме подписи (значение NULL означает использование генератора текущего потока).
     @param in Указатель на входные данные которые подписываются.
     @param size Размер входных данных в байтах.
     @param out Область памяти, куда будет помещен результат. Память должна быть заранее выделена.
@@ -710,8 +715,6 @@
  /* необходимые проверки */
   if( sctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
                                                  "using null pointer to secret key context" );
-  if( generator == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
-                                                 "using null pointer to random number generator" );
   if( in == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
                                                    "using null pointer to signifying value" );
   if( sctx->ctx.data.sctx.hsize > sizeof( hash )) return ak_error_message( ak_error_wrong_length,
@@ -730,7 +733,7 @@
 /* ----------------------------------------------------------------------------------------------- */
 /*! @param sctx Kонтекст секретного ключа алгоритма электронной подписи.
     @param generator Генератор случайной последовательности,
-    используемой в алгоритме подписи
+    используемой в алгоритме подписи (значение NULL означает использование генератора текущего потока).
     @param filename Строка с именем файла для которого вычисляется электронная подпись.
     @param out Область памяти, куда будет помещен результат. Память должна быть заранее выделена.
     @param out_size Размер выделенной под выработанную ЭП памяти.
@@ -749,8 +752,6 @@
  /* необходимые проверки */
   if( sctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
                                                  "using null pointer to secret key context" );
-  if( generator == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
-                                                 "using null pointer to random number generator" );
   if( filename == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
                                                           "using null pointer to file name" );
   if( sctx->ctx.data.sctx.hsize > 64 ) return ak_error_message( ak_error_wrong_length,
@@ -875,7 +876,7 @@
  /* теперь определяем открытый ключ */
   ak_mpzn_mul_montgomery( k, ( ak_uint64 *)sctx->key.key, one,
                                                       pctx->wc->q, pctx->wc->nq, pctx->wc->size );
-  ak_wpoint_pow( &pctx->qpoint, &pctx->wc->point, k, pctx->wc->size, pctx->wc );
+  ak_wpoint_pow_base( &pctx->qpoint, k, pctx->wc->size, pctx->wc );
 
   ak_mpzn_mul_montgomery( k, ( ak_uint64 *)( sctx->key.key + sctx->key.key_size ),
                                                   one, pctx->wc->q, pctx->wc->nq, pctx->wc->size);
@@ -949,11 +950,67 @@
 
  /* если обобщенное имя владельца было определено, то удаляем его */
   if( pctx->name != NULL ) pctx->name = ak_tlv_delete( pctx->name );
+ /* удаляем таблицу кратных точек */
+  if( pctx->qtable != NULL ) free( pctx->qtable );
 
   memset( pctx, 0, sizeof( struct verifykey ));
  return error;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! Если использование таблицы разрешено, то при первой проверке электронной подписи для точки
+    \f$ Q \f$, являющейся открытым ключом, вычисляется таблица кратных точек (см. функцию
+    ak_wpoint_table_new()), которая хранится в контексте открытого ключа и используется
+    при всех последующих проверках. Это позволяет в несколько раз ускорить проверку подписей,
+    вырабатываемых на небольшом количестве часто используемых ключей. Объем памяти,
+    занимаемой таблицей, фиксирован и составляет 60 Кб для 256-ти битных кривых и
+    240 Кб для 512-ти битных кривых.
+
+    При запрете использования ранее созданная таблица удаляется, поэтому запрет не должен
+    выполняться одновременно с проверкой подписи в других потоках.
+
+    @param pctx Контекст открытого ключа.
+    @param enable Флаг разрешения использования таблицы.
+    @return В случае успеха возвращается \ref ak_error_ok. В противном случае
+    возвращается код ошибки.                                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_verifykey_set_precomputation( ak_verifykey pctx, bool_t enable )
+{
+  if( pctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                      "using null pointer to public key context" );
+#ifdef AK_HAVE_PTHREAD_H
+  pthread_mutex_lock( &verifykey_qtable_mutex );
+#endif
+  if(( pctx->qtable_enabled = enable ) == ak_false ) {
+    if( pctx->qtable != NULL ) free( pctx->qtable );
+    pctx->qtable = NULL;
+  }
+#ifdef AK_HAVE_PTHREAD_H
+  pthread_mutex_unlock( &verifykey_qtable_mutex );
+#endif
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция возвращает таблицу кратных точки открытого ключа, создавая ее при первом
+    обращении; если использование таблицы не разрешено, возвращается NULL.                        */
+/* ----------------------------------------------------------------------------------------------- */
+ static ak_uint64 *ak_verifykey_get_qtable( ak_verifykey pctx )
+{
+  ak_uint64 *qtable = NULL;
+
+  if( !pctx->qtable_enabled ) return NULL;
+#ifdef AK_HAVE_PTHREAD_H
+  pthread_mutex_lock( &verifykey_qtable_mutex );
+#endif
+  if( pctx->qtable == NULL ) pctx->qtable = ak_wpoint_table_new( &pctx->qpoint, pctx->wc );
+  qtable = pctx->qtable;
+#ifdef AK_HAVE_PTHREAD_H
+  pthread_mutex_unlock( &verifykey_qtable_mutex );
+#endif
+ return qtable;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! @param pctx контекст открытого ключа.
     @param hash хеш-код сообщения (последовательность байт), для которого проверяется электронная подпись.
@@ -969,8 +1026,9 @@
 #ifndef AK_LITTLE_ENDIAN
   int i = 0;
 #endif
-  ak_mpzn512 v, z1, z2, u, r, s, h;
-  struct wpoint cpoint, tpoint;
+  ak_mpzn512 v, z1, z2, r, s, h;
+  ak_uint64 *qtable = NULL;
+  struct wpoint cpoint;
 
   if( pctx == NULL ) {
     ak_error_message( ak_error_null_pointer, __func__,
@@ -1006,9 +1064,8 @@
   ak_mpzn_mul_montgomery( v, v, pctx->wc->r2q, pctx->wc->q, pctx->wc->nq, pctx->wc->size );
 
   /* вычисляем v (в представлении Монтгомери) */
-  ak_mpzn_set_ui( u, pctx->wc->size, 2 );
-  ak_mpzn_sub( u, pctx->wc->q, u, pctx->wc->size );
-  ak_mpzn_modpow_montgomery( v, v, u, pctx->wc->q, pctx->wc->nq, pctx->wc->size ); // v <- v^{q-2} (mod q)
+  ak_mpzn_inverse_montgomery( v, v, pctx->wc->q,
+                                  pctx->wc->nq, pctx->wc->r2q, pctx->wc->size ); // v <- v^{-1} (mod q)
 
   /* вычисляем z1 */
   ak_mpzn_mul_montgomery( z1, s, pctx->wc->r2q, pctx->wc->q, pctx->wc->nq, pctx->wc->size );
@@ -1022,9 +1079,9 @@
   ak_mpzn_mul_montgomery( z2, z2, pctx->wc->point.z, pctx->wc->q, pctx->wc->nq, pctx->wc->size );
 
  /* сложение точек и проверка */
-  ak_wpoint_pow( &cpoint, &pctx->wc->point, z1, pctx->wc->size, pctx->wc );
-  ak_wpoint_pow( &tpoint, &pctx->qpoint, z2, pctx->wc->size, pctx->wc );
-  ak_wpoint_add( &cpoint, &tpoint, pctx->wc );
+  if(( qtable = ak_verifykey_get_qtable( pctx )) != NULL )
+    ak_wpoint_pow_sum_table( &cpoint, z1, z2, qtable, pctx->wc->size, pctx->wc );
+   else ak_wpoint_pow_sum( &cpoint, z1, &pctx->qpoint, z2, pctx->wc->size, pctx->wc );
   ak_wpoint_reduce( &cpoint, pctx->wc );
   ak_mpzn_rem( cpoint.x, cpoint.x, pctx->wc->q, pctx->wc->size );
 
@@ -1116,6 +1173,271 @@
  return ak_verifykey_verify_hash( pctx, hash, pctx->ctx.data.sctx.hsize, sign );
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*                          пакетная проверка электронных подписей                                 */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция заменяет каждый из заданных вычетов (в представлении Монтгомери) на обратный,
+    используя одно обращение (метод Монтгомери одновременного обращения).
+    Все вычеты должны быть отличны от нуля, количество вычетов не должно превышать
+    \ref ak_verify_batch_size.                                                                     */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_mpzn_invert_montgomery_batch( ak_uint64 **x, const size_t count,
+                                   ak_uint64 *p, ak_uint64 n0, ak_uint64 *r2, const size_t size )
+{
+  size_t i;
+  ak_mpzn512 prefix[ak_verify_batch_size], inv, u;
+
+  if( !count ) return;
+  ak_mpzn_set( prefix[0], x[0], size );
+  for( i = 1; i < count; i++ ) ak_mpzn_mul_montgomery( prefix[i], prefix[i-1], x[i], p, n0, size );
+
+  ak_mpzn_inverse_montgomery( inv, prefix[count-1], p, n0, r2, size ); // inv <- 1/(x_0 ... x_{n-1})
+
+  for( i = count-1; i > 0; i-- ) {
+     ak_mpzn_mul_montgomery( u, inv, prefix[i-1], p, n0, size );
+     ak_mpzn_mul_montgomery( inv, inv, x[i], p, n0, size );
+     ak_mpzn_set( x[i], u, size );
+  }
+  ak_mpzn_set( x[0], inv, size );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция проверяет электронные подписи для группы задач, количество которых
+    не превышает \ref ak_verify_batch_size. Обращения по модулям \f$ q \f$ и \f$ p \f$
+    выполняются одновременно для всех задач группы, использующих одну и ту же кривую.              */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_verifykey_verify_group( ak_verify_task tasks, const size_t count )
+{
+#ifndef AK_LITTLE_ENDIAN
+  size_t k = 0;
+#endif
+  size_t i, j, cnt;
+  ak_wcurve wc = NULL;
+  ak_verify_task task = NULL;
+  ak_uint8 hash[64];
+  ak_uint64 *list[ak_verify_batch_size], *qtable = NULL, one[ak_mpzn512_size] = ak_mpzn512_one;
+  ak_mpzn512 e[ak_verify_batch_size], r[ak_verify_batch_size], s[ak_verify_batch_size], z1, z2;
+  struct wpoint wr[ak_verify_batch_size];
+  bool_t active[ak_verify_batch_size], done[ak_verify_batch_size];
+  struct hash ctx256, ctx512;
+  bool_t is256 = ak_false, is512 = ak_false;
+
+ /* импортируем подписи и хеш-коды, e <- h (mod q) в представлении Монтгомери */
+  for( i = 0; i < count; i++ ) {
+     task = tasks+i;
+     task->result = active[i] = done[i] = ak_false;
+     task->error = ak_error_ok;
+
+     if(( task->key == NULL ) || ( task->sign == NULL ) ||
+                                               (( task->hash == NULL ) && ( task->data == NULL ))) {
+       task->error = ak_error_null_pointer;
+       continue;
+     }
+     wc = task->key->wc;
+     if( task->hash != NULL ) {
+       if( task->size != sizeof( ak_uint64 )*wc->size ) {
+         task->error = ak_error_wrong_length;
+         continue;
+       }
+       memcpy( hash, task->hash, task->size );
+     } else {
+        ak_hash hctx = NULL;
+        if( wc->size == ak_mpzn256_size ) {
+          if( !is256 ) is256 = ( ak_hash_create_streebog256( &ctx256 ) == ak_error_ok );
+          if( is256 ) hctx = &ctx256;
+        } else {
+           if( !is512 ) is512 = ( ak_hash_create_streebog512( &ctx512 ) == ak_error_ok );
+           if( is512 ) hctx = &ctx512;
+          }
+        if( hctx == NULL ) {
+          task->error = ak_error_get_value();
+          continue;
+        }
+        if(( task->error = ak_hash_ptr( hctx, task->data, task->size, hash,
+                                                              sizeof( hash ))) != ak_error_ok )
+          continue;
+       }
+
+     memcpy( e[i], hash, sizeof( ak_uint64 )*wc->size );
+#ifndef AK_LITTLE_ENDIAN
+     for( k = 0; k < wc->size; k++ ) e[i][k] = bswap_64( e[i][k] );
+#endif
+     ak_mpzn_set_little_endian( s[i], wc->size, task->sign, sizeof(ak_uint64)*wc->size, ak_true );
+     ak_mpzn_set_little_endian( r[i], wc->size, ( ak_uint64* )task->sign + wc->size,
+                                                            sizeof(ak_uint64)*wc->size, ak_true );
+    /* значения r и s должны удовлетворять неравенствам 0 < r, s < q */
+     if( ak_mpzn_cmp_ui( r[i], wc->size, 0 ) || ( ak_mpzn_cmp( r[i], wc->q, wc->size ) >= 0 ) ||
+         ak_mpzn_cmp_ui( s[i], wc->size, 0 ) || ( ak_mpzn_cmp( s[i], wc->q, wc->size ) >= 0 ))
+       continue;
+
+     ak_mpzn_rem( e[i], e[i], wc->q, wc->size );
+     if( ak_mpzn_cmp_ui( e[i], wc->size, 0 )) ak_mpzn_set_ui( e[i], wc->size, 1 );
+     ak_mpzn_mul_montgomery( e[i], e[i], wc->r2q, wc->q, wc->nq, wc->size );
+     active[i] = ak_true;
+  }
+  if( is256 ) ak_hash_destroy( &ctx256 );
+  if( is512 ) ak_hash_destroy( &ctx512 );
+
+ /* вычисляем v <- e^{-1} (mod q) одновременно для всех задач с одинаковой кривой */
+  for( i = 0; i < count; i++ ) {
+     if( !active[i] || done[i] ) continue;
+     wc = tasks[i].key->wc;
+     for( j = i, cnt = 0; j < count; j++ )
+        if( active[j] && ( tasks[j].key->wc == wc )) { list[cnt++] = e[j]; done[j] = ak_true; }
+     ak_mpzn_invert_montgomery_batch( list, cnt, wc->q, wc->nq, wc->r2q, wc->size );
+  }
+
+ /* вычисляем точки [z1]P + [z2]Q */
+  for( i = 0; i < count; i++ ) {
+     if( !active[i] ) continue;
+     task = tasks+i;
+     wc = task->key->wc;
+
+     ak_mpzn_mul_montgomery( z1, s[i], wc->r2q, wc->q, wc->nq, wc->size );
+     ak_mpzn_mul_montgomery( z1, z1, e[i], wc->q, wc->nq, wc->size );
+     ak_mpzn_mul_montgomery( z1, z1, one, wc->q, wc->nq, wc->size );
+
+     ak_mpzn_mul_montgomery( z2, r[i], wc->r2q, wc->q, wc->nq, wc->size );
+     ak_mpzn_sub( z2, wc->q, z2, wc->size );
+     ak_mpzn_mul_montgomery( z2, z2, e[i], wc->q, wc->nq, wc->size );
+     ak_mpzn_mul_montgomery( z2, z2, one, wc->q, wc->nq, wc->size );
+
+     if(( qtable = ak_verifykey_get_qtable( task->key )) != NULL )
+       ak_wpoint_pow_sum_table( wr+i, z1, z2, qtable, wc->size, wc );
+      else ak_wpoint_pow_sum( wr+i, z1, &task->key->qpoint, z2, wc->size, wc );
+    /* бесконечно удаленная точка не может быть результатом проверки */
+     if( ak_mpzn_cmp_ui( wr[i].z, wc->size, 0 )) active[i] = ak_false;
+     done[i] = ak_false;
+  }
+
+ /* приводим точки к аффинной форме и сравниваем x (mod q) с r */
+  for( i = 0; i < count; i++ ) {
+     if( !active[i] || done[i] ) continue;
+     wc = tasks[i].key->wc;
+     for( j = i, cnt = 0; j < count; j++ )
+        if( active[j] && ( tasks[j].key->wc == wc )) { list[cnt++] = wr[j].z; done[j] = ak_true; }
+     ak_mpzn_invert_montgomery_batch( list, cnt, wc->p, wc->n, wc->r2, wc->size );
+  }
+  for( i = 0; i < count; i++ ) {
+     if( !active[i] ) continue;
+     wc = tasks[i].key->wc;
+     wc->mul( wr[i].x, wr[i].x, wr[i].z, wc->p, wc->n, wc->size );
+     wc->mul( wr[i].x, wr[i].x, one, wc->p, wc->n, wc->size );
+     ak_mpzn_rem( wr[i].x, wr[i].x, wc->q, wc->size );
+     tasks[i].result = ( ak_mpzn_cmp( wr[i].x, r[i], wc->size ) == 0 );
+  }
+}
+
+#ifdef AK_HAVE_PTHREAD_H
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Общие данные потоков, выполняющих пакетную проверку электронных подписей. */
+ typedef struct verify_batch {
+  /*! \brief Массив задач */
+   ak_verify_task tasks;
+  /*! \brief Общее количество задач */
+   size_t count;
+  /*! \brief Индекс первой задачи, еще не переданной на обработку */
+   size_t next;
+  /*! \brief Мьютекс, защищающий значение next */
+   pthread_mutex_t mutex;
+ } *ak_verify_batch;
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция потока: последовательная обработка групп задач из общего массива. */
+/* ----------------------------------------------------------------------------------------------- */
+ static void *ak_verifykey_verify_thread( void *ptr )
+{
+  size_t first = 0;
+  ak_verify_batch batch = ( ak_verify_batch )ptr;
+
+  for( ;; ) {
+     pthread_mutex_lock( &batch->mutex );
+     first = batch->next;
+     batch->next = ak_min( batch->count, first + ak_verify_batch_size );
+     pthread_mutex_unlock( &batch->mutex );
+
+     if( first >= batch->count ) break;
+     ak_verifykey_verify_group( batch->tasks + first,
+                                               ak_min( batch->count - first, ak_verify_batch_size ));
+  }
+ return NULL;
+}
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция проверяет электронные подписи для массива независимых задач; для каждой задачи
+    результат совпадает с результатом функции ak_verifykey_verify_hash() (или
+    ak_verifykey_verify_ptr(), если хеш-код не задан), за исключением того, что подписи,
+    для которых не выполнены неравенства \f$ 0 < r, s < q \f$, всегда считаются неверными.
+
+    Задачи обрабатываются группами по \ref ak_verify_batch_size штук. Внутри группы
+    обращения элементов по модулю \f$ q \f$ (при вычислении \f$ e^{-1} \f$) и
+    по модулю \f$ p \f$ (при приведении точек к аффинной форме) выполняются одновременно
+    для всех задач, использующих одну и ту же эллиптическую кривую, а кратные точки вычисляются
+    функциями ak_wpoint_pow_sum() или ak_wpoint_pow_sum_table() (если для открытого ключа
+    разрешено использование таблицы кратных точек). Если библиотека собрана
+    с поддержкой pthreads и значение `threads` больше единицы, группы обрабатываются
+    заданным количеством потоков.
+
+    \note Поскольку подпись содержит только x-координату точки (по модулю q), объединение
+    проверок в одно линейное соотношение невозможно, и каждая подпись проверяется отдельно.
+
+    @param tasks Массив задач. Для каждой задачи в поле `result` помещается результат проверки,
+    а в поле `error` код ошибки (или \ref ak_error_ok).
+    @param count Количество задач в массиве.
+    @param threads Максимальное количество потоков; значения 0 и 1 означают, что вычисления
+    выполняются в вызывающем потоке.
+
+    @return Функция возвращает \ref ak_error_ok, если все задачи обработаны без ошибок
+    (при этом отдельные подписи могут быть неверны). В противном случае возвращается код
+    ошибки последней из необработанных задач.                                                      */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_verifykey_verify_batch( ak_verify_task tasks, const size_t count, const size_t threads )
+{
+  size_t idx = 0;
+  int error = ak_error_ok;
+
+  if( tasks == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                          "using null pointer to array of tasks" );
+  if( !count ) return ak_error_message( ak_error_zero_length, __func__ ,
+                                                         "using zero length of array of tasks" );
+#ifdef AK_HAVE_PTHREAD_H
+  if( threads > 1 ) {
+    struct verify_batch batch;
+    size_t tcnt = ak_min( threads, ( count + ak_verify_batch_size - 1 )/ak_verify_batch_size );
+    pthread_t *tid = NULL;
+
+    if(( tid = malloc( tcnt*sizeof( pthread_t ))) == NULL )
+      return ak_error_message( ak_error_out_of_memory, __func__ ,
+                                                 "incorrect memory allocation for thread handles" );
+    batch.tasks = tasks;
+    batch.count = count;
+    batch.next = 0;
+    pthread_mutex_init( &batch.mutex, NULL );
+
+   /* если поток не удалось создать, его работу выполнят остальные потоки */
+    for( idx = 0; idx < tcnt; idx++ )
+       if( pthread_create( tid+idx, NULL, ak_verifykey_verify_thread, &batch ) != 0 ) break;
+    if( idx == 0 ) ak_verifykey_verify_thread( &batch );
+    while( idx > 0 ) pthread_join( tid[--idx], NULL );
+
+    pthread_mutex_destroy( &batch.mutex );
+    free( tid );
+  } else
+#endif
+  {
+    for( idx = 0; idx < count; idx += ak_verify_batch_size )
+       ak_verifykey_verify_group( tasks+idx, ak_min( count - idx, ak_verify_batch_size ));
+  }
+
+  for( idx = 0; idx < count; idx++ )
+     if( tasks[idx].error != ak_error_ok ) error = tasks[idx].error;
+  if( error != ak_error_ok )
+    ak_error_message( error, __func__, "some of verification tasks are not completed" );
+
+ return error;
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! @param vk контекст открытого ключа электронной подписи
     @param ni строка, содержащая имя или идентификатор, определяющий тип помещаемых
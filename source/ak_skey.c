@@ -4,7 +4,7 @@
 /*  Файл ak_skey.c                                                                                 */
 /*  - содержит реализации функций, предназначенных для хранения и обработки ключевой информации.   */
 /* ----------------------------------------------------------------------------------------------- */
- #include <libakrypt.h>
+ #include <libakrypt-internal.h>
 
 /* ----------------------------------------------------------------------------------------------- */
 #ifdef AK_HAVE_TIME_H
@@ -25,6 +25,9 @@
 #else
  #error Library cannot be compiled without string.h header
 #endif
+#ifdef AK_HAVE_UNISTD_H
+ #include <unistd.h>
+#endif
 #ifdef AK_HAVE_PTHREAD_H
  #include <pthread.h>
 #endif
@@ -33,7 +36,15 @@
 /*! \brief Переменная определяет порядковый номер ключа в рамках одной сессии.
     Использование этой переменной помогает избежать одновременной генерации ключей при
     многопоточной реализации. */
- static ak_uint32 session_unique_number = 0;
+ static ak_uint64 session_unique_number = 0;
+/*! \brief Случайный префикс, из которого вместе с порядковым номером ключа вырабатываются
+    уникальные номера в рамках текущего процесса. */
+ static ak_uint64 session_unique_prefix[4];
+/*! \brief Идентификатор процесса, для которого выработан префикс (ноль, если префикс
+    еще не вырабатывался). Префикс вырабатывается заново в дочернем процессе: при наличии
+    pthreads значение обнуляется обработчиком, зарегистрированным функцией pthread_atfork(),
+    в противном случае идентификатор процесса сравнивается при каждой выработке номера. */
+ static ak_uint64 session_unique_prefix_pid = 0;
 #ifdef AK_HAVE_PTHREAD_H
  static pthread_mutex_t session_unique_number_mutex = PTHREAD_MUTEX_INITIALIZER;
 #endif
@@ -53,15 +64,16 @@
 }
 
 /* ----------------------------------------------------------------------------------------------- */
-/*! Выработанный функцией номер является уникальным (в рамках библиотеки) и может однозначно
-    идентифицировать некоторый объект, например, секретный ключ.
+/*! \brief Функция вырабатывает случайный префикс уникальных номеров текущего процесса.
+    \details Префикс вычисляется как хеш-код Стрибог256 от версии библиотеки, порядкового номера,
+    текущего времени и (как бы) случайных данных.
 
-    \param data вектор, куда помещается номер
+    \param data вектор, куда помещается префикс
     \param size размер вектора (в октетах); данная величина не должна превосходить 32-х.
     \return В случае успеха функция возвращает \ref ak_error_ok (ноль). В противном случае,
     возвращается номер ошибки.                                                                     */
 /* ----------------------------------------------------------------------------------------------- */
- int ak_libakrypt_generate_unique_number( ak_pointer data, const size_t size )
+ static int ak_libakrypt_generate_unique_prefix( ak_pointer data, const size_t size )
 {
   time_t tm = 0;
   size_t len = 0;
@@ -87,16 +99,9 @@
 
  /* добавляем уникальный номер ключа в рамках теущей сессии
     это не позволит в один интервал времени создать более одного ключа с одинаковым номером */
-  if( len + 2 > sizeof( out )) goto run_point;
-#ifdef AK_HAVE_PTHREAD_H
-  pthread_mutex_lock( &session_unique_number_mutex );
-#endif
-  session_unique_number++;
-#ifdef AK_HAVE_PTHREAD_H
-  pthread_mutex_unlock( &session_unique_number_mutex );
-#endif
-  memcpy( out+len, &session_unique_number, sizeof( ak_uint32 )); /* потом время генерации номера ключа */
-  len += sizeof( ak_uint32 );
+  if( len + sizeof( ak_uint64 ) > sizeof( out )) goto run_point;
+  memcpy( out+len, &session_unique_number, sizeof( ak_uint64 )); /* потом время генерации номера ключа */
+  len += sizeof( ak_uint64 );
 
  /* заполняем стандартное начало вектора: текущее время */
   if( len + sizeof( time_t ) > sizeof( out )) goto run_point;
@@ -138,6 +143,298 @@
  return error;
 }
 
+#ifdef AK_HAVE_PTHREAD_H
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Обработчик, вызываемый в дочернем процессе после вызова fork(). */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_libakrypt_reset_unique_prefix( void )
+{
+  session_unique_prefix_pid = 0;
+}
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вырабатывает префикс уникальных номеров, если он не был выработан
+    для процесса с заданным идентификатором.                                                       */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_libakrypt_update_unique_prefix( const ak_uint64 pid )
+{
+  int error = ak_error_ok;
+
+#ifdef AK_HAVE_PTHREAD_H
+  pthread_mutex_lock( &session_unique_number_mutex );
+#endif
+  if( session_unique_prefix_pid != pid ) {
+   #ifdef AK_HAVE_PTHREAD_H
+    static bool_t atfork = ak_false;
+    if( !atfork ) atfork = ( pthread_atfork( NULL, NULL,
+                                         ak_libakrypt_reset_unique_prefix ) == 0 ) ? ak_true : ak_false;
+   #endif
+    if(( error = ak_libakrypt_generate_unique_prefix( session_unique_prefix,
+                                                 sizeof( session_unique_prefix ))) == ak_error_ok )
+   #if defined( __GNUC__ ) || defined( __clang__ )
+      __atomic_store_n( &session_unique_prefix_pid, pid, __ATOMIC_RELEASE );
+   #else
+      session_unique_prefix_pid = pid;
+   #endif
+  }
+#ifdef AK_HAVE_PTHREAD_H
+  pthread_mutex_unlock( &session_unique_number_mutex );
+#endif
+ return error;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Перемешивающее биективное преобразование 64-х битных слов (функция fmix64 из MurmurHash3). */
+/* ----------------------------------------------------------------------------------------------- */
+ static inline ak_uint64 ak_libakrypt_mix64( ak_uint64 x )
+{
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ULL;
+ return x ^ ( x >> 33 );
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Выработанный функцией номер является уникальным (в рамках библиотеки) и может однозначно
+    идентифицировать некоторый объект, например, секретный ключ.
+
+    Номер вычисляется как значение \f$ (f(p_0 + n), f(p_1 + n), f(p_2 + n), f(p_3 + n)) \f$,
+    где \f$ n \f$ -- порядковый номер, увеличиваемый атомарно при каждом вызове функции,
+    \f$ p_i \f$ -- 64-х битные слова случайного префикса, вырабатываемого однократно для каждого
+    процесса с помощью функции хеширования Стрибог256, а \f$ f \f$ -- биективное
+    перемешивающее преобразование. Поскольку преобразование \f$ f \f$ обратимо, номера,
+    выработанные в одном процессе, не повторяются; выработка номера не требует вычисления
+    хеш-кода и захвата глобальной блокировки.
+
+    \param data вектор, куда помещается номер
+    \param size размер вектора (в октетах); данная величина не должна превосходить 32-х.
+    \return В случае успеха функция возвращает \ref ak_error_ok (ноль). В противном случае,
+    возвращается номер ошибки.                                                                     */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_libakrypt_generate_unique_number( ak_pointer data, const size_t size )
+{
+  size_t idx = 0;
+  ak_uint64 pid = 1, counter = 0, number[4];
+  int error = ak_error_ok;
+
+  if( data == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
+                                                           "using null pointer to result buffer" );
+  if( !size ) return ak_error_message( ak_error_zero_length, __func__,
+                                                                 "using buffer with zero length" );
+#if !defined( AK_HAVE_PTHREAD_H ) && defined( AK_HAVE_UNISTD_H )
+  pid = ( ak_uint64 ) getpid();
+#endif
+ /* префикс вырабатывается при первом обращении к функции, а также в дочернем процессе */
+#if defined( __GNUC__ ) || defined( __clang__ )
+  if( __atomic_load_n( &session_unique_prefix_pid, __ATOMIC_ACQUIRE ) != pid )
+#endif
+  if(( error = ak_libakrypt_update_unique_prefix( pid )) != ak_error_ok )
+    return ak_error_message( error, __func__, "incorrect generation of number prefix" );
+
+ /* увеличиваем порядковый номер */
+#if defined( __GNUC__ ) || defined( __clang__ )
+  counter = __atomic_add_fetch( &session_unique_number, 1, __ATOMIC_RELAXED );
+#else
+ #ifdef AK_HAVE_PTHREAD_H
+  pthread_mutex_lock( &session_unique_number_mutex );
+ #endif
+  counter = ++session_unique_number;
+ #ifdef AK_HAVE_PTHREAD_H
+  pthread_mutex_unlock( &session_unique_number_mutex );
+ #endif
+#endif
+
+  for( idx = 0; idx < 4; idx++ )
+     number[idx] = ak_libakrypt_mix64( session_unique_prefix[idx] + counter );
+  memset( data, 0, size );
+  memcpy( data, number, ak_min( size, sizeof( number )));
+
+ return ak_error_ok;
+}
+
+#if defined( AK_HAVE_SYSMMAN_H ) && defined( MAP_ANONYMOUS )
+/* ----------------------------------------------------------------------------------------------- */
+/*                 арена памяти, не выгружаемой в файл подкачки и не попадающей в дамп             */
+/* ----------------------------------------------------------------------------------------------- */
+ #define AK_SKEY_ARENA
+/*! \brief Количество страниц памяти, используемых для размещения ключей в одном блоке арены. */
+ #define ak_skey_arena_pages        (16)
+/*! \brief Двоичный логарифм минимального размера фрагмента памяти, выделяемого из арены. */
+ #define ak_skey_arena_min_shift     (5)
+/*! \brief Количество классов фрагментов (размеры фрагментов от 32 до 2048 байт). */
+ #define ak_skey_arena_classes       (7)
+/*! \brief Максимальный размер фрагмента памяти, выделяемого из арены. */
+ #define ak_skey_arena_max_size  ( (size_t)1 << ( ak_skey_arena_min_shift + ak_skey_arena_classes -1 ))
+
+/*! \brief Блок памяти арены, содержащий фрагменты одного размера.
+    Блок отделяется от соседних областей памяти сторожевыми страницами, доступ к которым запрещен;
+    сам блок по возможности блокируется в оперативной памяти (mlock) и исключается из дампа
+    памяти процесса. Описание блока хранится вне защищаемой области памяти.                        */
+ typedef struct skey_arena_slab {
+  /*! \brief Указатель на начало отображения (включая сторожевые страницы) */
+   ak_uint8 *base;
+  /*! \brief Общий размер отображения в байтах */
+   size_t size;
+  /*! \brief Класс фрагментов, размещаемых в блоке */
+   size_t class;
+  /*! \brief Следующий блок арены */
+   struct skey_arena_slab *next;
+ } *ak_skey_arena_slab;
+
+/*! \brief Арена памяти для хранения секретных ключей.
+    Для каждого класса фрагментов поддерживается односвязный список свободных фрагментов;
+    указатель на следующий свободный фрагмент хранится в начале самого фрагмента. */
+ static struct skey_arena {
+  /*! \brief Списки свободных фрагментов */
+   ak_pointer free[ ak_skey_arena_classes ];
+  /*! \brief Количество используемых фрагментов каждого класса */
+   size_t used[ ak_skey_arena_classes ];
+  /*! \brief Список блоков арены */
+   ak_skey_arena_slab slabs;
+ } skey_arena;
+
+#ifdef AK_HAVE_PTHREAD_H
+ static pthread_mutex_t skey_arena_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция возвращает класс фрагмента, достаточного для размещения size байт. */
+/* ----------------------------------------------------------------------------------------------- */
+ static size_t ak_skey_arena_class( size_t size )
+{
+  size_t class = 0;
+  while((( (size_t)1 << ( ak_skey_arena_min_shift + class )) < size ) &&
+                                                    ( class < ak_skey_arena_classes )) class++;
+ return class;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция создает новый блок арены и добавляет его фрагменты в список свободных. */
+/* ----------------------------------------------------------------------------------------------- */
+ static int ak_skey_arena_new_slab( size_t class )
+{
+  ak_uint8 *data = NULL;
+  ak_skey_arena_slab slab = NULL;
+  size_t idx, page = 4096, fragment = (size_t)1 << ( ak_skey_arena_min_shift + class );
+
+#if defined( AK_HAVE_UNISTD_H ) && defined( _SC_PAGESIZE )
+  long pagesize = sysconf( _SC_PAGESIZE );
+  if( pagesize > 0 ) page = (size_t) pagesize;
+#endif
+  if(( slab = malloc( sizeof( struct skey_arena_slab ))) == NULL )
+    return ak_error_message( ak_error_out_of_memory, __func__,
+                                                  "incorrect memory allocation for arena slab" );
+ /* отображение содержит две сторожевые страницы (в начале и в конце) */
+  slab->size = ( ak_skey_arena_pages + 2 )*page;
+  if(( slab->base = mmap( NULL, slab->size, PROT_NONE,
+                                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 )) == MAP_FAILED ) {
+    free( slab );
+    return ak_error_message( ak_error_out_of_memory, __func__, "incorrect mapping of arena slab" );
+  }
+  data = slab->base + page;
+  if( mprotect( data, ak_skey_arena_pages*page, PROT_READ | PROT_WRITE ) != 0 ) {
+    munmap( slab->base, slab->size );
+    free( slab );
+    return ak_error_message( ak_error_out_of_memory, __func__,
+                                                      "incorrect protection of arena slab pages" );
+  }
+ /* блокируем страницы в оперативной памяти; при превышении ограничения RLIMIT_MEMLOCK
+    арена продолжает использоваться, но ее страницы могут быть выгружены */
+  if( mlock( data, ak_skey_arena_pages*page ) != 0 )
+    ak_error_message( ak_error_ok, __func__, "arena slab pages can not be locked in memory" );
+ #ifdef MADV_DONTDUMP
+  madvise( data, ak_skey_arena_pages*page, MADV_DONTDUMP );
+ #endif
+
+ /* размещаем фрагменты в списке свободных в порядке возрастания адресов */
+  for( idx = ( ak_skey_arena_pages*page )/fragment; idx > 0; idx-- ) {
+     ak_pointer ptr = data + ( idx - 1 )*fragment;
+     memcpy( ptr, &skey_arena.free[class], sizeof( ak_pointer ));
+     skey_arena.free[class] = ptr;
+  }
+  slab->class = class;
+  slab->next = skey_arena.slabs;
+  skey_arena.slabs = slab;
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция выделяет из арены фрагмент памяти, размер которого не меньше size байт.
+    \return Указатель на выделенную память или NULL, если выделить память не удалось.              */
+/* ----------------------------------------------------------------------------------------------- */
+ static ak_pointer ak_skey_arena_alloc( size_t size )
+{
+  ak_pointer ptr = NULL;
+  size_t class = ak_skey_arena_class( size );
+
+  if( class >= ak_skey_arena_classes ) return NULL;
+#ifdef AK_HAVE_PTHREAD_H
+  pthread_mutex_lock( &skey_arena_mutex );
+#endif
+  if(( skey_arena.free[class] != NULL ) || ( ak_skey_arena_new_slab( class ) == ak_error_ok )) {
+    ptr = skey_arena.free[class];
+    memcpy( &skey_arena.free[class], ptr, sizeof( ak_pointer ));
+    memset( ptr, 0, sizeof( ak_pointer ));
+    skey_arena.used[class]++;
+  }
+#ifdef AK_HAVE_PTHREAD_H
+  pthread_mutex_unlock( &skey_arena_mutex );
+#endif
+ return ptr;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция очищает и возвращает в арену фрагмент памяти, выделенный функцией
+    ak_skey_arena_alloc().                                                                         */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_skey_arena_free( ak_pointer ptr, size_t size )
+{
+  size_t class = ak_skey_arena_class( size );
+
+  memset( ptr, 0, (size_t)1 << ( ak_skey_arena_min_shift + class ));
+#ifdef AK_HAVE_PTHREAD_H
+  pthread_mutex_lock( &skey_arena_mutex );
+#endif
+  memcpy( ptr, &skey_arena.free[class], sizeof( ak_pointer ));
+  skey_arena.free[class] = ptr;
+  skey_arena.used[class]--;
+#ifdef AK_HAVE_PTHREAD_H
+  pthread_mutex_unlock( &skey_arena_mutex );
+#endif
+}
+#endif
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция освобождает блоки арены, все фрагменты которых не используются.
+    Блоки, содержащие ключи, которые не были уничтожены до вызова функции, сохраняются.           */
+/* ----------------------------------------------------------------------------------------------- */
+ void ak_skey_arena_destroy( void )
+{
+#ifdef AK_SKEY_ARENA
+  size_t class;
+  ak_skey_arena_slab slab = NULL, *prev = &skey_arena.slabs;
+
+ #ifdef AK_HAVE_PTHREAD_H
+  pthread_mutex_lock( &skey_arena_mutex );
+ #endif
+  while(( slab = *prev ) != NULL ) {
+    if( skey_arena.used[slab->class] == 0 ) {
+      *prev = slab->next;
+      munmap( slab->base, slab->size );
+      free( slab );
+    } else prev = &slab->next;
+  }
+  for( class = 0; class < ak_skey_arena_classes; class++ )
+     if( skey_arena.used[class] == 0 ) skey_arena.free[class] = NULL;
+ #ifdef AK_HAVE_PTHREAD_H
+  pthread_mutex_unlock( &skey_arena_mutex );
+ #endif
+#endif
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! \details Функция выделяет массив памяти, достаточный для размещения секретного ключа и
     его маски (размер выделяемой памяти в точности равен удвленному разхмеру секретного ключа).
@@ -173,6 +470,24 @@
       skey->key = ptr;
       break;
 
+    case arena_policy:
+#ifdef AK_SKEY_ARENA
+     /* выделяем фрагмент заблокированной памяти (под ключ и его маску) */
+      if(( size << 1 ) > ak_skey_arena_max_size )
+        return ak_error_message( ak_error_wrong_length, __func__,
+                                                 "using a very huge key length for memory arena" );
+      if(( ptr = ak_skey_arena_alloc( size << 1 )) == NULL )
+        return ak_error_message( ak_error_out_of_memory, __func__,
+                                      "incorrect memory allocation for key buffer from arena" );
+      if( skey->key != NULL ) ak_skey_free_memory( skey );
+      memset( ptr, 0, size << 1 );
+      skey->key = ptr;
+      break;
+#else
+      return ak_error_message( ak_error_undefined_function, __func__,
+                                                "memory arena is not supported on this platform" );
+#endif
+
     default:
       return ak_error_message( ak_error_undefined_value, __func__,
                                                             "using unexpected allocation policy" );
@@ -211,6 +526,13 @@
       free( skey->key );
       break;
 
+#ifdef AK_SKEY_ARENA
+    case arena_policy:
+      skey->policy = undefined_policy;
+      ak_skey_arena_free( skey->key, skey->key_size << 1 );
+      break;
+#endif
+
     default:
       return ak_error_message( ak_error_undefined_value, __func__,
                                     "using secret key conetxt with unexpected allocation policy" );
@@ -281,8 +603,16 @@
                                                             "using a null pointer to secret key" );
   if( size == 0 ) return ak_error_message( ak_error_zero_length, __func__,
                                                               "using a zero length for key size" );
- /* Инициализируем данные базовыми значениями */
+ /* Инициализируем данные базовыми значениями;
+    память под ключ выделяется из арены заблокированной памяти, если это разрешено
+    опцией библиотеки use_locked_memory и длина ключа не слишком велика */
   skey->key = NULL;
+#ifdef AK_SKEY_ARENA
+  if( ak_libakrypt_get_option_by_name( "use_locked_memory" ) &&
+                                                    (( size << 1 ) <= ak_skey_arena_max_size ))
+    ak_skey_alloc_memory( skey, size, arena_policy ); /* при ошибке используется malloc() */
+  if( skey->key == NULL )
+#endif
   if(( error = ak_skey_alloc_memory( skey, size, malloc_policy )) != ak_error_ok ) {
     ak_error_message( error, __func__ ,"wrong allocation memory of internal secret key buffer" );
     ak_skey_destroy( skey );
@@ -290,11 +620,14 @@
   }
 
   skey->icode = 0; /* контрольная сумма ключа не задана */
+  skey->icode_interval = /* периодичность проверки контрольной суммы */
+                  ( ak_uint32 ) ak_libakrypt_get_option_by_name( "icode_check_interval" );
+  skey->icode_count = 0;
   skey->data = NULL; /* внутренние данные ключа не определены */
   memset( &(skey->resource), 0, sizeof( struct resource )); /* ресурс ключа не определен */
 
  /* инициализируем генератор масок */
-  if(( error = ak_random_create_lcg( &skey->generator )) != ak_error_ok ) {
+  if(( error = ak_random_create_xorshift128( &skey->generator )) != ak_error_ok ) {
     ak_error_message( error, __func__ , "wrong creation of random generator" );
     ak_skey_destroy( skey );
     return error;
@@ -369,6 +702,24 @@
  return ak_error_ok;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция вычисляет значение dst = dst xor src, обрабатывая данные словами длины 8 байт.
+    Копирование через memcpy() позволяет не требовать выравнивания указателей.                     */
+/* ----------------------------------------------------------------------------------------------- */
+ static void ak_skey_xor_words( ak_uint8 *dst, const ak_uint8 *src, const size_t size )
+{
+  ak_uint64 x, y;
+  size_t idx = 0;
+
+  for( ; idx + sizeof( ak_uint64 ) <= size; idx += sizeof( ak_uint64 )) {
+     memcpy( &x, dst+idx, sizeof( x ));
+     memcpy( &y, src+idx, sizeof( y ));
+     x ^= y;
+     memcpy( dst+idx, &x, sizeof( x ));
+  }
+  for( ; idx < size; idx++ ) dst[idx] ^= src[idx];
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Функция вырабатывает случайный вектор \f$ v \f$ длины, совпадающей с длиной ключа,
     и заменяет значение ключа \f$ k \f$ на величину \f$ k \oplus v \f$.
@@ -380,7 +731,6 @@
 /* ----------------------------------------------------------------------------------------------- */
  int ak_skey_set_mask_xor( ak_skey skey )
 {
-  size_t idx = 0, jdx = 0;
   int error = ak_error_ok;
 
  /* "стандартные" проверки указателей и выделения памяти */
@@ -398,8 +748,7 @@
        return ak_error_message( error, __func__ ,
                                                  "wrong generation a random mask for key buffer" );
     /* накладываем маску на ключ */
-     jdx = skey->key_size;
-     for( idx = 0; idx < skey->key_size; idx++, jdx++ ) skey->key[idx] ^= skey->key[jdx];
+     ak_skey_xor_words( skey->key, skey->key+skey->key_size, skey->key_size );
     /* меняем значение флага */
      skey->flags |= ak_key_flag_set_mask;
 
@@ -415,10 +764,8 @@
                                                      newmask, sizeof( newmask ))) != ak_error_ok )
                return ak_error_message( error, __func__ ,
                                                  "wrong generation a random mask for key buffer" );
-             for( idx = 0; idx < 64; idx++ ) {
-                  skey->key[offset+idx] ^= newmask[idx];
-                  skey->key[offset+idx+skey->key_size] ^= newmask[idx];
-             }
+             ak_skey_xor_words( skey->key+offset, newmask, sizeof( newmask ));
+             ak_skey_xor_words( skey->key+offset+skey->key_size, newmask, sizeof( newmask ));
           }
          /* потом обрабатываем хвост */
           if( tail ) {
@@ -426,10 +773,8 @@
                                                        newmask, (ssize_t)tail )) != ak_error_ok )
               return ak_error_message( error, __func__ ,
                                                   "wrong random mask generation for key buffer" );
-            for( idx = 0; idx < tail; idx++ ) {
-               skey->key[offset+idx] ^= newmask[idx];
-               skey->key[offset+idx+skey->key_size] ^= newmask[idx];
-            }
+            ak_skey_xor_words( skey->key+offset, newmask, tail );
+            ak_skey_xor_words( skey->key+offset+skey->key_size, newmask, tail );
           }
   }
 
@@ -444,8 +789,6 @@
 /* ----------------------------------------------------------------------------------------------- */
  int ak_skey_unmask_xor( ak_skey skey )
 {
-  size_t idx = 0, jdx = 0;
-
  /* "стандартные" проверки указателей и выделения памяти */
   if( skey == NULL ) return ak_error_message( ak_error_null_pointer,
                                          __func__ , "using a null pointer to secret key context" );
@@ -456,12 +799,9 @@
  /* проверяем, установлена ли маска ранее */
   if( (( skey->flags)&ak_key_flag_set_mask ) == 0 ) return ak_error_ok;
 
- /* снимаем маску с ключа (побайтно) */
-  jdx = skey->key_size;
-  for( idx = 0; idx < skey->key_size; idx++, jdx++ ) {
-     skey->key[idx] ^= skey->key[jdx];
-     skey->key[jdx] = 0;
-  }
+ /* снимаем маску с ключа (словами длины 8 байт) */
+  ak_skey_xor_words( skey->key, skey->key+skey->key_size, skey->key_size );
+  memset( skey->key+skey->key_size, 0, skey->key_size );
 
  /* меняем значение флага */
   skey->flags ^= ak_key_flag_set_mask;
@@ -529,6 +869,31 @@
     else return ak_false;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция используется в режимах шифрования и выработки имитовставки и вызывает
+    метод check_icode() не при каждом обращении к ключу, а один раз на `icode_check_interval`
+    обращений (опция библиотеки, значение которой считывается при создании ключа).
+    При значении опции, равном единице, контрольная сумма проверяется при каждом обращении.
+    При развертке раундовых ключей и экспорте ключа контрольная сумма проверяется всегда.
+
+    @param skey Контекст секретного ключа.
+    @return Функция возвращает истину (\ref ak_true), если контрольная сумма не проверялась
+    или совпала с вычисленным значением. В противном случае, возвращается ложь (\ref ak_false).   */
+/* ----------------------------------------------------------------------------------------------- */
+ bool_t ak_skey_check_icode_periodic( ak_skey skey )
+{
+  if( skey == NULL ) { ak_error_message( ak_error_null_pointer,
+                                         __func__ , "using a null pointer to secret key context" );
+    return ak_false;
+  }
+  if( skey->icode_count > 0 ) {
+    skey->icode_count--;
+    return ak_true;
+  }
+  skey->icode_count = skey->icode_interval > 0 ? skey->icode_interval - 1 : 0;
+ return skey->check_icode( skey );
+}
+
 /* ----------------------------------------------------------------------------------------------- */
 /*! Присвоение времени происходит следующим образом. Если `not_before` равно нулю, то
     устанавливается текущее время. Если `not_after` равно нулю или меньше, чем `not_before`,
@@ -717,7 +1082,8 @@
 
     @param skey Контекст секретного ключа. К моменту вызова функции контекст должен быть
     инициализирован.
-    @param generator Контекст генератора псевдо-случайных чисел.
+    @param generator Контекст генератора псевдо-случайных чисел
+    (значение NULL означает использование генератора текущего потока).
 
     @return В случае успеха возвращается значение \ref ak_error_ok. В противном случае
     возвращается код ошибки.                                                                       */
@@ -733,8 +1099,10 @@
                                                  __func__ , "using a null pointer to key buffer" );
   if( skey->key_size == 0 ) return ak_error_message( ak_error_zero_length, __func__ ,
                                                            "using a key buffer with zero length" );
-  if( generator == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
-                                                "using a null pointer to random number generator" );
+ /* при отсутствии генератора используем генератор текущего потока */
+  if(( generator == NULL ) && (( generator = ak_random_get_thread_generator()) == NULL ))
+    return ak_error_message( ak_error_get_value(), __func__ ,
+                                                   "using undefined random number generator" );
  /* присваиваем случайный ключ и случайную маску
     тем самым точное значение ключа ни как не фигурирует в явном виде */
   if(( error = ak_random_ptr( generator, skey->key,
@@ -810,6 +1178,163 @@
  return error;
 }
 
+/* ----------------------------------------------------------------------------------------------- */
+/*                            пул контекстов секретных ключей                                      */
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Функция возвращает указатель на секретный ключ, содержащийся в контексте объекта. */
+/* ----------------------------------------------------------------------------------------------- */
+ static ak_skey ak_key_pool_get_skey( ak_key_pool pool, ak_pointer ctx )
+{
+  switch( pool->oid->engine ) {
+    case block_cipher: return &(( ak_bckey )ctx )->key;
+    case hmac_function: return &(( ak_hmac )ctx )->key;
+    default: return NULL;
+  }
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Пул хранит контексты ключей алгоритма блочного шифрования или алгоритма HMAC, которые
+    были возвращены пользователем, и выдает их повторно. Повторно используемый контекст
+    не требует выделения памяти под ключ, инициализации генератора масок и,
+    для алгоритмов блочного шифрования, выделения памяти под раундовые ключи.
+
+    Пул не использует механизмов синхронизации, поэтому каждый поток должен
+    использовать собственный пул.
+
+    @param pool Контекст создаваемого пула.
+    @param oid Идентификатор алгоритма блочного шифрования или алгоритма HMAC.
+    @param size Максимальное количество хранимых в пуле свободных контекстов.
+    @return В случае успеха функция возвращает \ref ak_error_ok (ноль).
+    В противном случае, возвращается код ошибки.                                                   */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_key_pool_create( ak_key_pool pool, ak_oid oid, const size_t size )
+{
+  if( pool == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                          "using a null pointer to key pool" );
+  if( oid == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                           "using a null pointer to oid context" );
+  if(( oid->engine != block_cipher ) && ( oid->engine != hmac_function ))
+    return ak_error_message( ak_error_oid_engine, __func__ , "using oid with wrong engine" );
+  if( oid->mode != algorithm )
+    return ak_error_message( ak_error_oid_mode, __func__ , "using oid with wrong mode" );
+  if( size == 0 ) return ak_error_message( ak_error_zero_length, __func__ ,
+                                                              "using a zero length of key pool" );
+  if(( pool->contexts = malloc( size*sizeof( ak_pointer ))) == NULL )
+    return ak_error_message( ak_error_out_of_memory, __func__ ,
+                                                  "incorrect memory allocation for key pool" );
+  pool->oid = oid;
+  pool->count = 0;
+  pool->size = size;
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция уничтожает все хранящиеся в пуле контексты. Контексты, выданные пулом и не
+    возвращенные в него, должны уничтожаться функцией ak_oid_delete_object().
+
+    @param pool Контекст пула.
+    @return В случае успеха функция возвращает \ref ak_error_ok (ноль).
+    В противном случае, возвращается код ошибки.                                                   */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_key_pool_destroy( ak_key_pool pool )
+{
+  if( pool == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                          "using a null pointer to key pool" );
+  if( pool->contexts != NULL ) {
+    while( pool->count > 0 ) ak_oid_delete_object( pool->oid, pool->contexts[--pool->count] );
+    free( pool->contexts );
+    pool->contexts = NULL;
+  }
+  pool->size = 0;
+  pool->oid = NULL;
+
+ return ak_error_ok;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция возвращает контекст, ранее помещенный в пул, или, если пул пуст, создает новый
+    контекст. Полученному контексту присваивается новый уникальный номер; значение ключа
+    не определено и должно быть присвоено пользователем
+    (например, функциями ak_bckey_set_key() или ak_hmac_set_key()).
+
+    @param pool Контекст пула.
+    @return Функция возвращает указатель на контекст ключа. В случае ошибки возвращается NULL. */
+/* ----------------------------------------------------------------------------------------------- */
+ ak_pointer ak_key_pool_get( ak_key_pool pool )
+{
+  int error = ak_error_ok;
+  ak_pointer ctx = NULL;
+
+  if( pool == NULL ) {
+    ak_error_message( ak_error_null_pointer, __func__ , "using a null pointer to key pool" );
+    return NULL;
+  }
+  if( pool->count == 0 ) return ak_oid_new_object( pool->oid );
+
+  ctx = pool->contexts[--pool->count];
+  if(( error = ak_skey_set_unique_number( ak_key_pool_get_skey( pool, ctx ))) != ak_error_ok ) {
+    ak_error_message( error, __func__ , "invalid creation of key number" );
+    ak_oid_delete_object( pool->oid, ctx );
+    return NULL;
+  }
+ return ctx;
+}
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! Функция очищает значение ключа, его маску и синхропосылку, сбрасывает ресурс ключа и
+    помещает контекст в пул для последующего использования. Память, выделенная под ключ
+    и раундовые ключи, сохраняется; раундовые ключи хранятся в маскированном виде и
+    перезаписываются при следующем присвоении ключа. Если пул заполнен, контекст уничтожается.
+
+    @param pool Контекст пула.
+    @param ctx Контекст ключа, полученный ранее с помощью функции ak_key_pool_get().
+    @return В случае успеха функция возвращает \ref ak_error_ok (ноль).
+    В противном случае, возвращается код ошибки.                                                   */
+/* ----------------------------------------------------------------------------------------------- */
+ int ak_key_pool_put( ak_key_pool pool, ak_pointer ctx )
+{
+  ak_skey skey = NULL;
+
+  if( pool == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                          "using a null pointer to key pool" );
+  if( ctx == NULL ) return ak_error_message( ak_error_null_pointer, __func__ ,
+                                                       "using a null pointer to key context" );
+  if( pool->count == pool->size ) {
+    ak_oid_delete_object( pool->oid, ctx );
+    return ak_error_ok;
+  }
+
+ /* очищаем ключевую информацию, сохраняя выделенную память */
+  skey = ak_key_pool_get_skey( pool, ctx );
+  if( ak_ptr_wipe( skey->key, skey->key_size << 1, &skey->generator ) != ak_error_ok )
+    memset( skey->key, 0, skey->key_size << 1 );
+  if( pool->oid->engine == block_cipher ) {
+    ak_bckey bkey = ( ak_bckey )ctx;
+   /* раундовые ключи очищаются, память под них сохраняется для следующей развертки */
+    if( bkey->wipe_keys != NULL ) bkey->wipe_keys( skey );
+    ak_ptr_wipe( bkey->ivector, sizeof( bkey->ivector ), &skey->generator );
+    bkey->ivector_size = 0;
+  }
+  if( pool->oid->engine == hmac_function ) {
+    ak_hmac hctx = ( ak_hmac )ctx;
+   /* функция ak_hmac_clean() не используется, поскольку она заново обрабатывает ключ;
+      очищаются состояние функции хеширования и буферы промежуточных данных */
+    memset( hctx->mctx.data, 0, sizeof( hctx->mctx.data ));
+    hctx->mctx.length = 0;
+    ak_hash_clean( &hctx->ctx );
+  }
+  if( skey->label != NULL ) { free( skey->label ); skey->label = NULL; }
+  memset( skey->number, 0, sizeof( skey->number ));
+  memset( &skey->resource, 0, sizeof( struct resource ));
+  skey->icode = 0;
+  skey->icode_count = 0;
+  skey->flags &= ak_key_flag_data_not_free;
+
+  pool->contexts[pool->count++] = ctx;
+ return ak_error_ok;
+}
+
 #ifdef LIBAKRYPT_HAVE_DEBUG_FUNCTIONS
 /* ----------------------------------------------------------------------------------------------- */
 /*! Данная функция используется для отладки работы механизмов доступа и обработки ключевой
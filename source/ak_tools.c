@@ -872,9 +872,15 @@
 /* ----------------------------------------------------------------------------------------------- */
  int ak_ptr_fletcher32_xor( ak_const_pointer data, const size_t size, ak_uint32 *out )
 {
-  ak_uint32 sB = 0;
-  size_t idx = 0, cnt = size ^( size&0x1 );
+  ak_uint32 sA = 0, sB = 0, a1, a2, a3, t;
+  size_t idx = 0, cnt = size ^( size&0x1 ), blocks = size&( ~( size_t )0x7 );
   const ak_uint8 *ptr = data;
+ /* значения t*x^16 по модулю многочлена x^16 + 0x8BB7 для всех многочленов t степени не выше 3
+    (таблица занимает одну строку кэша) */
+  static const ak_uint32 reduce[16] = {
+    0x0000, 0x8BB7, 0x9CD9, 0x176E, 0xB205, 0x39B2, 0x2EDC, 0xA56B,
+    0xEFBD, 0x640A, 0x7364, 0xF8D3, 0x5DB8, 0xD60F, 0xC161, 0x4AD6
+  };
 
   if( data == NULL ) return ak_error_message( ak_error_null_pointer, __func__,
                                                               "using null pointer to input data" );
@@ -882,20 +888,33 @@
                                                                         "using zero length data" );
   if( out == NULL )  return ak_error_message( ak_error_null_pointer, __func__,
                                                            "using null pointer to output buffer" );
- /* основной цикл по четному числу байт  */
-  *out = 0;
-  while( idx < cnt ) {
-    *out ^= ( ptr[idx] | (ak_uint32)(ptr[idx+1] << 8));
-    sB = (( sB ^= *out )&0x8000) ? (sB << 1)^0x8BB7 : (sB << 1);
-    idx+= 2;
+ /* один шаг алгоритма состоит в вычислении sA ^= w, sB = x*( sB ^ sA ), где умножение
+    выполняется в кольце вычетов по модулю многочлена x^16 + 0x8BB7;
+    четыре последовательных шага объединяются в одно умножение на x^4 с последующим
+    приведением по модулю с помощью таблицы */
+  for( ; idx < blocks; idx += 8 ) {
+    ak_uint64 w;
+    memcpy( &w, ptr+idx, sizeof( w ));
+   #ifndef AK_LITTLE_ENDIAN
+    w = bswap_64( w );
+   #endif
+    a1 = sA ^ ( ak_uint32 )( w&0xFFFF );
+    a2 = a1 ^ ( ak_uint32 )(( w >> 16 )&0xFFFF );
+    a3 = a2 ^ ( ak_uint32 )(( w >> 32 )&0xFFFF );
+    sA = a3 ^ ( ak_uint32 )( w >> 48 );
+    t = (( sB ^ a1 ) << 4 ) ^ ( a2 << 3 ) ^ ( a3 << 2 ) ^ ( sA << 1 );
+    sB = ( t&0xFFFF ) ^ reduce[t >> 16];
   }
 
- /* дополняем последний (нечетный) байт */
-  if( idx != size ) {
-    *out ^= ptr[idx];
-    sB = (( sB ^= *out )&0x8000) ? (sB << 1)^0x8BB7 : (sB << 1);
+ /* оставшееся четное число байт обрабатывается по одному шагу
+    (умножение на x выполняется без условных переходов) */
+  for( ; idx < size; idx += 2 ) {
+    sA ^= ( idx < cnt ) ? ( ptr[idx] | (ak_uint32)( ptr[idx+1] << 8 )) : ptr[idx];
+    sB ^= sA;
+    sB = (( sB << 1 )&0xFFFF )^( 0x8BB7 & ( 0U - (( sB >> 15 )&0x1 )));
   }
-  *out ^= ( sB << 16 );
+
+  *out = sA ^ ( sB << 16 );
  return ak_error_ok;
 }
 
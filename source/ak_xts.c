@@ -45,10 +45,10 @@
   ak_uint64 tweak[2], t[2], *tptr = t;
 
  /* проверяем целостность ключа */
-  if( encryptionKey->key.check_icode( &encryptionKey->key ) != ak_true )
+  if( ak_skey_check_icode_periodic( &encryptionKey->key ) != ak_true )
     return ak_error_message( ak_error_wrong_key_icode, __func__,
                                                "incorrect integrity code of encryption key value" );
-  if( authenticationKey->key.check_icode( &authenticationKey->key ) != ak_true )
+  if( ak_skey_check_icode_periodic( &authenticationKey->key ) != ak_true )
     return ak_error_message( ak_error_wrong_key_icode, __func__,
                                            "incorrect integrity code of authentication key value" );
 
@@ -180,10 +180,10 @@
   ak_uint64 tweak[2], t[2], *tptr = t;
 
  /* проверяем целостность ключа */
-  if( encryptionKey->key.check_icode( &encryptionKey->key ) != ak_true )
+  if( ak_skey_check_icode_periodic( &encryptionKey->key ) != ak_true )
     return ak_error_message( ak_error_wrong_key_icode, __func__,
                                                "incorrect integrity code of encryption key value" );
-  if( authenticationKey->key.check_icode( &authenticationKey->key ) != ak_true )
+  if( ak_skey_check_icode_periodic( &authenticationKey->key ) != ak_true )
     return ak_error_message( ak_error_wrong_key_icode, __func__,
                                            "incorrect integrity code of authentication key value" );
 
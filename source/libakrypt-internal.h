@@ -31,6 +31,8 @@
 /*! \brief Процедура вычисления производного ключа в соответствии с алгоритмом ACPKM
     из рекомендаций Р 1323565.1.012-2018. */
  int ak_bckey_next_acpkm_key( ak_bckey );
+/*! \brief Освобождение неиспользуемых блоков арены памяти секретных ключей. */
+ void ak_skey_arena_destroy( void );
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Выработка матрицы, соответствующей 16 тактам работы линейного региста сдвига. */
@@ -66,6 +68,28 @@
  int ak_mac_ptr( ak_mac , ak_pointer , const size_t , ak_pointer , const size_t );
 /*! \brief Применение сжимающего отображения к заданному файлу. */
  int ak_mac_file( ak_mac , const char* , ak_pointer , const size_t );
+/*! \brief Вычисление хеш-кода Стрибог от одного блока длины 64 октета,
+    начиная с заданного промежуточного состояния. */
+ void ak_hash_streebog_block64( const ak_streebog , const ak_uint64 * , ak_uint64 * );
+/*! \brief Максимальное количество одновременно обрабатываемых состояний функции Стрибог. */
+ #define ak_hash_streebog_max_lanes  (4)
+/*! \brief Одновременное вычисление хеш-кодов Стрибог от нескольких блоков длины 64 октета. */
+ void ak_hash_streebog_block64_lanes( const ak_streebog * , ak_uint64 (*)[8] , const size_t );
+/*! \brief Одновременное завершение вычисления хеш-кодов Стрибог для нескольких состояний. */
+ void ak_hash_streebog_final_lanes( const ak_streebog * ,
+                                               ak_uint64 (*)[8] , const size_t , const size_t );
+/** @} */
+
+/** \addtogroup random-doc
+ @{ */
+/*! \brief Уничтожение генератора, принадлежащего текущему потоку. */
+ void ak_random_thread_generator_destroy( void );
+/** @} */
+
+/** \addtogroup curves-doc
+ @{ */
+/*! \brief Удаление таблиц кратных точек, созданных для эллиптических кривых. */
+ void ak_wcurve_tables_destroy( void );
 /** @} */
 
 /** \addtogroup aead-doc
@@ -180,6 +180,8 @@ extern "C" {
  dll_export bool_t ak_libakrypt_test_hmac_streebog( void );
 /*! \brief Тестирование алгоритма PBKDF2, регламентируемого Р 50.1.113-2016. */
  dll_export bool_t ak_libakrypt_test_pbkdf2( void );
+/*! \brief Тестирование алгоритмов выработки производных ключей из Р 50.1.113-2016. */
+ dll_export bool_t ak_libakrypt_test_kdf_tree( void );
 /*! \brief Функция тестирует корректность реализации блочных шифрова и режимов их использования. */
  dll_export bool_t ak_libakrypt_test_block_ciphers( void ); 
 /*! \brief Тестирование корректной работы алгоритма блочного шифрования Магма (ГОСТ Р 34.12-2015). */
@@ -423,6 +425,8 @@ extern "C" {
        ak_uint64 val;
      /*! \brief Внутреннее состояние xorshift32 генератора */
        ak_uint32 value;
+     /*! \brief Внутреннее состояние xorshift128+ генератора */
+       ak_uint64 xs[2];
      /*! \brief Файловый дескриптор */
        int fd;
     #ifdef AK_HAVE_WINDOWS_H
@@ -437,6 +441,8 @@ extern "C" {
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Инициализация контекста линейного конгруэнтного генератора псевдо-случайных чисел. */
  dll_export int ak_random_create_lcg( ak_random );
+/*! \brief Инициализация контекста генератора xorshift128+, используемого для выработки масок. */
+ dll_export int ak_random_create_xorshift128( ak_random );
  /*! \brief Инициализация контекста генератора, считывающего случайные значения из заданного файла. */
  dll_export int ak_random_create_file( ak_random , const char * );
 #if defined(__unix__) || defined(__APPLE__)
@@ -445,10 +451,18 @@ extern "C" {
 /*! \brief Инициализация контекста генератора, считывающего случайные значения из /dev/urandom. */
  dll_export int ak_random_create_urandom( ak_random );
 #endif
+#ifdef AK_HAVE_SYSRANDOM_H
+/*! \brief Инициализация контекста генератора, использующего системный вызов getrandom(). */
+ dll_export int ak_random_create_getrandom( ak_random );
+#endif
 #ifdef _WIN32
 /*! \brief Инициализация контекста, реализующего интерфейс доступа к генератору псевдо-случайных чисел, предоставляемому ОС Windows. */
  dll_export int ak_random_create_winrtl( ak_random );
 #endif
+/*! \brief Инициализация контекста генератора, использующего алгоритм Кузнечик в режиме гаммирования. */
+ dll_export int ak_random_create_ctr_drbg( ak_random );
+/*! \brief Получение генератора псевдо-случайных чисел, принадлежащего текущему потоку. */
+ dll_export ak_random ak_random_get_thread_generator( void );
 /*! \brief Инициализация контекста генератора по заданному OID алгоритма генерации псевдо-случайных чисел. */
  dll_export int ak_random_create_oid( ak_random, ak_oid );
 /*! \brief Установка внутреннего состояния генератора псевдо-случайных чисел. */
@@ -510,7 +524,11 @@ extern "C" {
   /*! \brief Механизм выделения памяти не определен. */
    undefined_policy,
   /*! \brief Выделение памяти через стандартный malloc */
-   malloc_policy
+   malloc_policy,
+  /*! \brief Выделение памяти из арены, страницы которой заблокированы в оперативной памяти
+      (не выгружаются в файл подкачки), не попадают в дамп памяти процесса и
+      отделены от соседних областей памяти сторожевыми страницами */
+   arena_policy
 
 } memory_allocation_policy_t;
 
@@ -587,6 +605,8 @@ extern "C" {
    ak_uint8 number[32];
   /*! \brief контрольная сумма ключа */
    ak_uint32 icode;
+  /*! \brief количество обращений к ключу, через которое проверяется его контрольная сумма */
+   ak_uint32 icode_interval;
   /*! \brief генератор случайных масок ключа */
    struct random generator;
   /*! \brief ресурс использования ключа */
@@ -599,6 +619,8 @@ extern "C" {
    key_flags_t flags;
   /*! \brief Способ выделения памяти. */
    memory_allocation_policy_t policy;
+  /*! \brief количество обращений к ключу, оставшихся до очередной проверки контрольной суммы */
+   ak_uint32 icode_count;
   /*! \brief указатель на функцию маскирования ключа */
    ak_function_skey *set_mask;
   /*! \brief указатель на функцию демаскирования ключа */
@@ -642,6 +664,8 @@ extern "C" {
  dll_export int ak_skey_set_icode_xor( ak_skey );
 /*! \brief Проверка значения контрольной суммы ключа. */
  dll_export bool_t ak_skey_check_icode_xor( ak_skey );
+/*! \brief Периодическая проверка значения контрольной суммы ключа. */
+ dll_export bool_t ak_skey_check_icode_periodic( ak_skey );
 /*! \brief Функция устанавливает ресурс ключа. */
  dll_export int ak_skey_set_resource( ak_skey , ak_resource );
 /*! \brief Функция устанавливает временной интервал действия ключа. */
@@ -652,6 +676,30 @@ extern "C" {
 /*! \brief Фукция присваивает пользовательскую метку ключу. */
  dll_export int ak_skey_set_label( ak_skey, const char * , const size_t );
 
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Пул контекстов ключей алгоритмов блочного шифрования или алгоритмов HMAC.
+    \details Пул позволяет повторно использовать созданные ранее контексты ключей,
+    сохраняя выделенную под них память. Пул не является потокобезопасным. */
+ typedef struct key_pool {
+  /*! \brief Идентификатор алгоритма, контексты которого хранятся в пуле */
+   ak_oid oid;
+  /*! \brief Массив указателей на свободные контексты */
+   ak_pointer *contexts;
+  /*! \brief Количество свободных контекстов */
+   size_t count;
+  /*! \brief Максимальное количество хранимых свободных контекстов */
+   size_t size;
+} *ak_key_pool;
+
+/*! \brief Создание пула контекстов ключей для заданного алгоритма. */
+ dll_export int ak_key_pool_create( ak_key_pool , ak_oid , const size_t );
+/*! \brief Уничтожение пула и всех хранящихся в нем контекстов. */
+ dll_export int ak_key_pool_destroy( ak_key_pool );
+/*! \brief Получение контекста ключа из пула. */
+ dll_export ak_pointer ak_key_pool_get( ak_key_pool );
+/*! \brief Возвращение контекста ключа в пул. */
+ dll_export int ak_key_pool_put( ak_key_pool , ak_pointer );
+
 #ifdef LIBAKRYPT_HAVE_DEBUG_FUNCTIONS
 /*! \brief Функция выводит информацию о контексте секретного ключа в заданный файл. */
  int ak_skey_print_to_file( ak_skey , FILE *fp );
@@ -688,6 +736,8 @@ extern "C" {
    ak_function_skey *schedule_keys;
   /*! \brief Функция уничтожения развернутых ключей. */
    ak_function_skey *delete_keys;
+  /*! \brief Функция очистки развернутых ключей без освобождения занимаемой ими памяти. */
+   ak_function_skey *wipe_keys;
 };
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -796,6 +846,8 @@ extern "C" {
 /*! \brief Завершение вычисления имитовставки согласно ГОСТ Р 34.13-2015. */
  dll_export int ak_bckey_cmac_finalize( ak_bckey , const ak_pointer , const size_t ,
                                                                        ak_pointer , const size_t );
+/*! \brief Вычисление имитовставки согласно ГОСТ Р 34.13-2015 для заданного файла. */
+ dll_export int ak_bckey_cmac_file( ak_bckey , const char * , ak_pointer , const size_t );
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Функция очистки контекста хеширования. */
  typedef int ( ak_function_clean )( ak_pointer );
@@ -968,6 +1020,77 @@ extern "C" {
 /*! \brief Развертка ключевого вектора из пароля (согласно Р 50.1.111-2016, раздел 4) */
  dll_export int ak_hmac_pbkdf2_streebog512( const ak_pointer , const size_t ,
                    const ak_pointer , const size_t, const size_t , const size_t , ak_pointer );
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Задача выработки ключевого вектора из пароля для пакетной обработки. */
+/* ----------------------------------------------------------------------------------------------- */
+ typedef struct pbkdf2_task {
+  /*! \brief Пароль */
+   ak_pointer pass;
+  /*! \brief Длина пароля (в октетах) */
+   size_t pass_size;
+  /*! \brief Инициализационный вектор (соль) */
+   ak_pointer salt;
+  /*! \brief Длина инициализационного вектора (в октетах) */
+   size_t salt_size;
+  /*! \brief Количество итераций алгоритма */
+   size_t count;
+  /*! \brief Длина вырабатываемого ключевого вектора, от 32-х до 64-х октетов */
+   size_t dklen;
+  /*! \brief Указатель на область памяти для вырабатываемого ключевого вектора */
+   ak_pointer out;
+  /*! \brief Код ошибки, возникшей при выполнении задачи */
+   int error;
+ } *ak_pbkdf2_task;
+
+/*! \brief Пакетная развертка ключевых векторов из паролей (согласно Р 50.1.111-2016, раздел 4) */
+ dll_export int ak_hmac_pbkdf2_streebog512_batch( ak_pbkdf2_task , const size_t , const size_t );
+/*! \brief Выработка производного ключевого вектора (согласно Р 50.1.113-2016, раздел 4.5) */
+ dll_export int ak_hmac_kdf_tree_streebog256( const ak_pointer , const size_t , const ak_pointer ,
+     const size_t , const ak_pointer , const size_t , const size_t , ak_pointer , const size_t );
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Максимальное количество уровней ключевого дерева. */
+ #define ak_kdf_tree_max_levels  (4)
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Ключевое дерево: иерархия производных ключей, вырабатываемых из одного ключа.
+
+    Ключ \f$ K_j \f$ уровня \f$ j \f$ вырабатывается из ключа предыдущего уровня по правилу
+    \f$ K_j = KDF_{256}( K_{j-1}, \text{"level}j\text{"}, STR_8( i \,\&\, C_j )) \f$,
+    где \f$ K_0 \f$ исходный ключ, \f$ i \f$ номер вырабатываемого ключа, а \f$ C_j \f$ маска
+    уровня. При трех уровнях дерево совпадает с преобразованием TLSTREE (Р 1323565.1.030-2019).
+
+    Для каждого уровня хранятся состояния функции хеширования Стрибог256 после обработки блоков
+    ipad и opad, поэтому ключи соседних номеров вырабатываются без повторного вычисления ключей
+    вышестоящих уровней.                                                                           */
+/* ----------------------------------------------------------------------------------------------- */
+ typedef struct kdf_tree {
+  /*! \brief Состояния функции хеширования после обработки блока ipad для ключей уровней */
+   struct streebog istate[ak_kdf_tree_max_levels];
+  /*! \brief Состояния функции хеширования после обработки блока opad для ключей уровней */
+   struct streebog ostate[ak_kdf_tree_max_levels];
+  /*! \brief Маски уровней дерева */
+   ak_uint64 mask[ak_kdf_tree_max_levels];
+  /*! \brief Значения номера ключа (с наложенной маской), для которых вычислены ключи уровней */
+   ak_uint64 index[ak_kdf_tree_max_levels];
+  /*! \brief Количество уровней дерева */
+   size_t levels;
+  /*! \brief Количество уровней, для которых вычислены состояния функции хеширования */
+   size_t valid;
+  /*! \brief Контекст функции хеширования Стрибог256 */
+   struct hash ctx;
+ } *ak_kdf_tree;
+
+/*! \brief Создание ключевого дерева с заданным исходным ключом. */
+ dll_export int ak_kdf_tree_create( ak_kdf_tree , const ak_pointer , const size_t ,
+                                                                const ak_uint64 * , const size_t );
+/*! \brief Уничтожение ключевого дерева. */
+ dll_export int ak_kdf_tree_destroy( ak_kdf_tree );
+/*! \brief Выработка ключа с заданным номером. */
+ dll_export int ak_kdf_tree_get_key( ak_kdf_tree , const ak_uint64 , ak_pointer , const size_t );
+/*! \brief Присвоение значений ключей с последовательными номерами контекстам секретных ключей. */
+ dll_export int ak_kdf_tree_set_keys( ak_kdf_tree , const ak_uint64 , ak_pointer * , const size_t );
 /** @} */
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -1094,14 +1217,39 @@ extern "C" {
 /*! \brief Сложение двух вычетов в представлении Монтгомери. */
  dll_export void ak_mpzn_add_montgomery( ak_uint64 *, ak_uint64 *,
                                                          ak_uint64 *, ak_uint64 *, const size_t );
+/*! \brief Вычитание двух вычетов в представлении Монтгомери. */
+ dll_export void ak_mpzn_sub_montgomery( ak_uint64 *, ak_uint64 *,
+                                                         ak_uint64 *, ak_uint64 *, const size_t );
 /*! \brief Удвоение на двойку в представлении Монтгомери. */
  dll_export void ak_mpzn_lshift_montgomery( ak_uint64 *, ak_uint64 *, ak_uint64 *, const size_t );
 /*! \brief Умножение двух вычетов в представлении Монтгомери. */
  dll_export void ak_mpzn_mul_montgomery( ak_uint64 *, ak_uint64 *, ak_uint64 *,
                                                            ak_uint64 *, ak_uint64, const size_t );
+/*! \brief Возведение вычета в квадрат в представлении Монтгомери. */
+ dll_export void ak_mpzn_sqr_montgomery( ak_uint64 *, ak_uint64 *,
+                                                           ak_uint64 *, ak_uint64, const size_t );
+/*! \brief Умножение вычетов в представлении Монтгомери по модулю вида 2^n - c. */
+ dll_export void ak_mpzn_mul_montgomery_pseudo_mersenne( ak_uint64 *, ak_uint64 *, ak_uint64 *,
+                                                           ak_uint64 *, ak_uint64, const size_t );
+/*! \brief Возведение вычета в квадрат в представлении Монтгомери по модулю вида 2^n - c. */
+ dll_export void ak_mpzn_sqr_montgomery_pseudo_mersenne( ak_uint64 *, ak_uint64 *,
+                                                           ak_uint64 *, ak_uint64, const size_t );
+/*! \brief Проверка того, что модуль имеет вид 2^n - c. */
+ dll_export bool_t ak_mpzn_is_pseudo_mersenne( ak_uint64 *, const size_t );
+/*! \brief Функция умножения двух вычетов в представлении Монтгомери. */
+ typedef void ( ak_function_mpzn_mul_montgomery )( ak_uint64 *, ak_uint64 *, ak_uint64 *,
+                                                           ak_uint64 *, ak_uint64, const size_t );
+/*! \brief Функция возведения вычета в квадрат в представлении Монтгомери. */
+ typedef void ( ak_function_mpzn_sqr_montgomery )( ak_uint64 *, ak_uint64 *,
+                                                           ak_uint64 *, ak_uint64, const size_t );
 /*! \brief Модульное возведение в степень в представлении Монтгомери. */
  dll_export void ak_mpzn_modpow_montgomery( ak_uint64 *, ak_uint64 *, ak_uint64 *,
                                                            ak_uint64 *, ak_uint64, const size_t );
+/*! \brief Вычисление обратного вычета по нечетному модулю (за время, не зависящее от вычета). */
+ dll_export void ak_mpzn_inverse( ak_uint64 *, ak_uint64 *, ak_uint64 *, const size_t );
+/*! \brief Вычисление обратного вычета в представлении Монтгомери. */
+ dll_export void ak_mpzn_inverse_montgomery( ak_uint64 *, ak_uint64 *, ak_uint64 *,
+                                                          ak_uint64 , ak_uint64 *, const size_t );
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Проверка на равенство двух 128-битных чисел. */
  dll_export int ak_128_equal( const ak_uint64 *x, const ak_uint64 *y );
@@ -1204,6 +1352,19 @@ extern "C" {
  dll_export void ak_wpoint_reduce( ak_wpoint , ak_wcurve );
 /*! \brief Вычисление кратной точки эллиптической кривой. */
  dll_export void ak_wpoint_pow( ak_wpoint , ak_wpoint , ak_uint64 *, size_t , ak_wcurve );
+/*! \brief Вычисление кратной точки эллиптической кривой с помощью лесенки Монтгомери. */
+ dll_export void ak_wpoint_pow_montgomery( ak_wpoint , ak_wpoint , ak_uint64 *, size_t , ak_wcurve );
+/*! \brief Вычисление кратной образующей точки эллиптической кривой с использованием
+    предвычисленной таблицы. */
+ dll_export void ak_wpoint_pow_base( ak_wpoint , ak_uint64 *, size_t , ak_wcurve );
+/*! \brief Вычисление суммы кратных образующей точки и заданной точки эллиптической кривой. */
+ dll_export void ak_wpoint_pow_sum( ak_wpoint , ak_uint64 *, ak_wpoint , ak_uint64 *,
+                                                                           size_t , ak_wcurve );
+/*! \brief Создание таблицы кратных заданной точки эллиптической кривой. */
+ dll_export ak_uint64 *ak_wpoint_table_new( ak_wpoint , ak_wcurve );
+/*! \brief Вычисление суммы кратных образующей точки и точки, для которой создана таблица. */
+ dll_export void ak_wpoint_pow_sum_table( ak_wpoint , ak_uint64 *, ak_uint64 *, ak_uint64 *,
+                                                                           size_t , ak_wcurve );
 
 /* ----------------------------------------------------------------------------------------------- */
 /*! \brief Класс, реализующий эллиптическую кривую, заданную в короткой форме Вейерштрасса
@@ -1248,6 +1409,12 @@ extern "C" {
  /*! \brief Строка, содержащая символьную запись модуля \f$ p \f$.
      \details Используется для проверки корректного хранения параметров кривой в памяти. */
   const char *pchar;
+ /*! \brief Функция умножения вычетов по модулю \f$ p \f$ в представлении Монтгомери.
+     \details Для модулей вида \f$ 2^n - c \f$ используется функция
+     ak_mpzn_mul_montgomery_pseudo_mersenne(), для остальных - ak_mpzn_mul_montgomery(). */
+  ak_function_mpzn_mul_montgomery *mul;
+ /*! \brief Функция возведения в квадрат вычетов по модулю \f$ p \f$ в представлении Монтгомери. */
+  ak_function_mpzn_sqr_montgomery *sqr;
 };
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -1767,6 +1934,12 @@ extern "C" {
   ak_tlv name;
  /*! \brief флаги состояния ключа */
   ak_uint64 flags;
+ /*! \brief таблица кратных точки qpoint, используемая при проверке электронной подписи;
+     создается при первой проверке подписи, если ее использование разрешено
+     функцией ak_verifykey_set_precomputation() */
+  ak_uint64 *qtable;
+ /*! \brief флаг, разрешающий создание таблицы кратных точки qpoint */
+  bool_t qtable_enabled;
 } *ak_verifykey;
 
 /* ----------------------------------------------------------------------------------------------- */
@@ -1870,6 +2043,8 @@ extern "C" {
  dll_export int ak_verifykey_add_name_string( ak_verifykey , const char * , const char * );
 /*! \brief Уничтожение контекста открытого ключа. */
  dll_export int ak_verifykey_destroy( ak_verifykey );
+/*! \brief Разрешение (или запрет) использования таблицы кратных точек открытого ключа. */
+ dll_export int ak_verifykey_set_precomputation( ak_verifykey , bool_t );
 /** \addtogroup cert-export-doc Функции экспорта и импорта открытых ключей
  @{ */
 /*! \brief Функция экспортирует открытый ключ асиметричного криптографического алгоритма
@@ -1933,6 +2108,34 @@ extern "C" {
                                                                        const size_t , ak_pointer );
 /*! \brief Проверка электронной подписи для заданного файла. */
  dll_export bool_t ak_verifykey_verify_file( ak_verifykey , const char * , ak_pointer );
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Количество задач, одновременно обрабатываемых при пакетной проверке подписей. */
+ #define ak_verify_batch_size  (16)
+
+/* ----------------------------------------------------------------------------------------------- */
+/*! \brief Задача проверки электронной подписи для пакетной обработки. */
+/* ----------------------------------------------------------------------------------------------- */
+ typedef struct verify_task {
+  /*! \brief Открытый ключ проверки подписи */
+   ak_verifykey key;
+  /*! \brief Хеш-код подписанного сообщения; если значение равно NULL, то хеш-код
+      вычисляется от данных, на которые указывает поле `data` */
+   ak_pointer hash;
+  /*! \brief Подписанное сообщение (используется, если хеш-код не задан) */
+   ak_pointer data;
+  /*! \brief Длина хеш-кода или, если хеш-код не задан, длина сообщения (в октетах) */
+   size_t size;
+  /*! \brief Проверяемая электронная подпись */
+   ak_pointer sign;
+  /*! \brief Результат проверки подписи */
+   bool_t result;
+  /*! \brief Код ошибки, возникшей при выполнении задачи */
+   int error;
+ } *ak_verify_task;
+
+/*! \brief Пакетная проверка электронных подписей. */
+ dll_export int ak_verifykey_verify_batch( ak_verify_task , const size_t , const size_t );
 /** @} *//** @} */
 
 /* ----------------------------------------------------------------------------------------------- */